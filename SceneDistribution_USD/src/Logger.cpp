@@ -0,0 +1,199 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Wrttemberg, Animationsinstitut (http://research.animationsinstitut.de).
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace VPET
+{
+	static const char* const logLevelNames[LOG_OFF + 1] = { "DEBUG", "INFO", "WARN", "ERROR", "OFF" };
+
+	Logger& Logger::instance()
+	{
+		static Logger logger;
+		return logger;
+	}
+
+	Logger::Logger() :
+		m_writePos(0),
+		m_readPos(0),
+		m_level(LOG_INFO),
+		m_dropped(0),
+		m_running(true)
+	{
+		for (size_t i = 0; i < RING_SIZE; i++)
+			m_ring[i].sequence.store(i, std::memory_order_relaxed);
+
+		m_thread = std::thread(&Logger::drain, this);
+	}
+
+	Logger::~Logger()
+	{
+		m_running.store(false, std::memory_order_release);
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	void Logger::write(LogLevel level, const char* source, const std::string &message)
+	{
+		std::string line = std::string("[") + logLevelNames[level] + " " + source + "] " + message;
+
+		static const char truncatedMarker[] = " [truncated]";
+		const size_t maxLength = SLOT_TEXT_SIZE * MAX_SLOTS_PER_LINE;
+		if (line.size() > maxLength) {
+			line.resize(maxLength - (sizeof(truncatedMarker) - 1));
+			line += truncatedMarker;
+		}
+
+		while (!tryPush(level, line))
+		{
+			if (level < LOG_WARN) {
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			std::this_thread::yield();
+		}
+	}
+
+	bool Logger::tryPush(LogLevel level, const std::string &line)
+	{
+		const size_t count = std::max<size_t>((line.size() + SLOT_TEXT_SIZE - 1) / SLOT_TEXT_SIZE, 1);
+		size_t pos = m_writePos.load(std::memory_order_relaxed);
+
+		// claim consecutive slots, the sequence tells whether the consumer has released them.
+		// Other writers cannot take them before the write position moves and the consumer only
+		// releases slots, so they are still free when the exchange succeeds.
+		for (;;)
+		{
+			intptr_t diff = 0;
+			for (size_t i = 0; i < count && diff == 0; i++)
+			{
+				size_t sequence = m_ring[(pos + i) & RING_MASK].sequence.load(std::memory_order_acquire);
+				diff = (intptr_t)sequence - (intptr_t)(pos + i);
+			}
+
+			if (diff == 0) {
+				if (m_writePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false;
+			else
+				pos = m_writePos.load(std::memory_order_relaxed);
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			Slot* slot = &m_ring[(pos + i) & RING_MASK];
+			size_t offset = i * SLOT_TEXT_SIZE;
+			slot->level = level;
+			slot->length = std::min(line.size() - offset, SLOT_TEXT_SIZE);
+			slot->continued = i + 1 < count;
+			memcpy(slot->text, line.data() + offset, slot->length);
+			slot->sequence.store(pos + i + 1, std::memory_order_release);
+		}
+		return true;
+	}
+
+	void Logger::flush()
+	{
+		size_t target = m_writePos.load(std::memory_order_acquire);
+		while (m_readPos.load(std::memory_order_acquire) < target)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	void Logger::drain()
+	{
+		uint64_t reportedDrops = 0;
+		bool midLine = false;
+
+		for (;;)
+		{
+			size_t pos = m_readPos.load(std::memory_order_relaxed);
+			bool printed = false;
+
+			for (;;)
+			{
+				Slot &slot = m_ring[pos & RING_MASK];
+				if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+					break;
+
+				fwrite(slot.text, 1, slot.length, stdout);
+				midLine = slot.continued;
+				if (!midLine)
+					fputc('\n', stdout);
+				slot.sequence.store(pos + RING_SIZE, std::memory_order_release);
+				m_readPos.store(++pos, std::memory_order_release);
+				printed = true;
+			}
+
+			uint64_t drops = m_dropped.load(std::memory_order_relaxed);
+			if (drops != reportedDrops && !midLine) {
+				fprintf(stdout, "[WARN Logger] %llu log lines dropped\n", (unsigned long long)(drops - reportedDrops));
+				reportedDrops = drops;
+				printed = true;
+			}
+
+			// one flush per batch instead of one per line
+			if (printed)
+				fflush(stdout);
+			else if (!m_running.load(std::memory_order_acquire))
+				break;
+			else
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+
+	bool Logger::parseLevel(const std::string &name, LogLevel* level)
+	{
+		for (int i = 0; i <= LOG_OFF; i++)
+		{
+			std::string levelName = logLevelNames[i];
+			for (size_t j = 0; j < levelName.size(); j++)
+				levelName[j] = tolower(levelName[j]);
+
+			if (name == levelName) {
+				*level = (LogLevel)i;
+				return true;
+			}
+		}
+		return false;
+	}
+}
@@ -0,0 +1,147 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Wrttemberg, Animationsinstitut (http://research.animationsinstitut.de).
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef SCENEDISTRIBUTOR_LOGGER_H
+#define SCENEDISTRIBUTOR_LOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Calls below this level are compiled out (0 debug, 1 info, 2 warn, 3 error)
+#ifndef VPET_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define VPET_LOG_MIN_LEVEL 1
+#else
+#define VPET_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+namespace VPET
+{
+	enum LogLevel { LOG_DEBUG, LOG_INFO, LOG_WARN, LOG_ERROR, LOG_OFF };
+
+	//! Leveled logger with a bounded lock-free ring buffer.
+	//! Any thread may write, a background thread drains the ring to stdout.
+	//! Info and debug lines are dropped while the ring is full, warnings and
+	//! errors wait for a free slot. Lines longer than a slot are spread over
+	//! consecutive slots, up to MAX_SLOTS_PER_LINE, and cut with a marker beyond.
+	class Logger
+	{
+	public:
+		static Logger& instance();
+
+		void setLevel(LogLevel level) { m_level.store(level, std::memory_order_relaxed); }
+		LogLevel level() const { return m_level.load(std::memory_order_relaxed); }
+		bool enabled(LogLevel level) const { return level >= m_level.load(std::memory_order_relaxed); }
+
+		void write(LogLevel level, const char* source, const std::string &message);
+
+		//! Blocks until everything written so far has been printed
+		void flush();
+
+		uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+		//! Parses debug, info, warn, error or off
+		static bool parseLevel(const std::string &name, LogLevel* level);
+
+	private:
+		static const size_t RING_SIZE = 1024;
+		static const size_t RING_MASK = RING_SIZE - 1;
+		static const size_t SLOT_TEXT_SIZE = 240;
+		static const size_t MAX_SLOTS_PER_LINE = 64;
+
+		struct Slot
+		{
+			std::atomic<size_t> sequence;
+			LogLevel level;
+			size_t length;
+			//! the line continues in the next slot
+			bool continued;
+			char text[SLOT_TEXT_SIZE];
+		};
+
+		Logger();
+		~Logger();
+		Logger(const Logger&) = delete;
+		Logger& operator=(const Logger&) = delete;
+
+		bool tryPush(LogLevel level, const std::string &line);
+		void drain();
+
+		Slot m_ring[RING_SIZE];
+		std::atomic<size_t> m_writePos;
+		std::atomic<size_t> m_readPos;
+		std::atomic<LogLevel> m_level;
+		std::atomic<uint64_t> m_dropped;
+		std::atomic<bool> m_running;
+		std::thread m_thread;
+	};
+}
+
+#define VPET_LOG(level, source, expr) \
+	do { \
+		if (VPET::Logger::instance().enabled(level)) { \
+			std::ostringstream vpetLogStream; \
+			vpetLogStream << expr; \
+			VPET::Logger::instance().write(level, source, vpetLogStream.str()); \
+		} \
+	} while (0)
+
+#define VPET_LOG_NONE(source, expr) do {} while (0)
+
+#if VPET_LOG_MIN_LEVEL <= 0
+#define VPET_LOG_DEBUG(source, expr) VPET_LOG(VPET::LOG_DEBUG, source, expr)
+#else
+#define VPET_LOG_DEBUG(source, expr) VPET_LOG_NONE(source, expr)
+#endif
+
+#if VPET_LOG_MIN_LEVEL <= 1
+#define VPET_LOG_INFO(source, expr) VPET_LOG(VPET::LOG_INFO, source, expr)
+#else
+#define VPET_LOG_INFO(source, expr) VPET_LOG_NONE(source, expr)
+#endif
+
+#if VPET_LOG_MIN_LEVEL <= 2
+#define VPET_LOG_WARN(source, expr) VPET_LOG(VPET::LOG_WARN, source, expr)
+#else
+#define VPET_LOG_WARN(source, expr) VPET_LOG_NONE(source, expr)
+#endif
+
+#define VPET_LOG_ERROR(source, expr) VPET_LOG(VPET::LOG_ERROR, source, expr)
+
+#endif // SCENEDISTRIBUTOR_LOGGER_H
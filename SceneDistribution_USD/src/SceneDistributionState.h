@@ -36,13 +36,16 @@ will have to contact Filmakademie (research<at>filmakademie.de).
 #ifndef SCENEDISTRIBUTION_STATE_H
 #define SCENEDISTRIBUTION_STATE_H
 
+#include <atomic>
+#include <map>
+#include <string>
 #include <vector>
 
+#include "SceneDistributorStats.h"
+
 namespace VPET
 {
 	enum LodMode { ALL, TAG };
-	enum NodeType { GROUP, GEO, LIGHT, CAMERA };
-	enum LightType { SPOT, DIRECTIONAL, POINT, AREA, NONE };
 
 #pragma pack(4)
 	struct Node
@@ -81,6 +84,66 @@ namespace VPET
 		float cFar = 1000;
 	};
 
+	// Fixed bone slot count of the client skinned mesh node
+	static const int MAX_SKIN_BONES = 99;
+
+	struct NodeSkinnedGeo : NodeGeo
+	{
+		NodeSkinnedGeo()
+		{
+			for (int i = 0; i < MAX_SKIN_BONES; i++)
+				skinnedMeshBoneIds[i] = -1;
+		}
+
+		int bindPoseLength = 0;
+		int characterRootId = -1;
+		float boundExtents[3] = { 0, 0, 0 };
+		float boundCenter[3] = { 0, 0, 0 };
+		float bindPoses[MAX_SKIN_BONES * 16] = { 0 };
+		int skinnedMeshBoneIds[MAX_SKIN_BONES];
+	};
+
+	// Point instancer, the per instance data is sent with the "instances" request.
+	// Only the "instancednodes" request sends this type, prototype nodes keep their type there
+	// and are only drawn through the instances, the "instances" reply lists their node ids.
+	// "nodes" sends the instancer and all prototype nodes as groups, so older clients draw
+	// nothing of it, unless expandInstances appends a copy of the prototype per instance.
+	struct NodeInstancer : Node
+	{
+		int instancerId = -1;
+		int prototypeCount = 0;
+		int instanceCount = 0;
+	};
+
+	// Transform relative to the instancer, including the prototype root transform
+#pragma pack(4)
+	struct InstanceRecord
+	{
+		float position[3];
+		float rotation[4];
+		float scale[3];
+		int protoIndex;
+	};
+
+	struct InstancerPackage
+	{
+		std::string path;
+		std::vector<std::string> prototypePaths;
+		std::vector<int> prototypeNodeIds;
+		std::vector<InstanceRecord> instances;
+	};
+
+	// Prototype copy of one instance for clients without instancer support, see expandInstances,
+	// the copied nodes are [prototypeNodeId, prototypeNodeEnd), the root gets the world transform
+	struct ExpandedInstance
+	{
+		int prototypeNodeId;
+		int prototypeNodeEnd;
+		float position[3];
+		float rotation[4];
+		float scale[3];
+	};
+
 	struct ObjectPackage
 	{
 		ObjectPackage() :
@@ -97,6 +160,18 @@ namespace VPET
 		std::vector<int> boneIndices;
 	};
 
+	// Skeleton rest pose, bones are sent as nodes below the skeleton node
+	struct CharacterPackage
+	{
+		std::string skeletonPath;
+		int characterRootId = -1;
+		std::vector<int> boneMapping;
+		std::vector<int> skeletonMapping;
+		std::vector<float> bonePosition;
+		std::vector<float> boneRotation;
+		std::vector<float> boneScale;
+	};
+
 	struct TexturePackage
 	{
 		std::string path;
@@ -104,6 +179,20 @@ namespace VPET
 		unsigned char* colorMapData;
 	};
 
+	//! zeroMQ options of the distribution socket, set before it is bound
+	struct SocketSettings
+	{
+		//! messages queued per client, a client has at most one request in flight
+		int sendHighWaterMark = 16;
+		int receiveHighWaterMark = 16;
+		//! milliseconds unsent replies are kept when the socket is closed
+		int linger = 0;
+		//! seconds a connection is idle before keepalive probes detect a vanished client, 0 disables keepalive
+		int keepaliveIdle = 10;
+		int keepaliveInterval = 2;
+		int keepaliveCount = 3;
+	};
+
 #pragma pack(4)
 	struct VpetHeader
 	{
@@ -118,7 +207,10 @@ namespace VPET
 			numLights(0),
 			numCameras(0),
 			numObjectNodes(0),
-			textureBinaryType(0)
+			numInstances(0),
+			numObjectsReady(0),
+			textureBinaryType(0),
+			expandInstances(false)
 		{}
 
 		~SceneDistributorState()
@@ -140,8 +232,24 @@ namespace VPET
 		std::vector<NodeType> nodeTypeList;
 		std::vector<ObjectPackage> objPackList;
 		std::vector<TexturePackage> texPackList;
+		std::vector<InstancerPackage> instPackList;
+		std::vector<ExpandedInstance> expandedInstances;
+		std::vector<CharacterPackage> charPackList;
 		int textureBinaryType;
 
+		// Node index by prim path, used to resolve instancer prototypes
+		std::map<std::string, int> nodeIdByPath;
+
+		// Per node, set if the node is part of an instancer prototype
+		std::vector<bool> prototypeNodes;
+
+		// Append a prototype copy per instance to the "nodes" reply. Off by default, the copies
+		// grow with the instance count while "instancednodes" sends one record per instance.
+		bool expandInstances;
+
+		// Background geometry build, object packages are complete once all are ready
+		std::atomic<int> numObjectsReady;
+
 		// Currently processed node
 		Node* node;
 
@@ -149,6 +257,13 @@ namespace VPET
 		int numLights;
 		int numCameras;
 		int numObjectNodes;
+		int numInstances;
+
+		// Build and request instrumentation
+		DistributorStats stats;
+
+		// Distribution socket configuration
+		SocketSettings socketSettings;
 	};
 
 	// struct sizes 
@@ -156,6 +271,8 @@ namespace VPET
 	static const int sizeof_nodegeo = sizeof(NodeGeo);
 	static const int sizeof_nodelight = sizeof(NodeLight);
 	static const int sizeof_nodecam = sizeof(NodeCam);
+	static const int sizeof_nodeinstancer = sizeof(NodeInstancer);
+	static const int sizeof_nodeskinnedgeo = sizeof(NodeSkinnedGeo);
 }
 
 #endif // SCENEDISTRIBUTION_STATE_H
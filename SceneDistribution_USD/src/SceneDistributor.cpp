@@ -34,13 +34,20 @@ will have to contact Filmakademie (research<at>filmakademie.de).
 */
 
 #include "SceneDistributor.h"
+#include "Logger.h"
 
 #include "pxr/usd/usd/stage.h"
 #include "pxr/usd/usdGeom/mesh.h"
 #include "pxr/usd/usdGeom/camera.h"
+#include "pxr/usd/usdGeom/pointInstancer.h"
+#include "pxr/usd/usdSkel/binding.h"
+#include "pxr/usd/usdSkel/root.h"
+#include "pxr/usd/usdSkel/skeleton.h"
+#include "pxr/usd/usdSkel/topology.h"
 #include "pxr/usd/usdLux/light.h"
 #include "pxr/usd/usdShade/materialBindingAPI.h"
 #include "pxr/usd/ar/filesystemAsset.h"
+#include "pxr/base/gf/range3f.h"
 #include "pxr/base/gf/rotation.h"
 #include "pxr/usd/sdf/types.h"
 
@@ -52,8 +59,87 @@ namespace VPET
 {
 	std::atomic_bool m_stopThread(false);
 
-	SceneDistributor::SceneDistributor(const std::string &pathName)
+	// splits a transform into the node position, rotation and scale
+	static void setNodeTransform(Node *node, const GfMatrix4d &transformMat)
 	{
+		GfMatrix4d rotMat, shearMat, projectionMat;
+		rotMat.SetIdentity();
+		shearMat.SetIdentity();
+		projectionMat.SetIdentity();
+		GfVec3d scale, translation, rotationI;
+		scale.Set(1.0, 1.0, 1.0);
+		translation.Set(0.0, 0.0, 0.0);
+		double rotationW = 1.0;
+		rotationI.Set(0.0, 0.0, 0.0);
+
+		//transformMat = 
+		//	GfMatrix4d(	 *transformMat[0], -*transformMat[4], -*transformMat[8],  *transformMat[3],
+		//				-*transformMat[1],  *transformMat[5],  *transformMat[9],  *transformMat[7],
+		//				-*transformMat[2],  *transformMat[6],  *transformMat[10], *transformMat[11],
+		//				-*transformMat[12], *transformMat[13], *transformMat[14], *transformMat[15]);
+
+		transformMat.Factor(&rotMat, &scale, &shearMat, &translation, &projectionMat);
+
+		GfQuaternion rotQuat = rotMat.ExtractRotation().GetQuaternion();
+		//GfQuaternion zQuat = GfQuaternion(1.0, GfVec3f(0, 1, 0));
+		//rotQuat *= zQuat;
+		rotationW = rotQuat.GetReal();
+		rotationI = rotQuat.GetImaginary();
+
+		node->position[0] = translation[0];
+		node->position[1] = translation[1];
+		node->position[2] = translation[2];
+
+		node->rotation[0] = rotationI[0];
+		node->rotation[1] = rotationI[1];
+		node->rotation[2] = rotationI[2];
+		node->rotation[3] = rotationW;
+
+		node->scale[0] = scale[0];
+		node->scale[1] = scale[1];
+		node->scale[2] = scale[2];
+	}
+
+	// the transform sent for a prim, only the xformOp:transform attribute is read
+	static GfMatrix4d localTransform(const UsdPrim &prim)
+	{
+		GfMatrix4d transformMat(1.0);
+		UsdAttribute xFormAttr = prim.GetAttribute(TfToken("xformOp:transform"));
+		if (xFormAttr)
+			xFormAttr.Get(&transformMat);
+		return transformMat;
+	}
+
+	static GfMatrix4d worldTransform(UsdPrim prim)
+	{
+		GfMatrix4d transformMat(1.0);
+		for (; prim; prim = prim.GetParent())
+			transformMat *= localTransform(prim);
+		return transformMat;
+	}
+
+	static GfMatrix4d instanceTransform(const InstanceRecord &instance)
+	{
+		GfMatrix4d scaleMat, rotMat, translateMat;
+		scaleMat.SetScale(GfVec3d(instance.scale[0], instance.scale[1], instance.scale[2]));
+		rotMat.SetRotate(GfQuatd(instance.rotation[3], instance.rotation[0], instance.rotation[1], instance.rotation[2]));
+		translateMat.SetTranslate(GfVec3d(instance.position[0], instance.position[1], instance.position[2]));
+		return scaleMat * rotMat * translateMat;
+	}
+
+	// end of the depth first node range of the subtree starting at nodeId
+	static int subtreeEnd(const std::vector<Node*> &nodeList, int nodeId)
+	{
+		int pending = 1;
+		while (pending > 0 && nodeId < nodeList.size())
+			pending += nodeList[nodeId++]->childCount - 1;
+		return nodeId;
+	}
+
+	SceneDistributor::SceneDistributor(const std::string &pathName, const SocketSettings &socketSettings, bool expandInstances)
+	{
+		m_state.socketSettings = socketSettings;
+		m_state.expandInstances = expandInstances;
 		start(pathName);
 	}
 	
@@ -75,235 +161,583 @@ namespace VPET
 		m_state.lodMode = TAG;
 		m_state.lodTag = "lo";
 
-		std::cout << "[INFO SceneDistributor] LodMode: " << m_state.lodMode << "  LodTag: " << m_state.lodTag << std::endl;
-		std::cout << "[INFO SceneDistributor] Building scene..." << std::endl;
+		VPET_LOG_INFO("SceneDistributor", "LodMode: " << m_state.lodMode << "  LodTag: " << m_state.lodTag);
+		VPET_LOG_INFO("SceneDistributor", "Building scene...");
 
+		std::chrono::steady_clock::time_point phaseStart = std::chrono::steady_clock::now();
 		UsdStageRefPtr stage = UsdStage::Open(pathName);
+		m_state.stats.addPhase(PHASE_OPEN, microsSince(phaseStart));
 
 		if (!stage) {
-			std::cout << pathName << " is not a valid USD file.";
+			VPET_LOG_ERROR("SceneDistributor", pathName << " is not a valid USD file.");
 			return;
 		}
 
 		UsdPrim root = stage->GetPseudoRoot();
 
 		// traverse the scene graph
+		phaseStart = std::chrono::steady_clock::now();
 		buildLocation(&root);
+		m_state.stats.addPhase(PHASE_TRAVERSE, microsSince(phaseStart));
+
+		// link skinned meshes to their skeleton, the skeleton may follow the mesh
+		for (int i = 0; i < m_skinnedNodes.size(); i++)
+		{
+			NodeSkinnedGeo *node = m_skinnedNodes[i].first;
+			for (int j = 0; j < m_state.charPackList.size(); j++)
+			{
+				const CharacterPackage &charPack = m_state.charPackList[j];
+				if (charPack.skeletonPath != m_skinnedNodes[i].second)
+					continue;
+
+				node->characterRootId = charPack.characterRootId;
+				for (int k = 0; k < charPack.boneMapping.size() && k < MAX_SKIN_BONES; k++)
+					node->skinnedMeshBoneIds[k] = charPack.boneMapping[k];
+				break;
+			}
+		}
+
+		// link instancer prototypes to their nodes, prototypes may be anywhere in the hierarchy
+		for (int i = 0; i < m_state.instPackList.size(); i++)
+		{
+			InstancerPackage &instPack = m_state.instPackList[i];
+			for (int j = 0; j < instPack.prototypePaths.size(); j++)
+			{
+				std::map<std::string, int>::const_iterator it = m_state.nodeIdByPath.find(instPack.prototypePaths[j]);
+				if (it != m_state.nodeIdByPath.end())
+					instPack.prototypeNodeIds.push_back(it->second);
+				else {
+					VPET_LOG_WARN("SceneDistributor", "Prototype " << instPack.prototypePaths[j] << " of " << instPack.path << " not found");
+					instPack.prototypeNodeIds.push_back(-1);
+				}
+			}
+
+			// a prototype copy per instance for clients that only request "nodes", if enabled
+			if (!m_state.expandInstances)
+				continue;
+			GfMatrix4d instancerMat = worldTransform(stage->GetPrimAtPath(SdfPath(instPack.path)));
+			for (int j = 0; j < instPack.instances.size(); j++)
+			{
+				const InstanceRecord &instance = instPack.instances[j];
+				int prototypeNodeId = instPack.prototypeNodeIds[instance.protoIndex];
+				if (prototypeNodeId < 0)
+					continue;
+
+				Node copyRoot;
+				setNodeTransform(&copyRoot, instanceTransform(instance) * instancerMat);
+
+				ExpandedInstance expanded;
+				expanded.prototypeNodeId = prototypeNodeId;
+				expanded.prototypeNodeEnd = subtreeEnd(m_state.nodeList, prototypeNodeId);
+				memcpy(expanded.position, copyRoot.position, sizeof(expanded.position));
+				memcpy(expanded.rotation, copyRoot.rotation, sizeof(expanded.rotation));
+				memcpy(expanded.scale, copyRoot.scale, sizeof(expanded.scale));
+				m_state.expandedInstances.push_back(expanded);
+			}
+		}
+
+		// prototypes are only drawn through their instances, the instance records include their transform
+		m_state.prototypeNodes.assign(m_state.nodeList.size(), false);
+		for (int i = 0; i < m_state.instPackList.size(); i++)
+		{
+			const InstancerPackage &instPack = m_state.instPackList[i];
+			for (int j = 0; j < instPack.prototypeNodeIds.size(); j++)
+			{
+				if (instPack.prototypeNodeIds[j] < 0)
+					continue;
+				m_state.nodeList[instPack.prototypeNodeIds[j]]->editable = false;
+				int end = subtreeEnd(m_state.nodeList, instPack.prototypeNodeIds[j]);
+				for (int k = instPack.prototypeNodeIds[j]; k < end; k++)
+					m_state.prototypeNodes[k] = true;
+			}
+		}
+		if (m_state.numInstances > 0 && !m_state.expandInstances)
+			VPET_LOG_WARN("SceneDistributorPlugin.start", m_state.numInstances << " instances are only sent with \"instancednodes\", start with --expand-instances for clients that only request \"nodes\"");
 
 		// Print stats
-		std::cout << "[INFO SceneDistributorPlugin.start] Texture Count: " << m_state.texPackList.size() << std::endl;
-		std::cout << "[INFO SceneDistributorPlugin.start] Object(Mesh) Count: " << m_state.objPackList.size() << std::endl;
-		std::cout << "[INFO SceneDistributorPlugin.start] Node Count: " << m_state.nodeList.size() << std::endl;
-		std::cout << "[INFO SceneDistributorPlugin.start] Objects: " << m_state.numObjectNodes << std::endl;
-		std::cout << "[INFO SceneDistributorPlugin.start] Lights: " << m_state.numLights << std::endl;
-		std::cout << "[INFO SceneDistributorPlugin.start] Cameras: " << m_state.numCameras << std::endl;
+		VPET_LOG_INFO("SceneDistributorPlugin.start", "Texture Count: " << m_state.texPackList.size());
+		VPET_LOG_INFO("SceneDistributorPlugin.start", "Object(Mesh) Count: " << m_state.objPackList.size());
+		VPET_LOG_INFO("SceneDistributorPlugin.start", "Node Count: " << m_state.nodeList.size());
+		VPET_LOG_INFO("SceneDistributorPlugin.start", "Objects: " << m_state.numObjectNodes);
+		VPET_LOG_INFO("SceneDistributorPlugin.start", "Lights: " << m_state.numLights);
+		VPET_LOG_INFO("SceneDistributorPlugin.start", "Cameras: " << m_state.numCameras);
+		VPET_LOG_INFO("SceneDistributorPlugin.start", "Characters: " << m_state.charPackList.size() << " Skinned meshes: " << m_skinnedNodes.size());
+		VPET_LOG_INFO("SceneDistributorPlugin.start", "Instancers: " << m_state.instPackList.size() << " Instances: " << m_state.numInstances);
+		VPET_LOG_INFO("SceneDistributorPlugin.start", "Build stats: " << m_state.stats.toJson());
+
+		// geometry is built in the background, header and nodes are served right away
+		std::thread meshBuilder(&SceneDistributor::buildMeshes, this);
 
 		//initalize zeroMQ thread
-		std::cout << "Starting zeroMQ thread." << std::endl;
+		VPET_LOG_INFO("SceneDistributor", "Starting zeroMQ thread.");
 		std::thread t(server, &m_state);
 		
 		t.join();
+		meshBuilder.join();
 		
-		std::cout << "zeroMQ thread started." << std::endl;
+		VPET_LOG_INFO("SceneDistributor", "zeroMQ thread started.");
 	}
 
-	static void* server(void *scene)
+	// releases a response buffer once zeroMQ has sent it
+	static void freeResponse(void* data, void* hint)
 	{
-		SceneDistributorState* m_sharedState = static_cast<SceneDistributorState*>(scene);
+		free(data);
+	}
 
-		std::cout << "Thread started. " << std::endl;
+	// counts client connects and disconnects reported by the socket monitor
+	static void handleMonitorEvent(zmq::socket_t* monitor, DistributorStats* stats)
+	{
+		zmq::message_t eventMessage;
+		monitor->recv(&eventMessage);
+		uint16_t event = 0;
+		memcpy(&event, eventMessage.data(), sizeof(uint16_t));
+
+		// second frame holds the endpoint address
+		if (eventMessage.more()) {
+			zmq::message_t addressMessage;
+			monitor->recv(&addressMessage);
+		}
 
-		zmq::context_t* context = new zmq::context_t(1);
-		zmq::socket_t* socket = new zmq::socket_t(*context, ZMQ_REP);
-		socket->bind("tcp://*:5565");
-		std::cout << "zeroMQ running, now entering while." << std::endl;
+		if (event == ZMQ_EVENT_ACCEPTED)
+			stats->clientConnected();
+		else if (event == ZMQ_EVENT_DISCONNECTED)
+			stats->clientDisconnected();
+	}
 
-		while (!m_stopThread)
+	// high-water marks, linger and keepalive, options only take effect before bind
+	static void configureSocket(zmq::socket_t* socket, const SocketSettings &settings)
+	{
+		socket->setsockopt(ZMQ_SNDHWM, &settings.sendHighWaterMark, sizeof(int));
+		socket->setsockopt(ZMQ_RCVHWM, &settings.receiveHighWaterMark, sizeof(int));
+		socket->setsockopt(ZMQ_LINGER, &settings.linger, sizeof(int));
+
+		int keepalive = settings.keepaliveIdle > 0 ? 1 : 0;
+		socket->setsockopt(ZMQ_TCP_KEEPALIVE, &keepalive, sizeof(int));
+		if (keepalive)
 		{
-			zmq::message_t message;
-			char* responseMessageContent;
-			char* messageStart = NULL;
-			int responseLength = 0;
-			socket->recv(&message);
-
-			std::string msgString;
-			const char* msgPointer = static_cast<const char*>(message.data());
-			if (msgPointer == NULL)
+			socket->setsockopt(ZMQ_TCP_KEEPALIVE_IDLE, &settings.keepaliveIdle, sizeof(int));
+			socket->setsockopt(ZMQ_TCP_KEEPALIVE_INTVL, &settings.keepaliveInterval, sizeof(int));
+			socket->setsockopt(ZMQ_TCP_KEEPALIVE_CNT, &settings.keepaliveCount, sizeof(int));
+		}
+	}
+
+	// copies the values, empty arrays are skipped as they have no storage to copy from
+	template<typename T>
+	static void writeValues(char* &responseMessageContent, const std::vector<T> &values)
+	{
+		if (values.empty())
+			return;
+		memcpy(responseMessageContent, values.data(), sizeof(T) * values.size());
+		responseMessageContent += sizeof(T) * values.size();
+	}
+
+	// writes the element count followed by the values, an element has valuesPerElement values
+	template<typename T>
+	static void writeArray(char* &responseMessageContent, const std::vector<T> &values, int valuesPerElement)
+	{
+		int numValues = values.size() / valuesPerElement;
+		memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
+		responseMessageContent += sizeof(int);
+		writeValues(responseMessageContent, values);
+	}
+
+	// instancer nodes are sent as groups to clients that did not ask for them
+	static NodeType sentNodeType(NodeType nodeType, bool instancers)
+	{
+		return (nodeType == NodeType::INSTANCER && !instancers) ? NodeType::GROUP : nodeType;
+	}
+
+	// type of a node in the scene node list, prototypes are groups for clients without instancer
+	// support, a group draws nothing and keeps the node ids of the list valid
+	static NodeType sentNodeType(const SceneDistributorState* m_sharedState, int nodeId, bool instancers)
+	{
+		if (!instancers && m_sharedState->prototypeNodes[nodeId])
+			return NodeType::GROUP;
+		return sentNodeType(m_sharedState->nodeTypeList[nodeId], instancers);
+	}
+
+	static int nodeSize(NodeType nodeType)
+	{
+		if (nodeType == NodeType::GEO)
+			return sizeof_nodegeo;
+		else if (nodeType == NodeType::LIGHT)
+			return sizeof_nodelight;
+		else if (nodeType == NodeType::CAMERA)
+			return sizeof_nodecam;
+		else if (nodeType == NodeType::INSTANCER)
+			return sizeof_nodeinstancer;
+		else if (nodeType == NodeType::SKINNEDMESH)
+			return sizeof_nodeskinnedgeo;
+		else
+			return sizeof_node;
+	}
+
+	// writes the node type and the node data, returns the written node
+	static Node* writeNode(char* &responseMessageContent, const Node* node, NodeType nodeType)
+	{
+		int type = nodeType;
+		memcpy(responseMessageContent, (char*)&type, sizeof(int));
+		responseMessageContent += sizeof(int);
+
+		Node* written = (Node*)responseMessageContent;
+		memcpy(responseMessageContent, node, nodeSize(nodeType));
+		responseMessageContent += nodeSize(nodeType);
+		return written;
+	}
+
+	// serializes the reply to a request, unknown requests get an empty reply
+	static int buildResponse(SceneDistributorState* m_sharedState, RequestType requestType, char* &messageStart)
+	{
+		char* responseMessageContent;
+		int responseLength = 0;
+		messageStart = NULL;
+
+		if (requestType == REQUEST_HEADER)
+		{
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Got Header Request");
+			responseLength = sizeof(VpetHeader);
+			messageStart = responseMessageContent = (char*)malloc(responseLength);
+			memcpy(responseMessageContent, (char*)&(m_sharedState->vpetHeader), sizeof(VpetHeader));
+		}
+		else if (requestType == REQUEST_OBJECTS)
+		{
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Got Objects Request");
+
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Object count " << m_sharedState->objPackList.size());
+			responseLength = sizeof(int) * 5 * m_sharedState->objPackList.size();
+			for (int i = 0; i < m_sharedState->objPackList.size(); i++)
 			{
-				std::cout << "[INFO SceneDistributorPlugin.server] Error msgPointer is NULL" << std::endl;
+				responseLength += sizeof(float) * m_sharedState->objPackList[i].vertices.size();
+				responseLength += sizeof(int) * m_sharedState->objPackList[i].indices.size();
+				responseLength += sizeof(float) * m_sharedState->objPackList[i].normals.size();
+				responseLength += sizeof(float) * m_sharedState->objPackList[i].uvs.size();
+				responseLength += sizeof(float) * m_sharedState->objPackList[i].boneWeights.size();
+				responseLength += sizeof(int) * m_sharedState->objPackList[i].boneIndices.size();
 			}
-			else
+
+			messageStart = responseMessageContent = (char*)malloc(responseLength);
+
+			for (int i = 0; i < m_sharedState->objPackList.size(); i++)
 			{
-				msgString = std::string(static_cast<char*>(message.data()), message.size());
+				const ObjectPackage &objPack = m_sharedState->objPackList[i];
+
+				// vSize, vertices
+				writeArray(responseMessageContent, objPack.vertices, 3);
+				// iSize, indices
+				writeArray(responseMessageContent, objPack.indices, 1);
+				// nSize, normals
+				writeArray(responseMessageContent, objPack.normals, 3);
+				// uSize, uvs
+				writeArray(responseMessageContent, objPack.uvs, 2);
+				// bWSize, bone Weights
+				writeArray(responseMessageContent, objPack.boneWeights, 4);
+				// bone Indices, counted by bWSize
+				writeValues(responseMessageContent, objPack.boneIndices);
 			}
 
-			std::cout << "[INFO SceneDistributorPlugin.server] Got request string: " << msgString << std::endl;
+		}
+		else if (requestType == REQUEST_TEXTURES)
+		{
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Got Textures Request");
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Texture count " << m_sharedState->texPackList.size());
 
-			if (msgString == "header")
+			responseLength = sizeof(int) + sizeof(int)*m_sharedState->texPackList.size();
+			for (int i = 0; i < m_sharedState->texPackList.size(); i++)
 			{
-				std::cout << "[INFO SceneDistributorPlugin.server] Got Header Request" << std::endl;
-				responseLength = sizeof(VpetHeader);
-				messageStart = responseMessageContent = (char*)malloc(responseLength);
-				memcpy(responseMessageContent, (char*)&(m_sharedState->vpetHeader), sizeof(VpetHeader));
+				responseLength += m_sharedState->texPackList[i].colorMapDataSize;
 			}
-			else if (msgString == "objects")
+
+			messageStart = responseMessageContent = (char*)malloc(responseLength);
+
+			// texture binary type (image data (0) or raw unity texture data (1))
+			int textureBinaryType = m_sharedState->textureBinaryType;
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "textureBinaryType: " << textureBinaryType);
+			memcpy(responseMessageContent, (char*)&textureBinaryType, sizeof(int));
+			responseMessageContent += sizeof(int);
+
+			for (int i = 0; i < m_sharedState->texPackList.size(); i++)
 			{
-				std::cout << "[INFO SceneDistributorPlugin.server] Got Objects Request" << std::endl;
-				std::cout << "[INFO SceneDistributorPlugin.server] Object count " << m_sharedState->objPackList.size() << std::endl;
-				responseLength = sizeof(int) * 5 * m_sharedState->objPackList.size();
-				for (int i = 0; i < m_sharedState->objPackList.size(); i++)
-				{
-					responseLength += sizeof(float) * m_sharedState->objPackList[i].vertices.size();
-					responseLength += sizeof(int) * m_sharedState->objPackList[i].indices.size();
-					responseLength += sizeof(float) * m_sharedState->objPackList[i].normals.size();
-					responseLength += sizeof(float) * m_sharedState->objPackList[i].uvs.size();
-					responseLength += sizeof(float) * m_sharedState->objPackList[i].boneWeights.size();
-					responseLength += sizeof(int) * m_sharedState->objPackList[i].boneIndices.size();
-				}
+				memcpy(responseMessageContent, (char*)&m_sharedState->texPackList[i].colorMapDataSize, sizeof(int));
+				responseMessageContent += sizeof(int);
+				memcpy(responseMessageContent, m_sharedState->texPackList[i].colorMapData, m_sharedState->texPackList[i].colorMapDataSize);
+				responseMessageContent += m_sharedState->texPackList[i].colorMapDataSize;
+			}
+		}
+		else if (requestType == REQUEST_NODES || requestType == REQUEST_INSTANCED_NODES)
+		{
+			// clients without instancer support get the instances as prototype copies below the root
+			const bool instancers = requestType == REQUEST_INSTANCED_NODES;
+			static const std::vector<ExpandedInstance> noExpandedInstances;
+			const std::vector<ExpandedInstance> &expandedInstances = instancers ? noExpandedInstances : m_sharedState->expandedInstances;
+
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Got Nodes Request");
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Node count " << m_sharedState->nodeList.size() << " Node Type count " << m_sharedState->nodeList.size());
+
+			// set the size from type- and namelength
+			responseLength = 0;
+			for (int i = 0; i < m_sharedState->nodeList.size(); i++)
+				responseLength += sizeof(int) + nodeSize(sentNodeType(m_sharedState, i, instancers));
+			for (int i = 0; i < expandedInstances.size(); i++)
+			{
+				for (int j = expandedInstances[i].prototypeNodeId; j < expandedInstances[i].prototypeNodeEnd; j++)
+					responseLength += sizeof(int) + nodeSize(sentNodeType(m_sharedState->nodeTypeList[j], instancers));
+			}
 
-				messageStart = responseMessageContent = (char*)malloc(responseLength);
+			// allocate memory for out byte stream
+			messageStart = responseMessageContent = (char*)malloc(responseLength);
 
-				for (int i = 0; i < m_sharedState->objPackList.size(); i++)
+			// iterate over node list copy data to out byte stream
+			for (int i = 0; i < m_sharedState->nodeList.size(); i++)
+			{
+				Node* rootNode = writeNode(responseMessageContent, m_sharedState->nodeList[i], sentNodeType(m_sharedState, i, instancers));
+				if (i == 0)
+					rootNode->childCount += expandedInstances.size();
+			}
+
+			// the copies follow the last child of the root
+			for (int i = 0; i < expandedInstances.size(); i++)
+			{
+				const ExpandedInstance &expanded = expandedInstances[i];
+				for (int j = expanded.prototypeNodeId; j < expanded.prototypeNodeEnd; j++)
 				{
-					// vSize
-					int numValues = m_sharedState->objPackList[i].vertices.size() / 3.0;
-					memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
-					responseMessageContent += sizeof(int);
-					// vertices
-					memcpy(responseMessageContent, &m_sharedState->objPackList[i].vertices[0], sizeof(float) * m_sharedState->objPackList[i].vertices.size());
-					responseMessageContent += sizeof(float) * m_sharedState->objPackList[i].vertices.size();
-					// iSize
-					numValues = m_sharedState->objPackList[i].indices.size();
-					memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
-					responseMessageContent += sizeof(int);
-					// indices
-					memcpy(responseMessageContent, &m_sharedState->objPackList[i].indices[0], sizeof(int) * m_sharedState->objPackList[i].indices.size());
-					responseMessageContent += sizeof(int) * m_sharedState->objPackList[i].indices.size();
-					// nSize
-					numValues = m_sharedState->objPackList[i].normals.size() / 3.0;
-					memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
-					responseMessageContent += sizeof(int);
-					// normals
-					memcpy(responseMessageContent, &m_sharedState->objPackList[i].normals[0], sizeof(float) * m_sharedState->objPackList[i].normals.size());
-					responseMessageContent += sizeof(float) * m_sharedState->objPackList[i].normals.size();
-					// uSize
-					numValues = m_sharedState->objPackList[i].uvs.size() / 2.0;
-					memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
-					responseMessageContent += sizeof(int);
-					// uvs
-					memcpy(responseMessageContent, &m_sharedState->objPackList[i].uvs[0], sizeof(float) * m_sharedState->objPackList[i].uvs.size());
-					responseMessageContent += sizeof(float) * m_sharedState->objPackList[i].uvs.size();
-					// bWSize
-					numValues = m_sharedState->objPackList[i].boneWeights.size() / 4.0;
-					memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
-					responseMessageContent += sizeof(int);
-					// bone Weights
-					memcpy(responseMessageContent, &m_sharedState->objPackList[i].boneWeights[0], sizeof(float) * m_sharedState->objPackList[i].boneWeights.size());
-					responseMessageContent += sizeof(float) * m_sharedState->objPackList[i].boneWeights.size();
-					// bone Intices
-					memcpy(responseMessageContent, &m_sharedState->objPackList[i].boneIndices[0], sizeof(int) * m_sharedState->objPackList[i].boneIndices.size());
-					responseMessageContent += sizeof(int) * m_sharedState->objPackList[i].boneIndices.size();
+					Node* copy = writeNode(responseMessageContent, m_sharedState->nodeList[j], sentNodeType(m_sharedState->nodeTypeList[j], instancers));
+					if (j == expanded.prototypeNodeId) {
+						memcpy(copy->position, expanded.position, sizeof(copy->position));
+						memcpy(copy->rotation, expanded.rotation, sizeof(copy->rotation));
+						memcpy(copy->scale, expanded.scale, sizeof(copy->scale));
+					}
 				}
+			}
 
+		}
+		else if (requestType == REQUEST_CHARACTERS)
+		{
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Got Characters Request");
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Character count " << m_sharedState->charPackList.size());
+
+			responseLength = 3 * sizeof(int) * m_sharedState->charPackList.size();
+			for (int i = 0; i < m_sharedState->charPackList.size(); i++)
+			{
+				responseLength += sizeof(int) * m_sharedState->charPackList[i].boneMapping.size();
+				responseLength += sizeof(int) * m_sharedState->charPackList[i].skeletonMapping.size();
+				responseLength += sizeof(float) * m_sharedState->charPackList[i].bonePosition.size();
+				responseLength += sizeof(float) * m_sharedState->charPackList[i].boneRotation.size();
+				responseLength += sizeof(float) * m_sharedState->charPackList[i].boneScale.size();
 			}
-			else if (msgString == "textures")
+
+			messageStart = responseMessageContent = (char*)malloc(responseLength);
+
+			for (int i = 0; i < m_sharedState->charPackList.size(); i++)
 			{
-				std::cout << "[INFO SceneDistributorPlugin.server] Got Textures Request" << std::endl;
-				std::cout << "[INFO SceneDistributorPlugin.server] Texture count " << m_sharedState->texPackList.size() << std::endl;
+				const CharacterPackage &charPack = m_sharedState->charPackList[i];
 
-				responseLength = sizeof(int) + sizeof(int)*m_sharedState->texPackList.size();
-				for (int i = 0; i < m_sharedState->texPackList.size(); i++)
-				{
-					responseLength += m_sharedState->texPackList[i].colorMapDataSize;
-				}
+				// bMSize
+				int numValues = charPack.boneMapping.size();
+				memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
+				responseMessageContent += sizeof(int);
+				// sMSize
+				numValues = charPack.skeletonMapping.size();
+				memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
+				responseMessageContent += sizeof(int);
+				// characterRootID
+				memcpy(responseMessageContent, (char*)&charPack.characterRootId, sizeof(int));
+				responseMessageContent += sizeof(int);
+				// boneMapping
+				writeValues(responseMessageContent, charPack.boneMapping);
+				// skeletonMapping
+				writeValues(responseMessageContent, charPack.skeletonMapping);
+				// rest pose
+				writeValues(responseMessageContent, charPack.bonePosition);
+				writeValues(responseMessageContent, charPack.boneRotation);
+				writeValues(responseMessageContent, charPack.boneScale);
+			}
+		}
+		else if (requestType == REQUEST_INSTANCES)
+		{
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Got Instances Request");
+			VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Instancer count " << m_sharedState->instPackList.size());
 
-				messageStart = responseMessageContent = (char*)malloc(responseLength);
+			// per instancer: prototype count, prototype node ids, instance count, instance records
+			responseLength = 2 * sizeof(int) * m_sharedState->instPackList.size();
+			for (int i = 0; i < m_sharedState->instPackList.size(); i++)
+			{
+				responseLength += sizeof(int) * m_sharedState->instPackList[i].prototypeNodeIds.size();
+				responseLength += sizeof(InstanceRecord) * m_sharedState->instPackList[i].instances.size();
+			}
 
-				// texture binary type (image data (0) or raw unity texture data (1))
-				int textureBinaryType = m_sharedState->textureBinaryType;
-				std::cout << " textureBinaryType: " << textureBinaryType << std::endl;
-				memcpy(responseMessageContent, (char*)&textureBinaryType, sizeof(int));
+			messageStart = responseMessageContent = (char*)malloc(responseLength);
+
+			for (int i = 0; i < m_sharedState->instPackList.size(); i++)
+			{
+				const InstancerPackage &instPack = m_sharedState->instPackList[i];
+
+				int numValues = instPack.prototypeNodeIds.size();
+				memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
 				responseMessageContent += sizeof(int);
+				writeValues(responseMessageContent, instPack.prototypeNodeIds);
 
-				for (int i = 0; i < m_sharedState->texPackList.size(); i++)
-				{
-					memcpy(responseMessageContent, (char*)&m_sharedState->texPackList[i].colorMapDataSize, sizeof(int));
-					responseMessageContent += sizeof(int);
-					memcpy(responseMessageContent, m_sharedState->texPackList[i].colorMapData, m_sharedState->texPackList[i].colorMapDataSize);
-					responseMessageContent += m_sharedState->texPackList[i].colorMapDataSize;
-				}
+				numValues = instPack.instances.size();
+				memcpy(responseMessageContent, (char*)&numValues, sizeof(int));
+				responseMessageContent += sizeof(int);
+				writeValues(responseMessageContent, instPack.instances);
 			}
-			else if (msgString == "nodes")
+		}
+		else if (requestType == REQUEST_PROGRESS)
+		{
+			std::ostringstream progressJson;
+			progressJson << "{\"objects\":{\"ready\":" << m_sharedState->numObjectsReady.load() << ",\"total\":" << m_sharedState->objPackList.size() << "}}";
+			std::string progress = progressJson.str();
+			responseLength = progress.size();
+			messageStart = responseMessageContent = (char*)malloc(responseLength);
+			memcpy(responseMessageContent, progress.data(), responseLength);
+		}
+		else if (requestType == REQUEST_STATS)
+		{
+			std::string statsJson = m_sharedState->stats.toJson();
+			responseLength = statsJson.size();
+			messageStart = responseMessageContent = (char*)malloc(responseLength);
+			memcpy(responseMessageContent, statsJson.data(), responseLength);
+		}
+
+		return responseLength;
+	}
+
+	// geometry is complete once the background build has finished all object packages
+	static bool objectsReady(SceneDistributorState* m_sharedState)
+	{
+		return m_sharedState->numObjectsReady == m_sharedState->objPackList.size();
+	}
+
+	// replies to a request of the client with the given routing id
+	static void answerRequest(zmq::socket_t* socket, SceneDistributorState* m_sharedState, const std::string &identity, const std::string &msgString)
+	{
+		RequestType requestType = requestTypeFromString(msgString);
+		std::chrono::steady_clock::time_point requestStart = std::chrono::steady_clock::now();
+
+		char* messageStart;
+		int responseLength = buildResponse(m_sharedState, requestType, messageStart);
+
+		int64_t serializeTime = microsSince(requestStart);
+
+		VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Send message length: " << responseLength);
+		zmq::message_t identityMessage(identity.data(), identity.size());
+		zmq::message_t delimiterMessage;
+		zmq::message_t responseMessage((void*)messageStart, responseLength, freeResponse);
+		std::chrono::steady_clock::time_point sendStart = std::chrono::steady_clock::now();
+		// with ZMQ_ROUTER_MANDATORY a full client queue returns false and a vanished client throws
+		// EHOSTUNREACH, the reply is dropped in both cases and the router stays usable
+		try {
+			if (!socket->send(identityMessage, ZMQ_SNDMORE | ZMQ_DONTWAIT) ||
+				!socket->send(delimiterMessage, ZMQ_SNDMORE | ZMQ_DONTWAIT) ||
+				!socket->send(responseMessage, ZMQ_DONTWAIT))
 			{
+				VPET_LOG_WARN("SceneDistributorPlugin.server", "Reply not sent, the client queue is full");
+				m_sharedState->stats.repliesDropped.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		catch (const zmq::error_t &e) {
+			VPET_LOG_WARN("SceneDistributorPlugin.server", "Reply not sent: " << e.what());
+			m_sharedState->stats.repliesDropped.fetch_add(1, std::memory_order_relaxed);
+		}
 
-				std::cout << "[INFO SceneDistributorPlugin.server] Got Nodes Request" << std::endl;
-				std::cout << "[INFO SceneDistributorPlugin.server] Node count " << m_sharedState->nodeList.size() << " Node Type count " << m_sharedState->nodeList.size() << std::endl;
+		m_sharedState->stats.addRequest(requestType, responseLength, serializeTime, microsSince(sendStart));
+	}
 
-				// set the size from type- and namelength
-				responseLength = sizeof(NodeType) * m_sharedState->nodeList.size();
+	static void* server(void *scene)
+	{
+		SceneDistributorState* m_sharedState = static_cast<SceneDistributorState*>(scene);
 
-				// extend with sizeof node depending on node type
-				for (int i = 0; i < m_sharedState->nodeList.size(); i++)
-				{
+		VPET_LOG_INFO("SceneDistributorPlugin.server", "Thread started. ");
+
+		zmq::context_t* context = new zmq::context_t(1);
+		// a router socket answers requests in any order, so a pending objects request blocks no one
+		zmq::socket_t* socket = new zmq::socket_t(*context, ZMQ_ROUTER);
+		configureSocket(socket, m_sharedState->socketSettings);
+		// replies that cannot be routed fail the send instead of vanishing, so they are counted
+		int mandatory = 1;
+		socket->setsockopt(ZMQ_ROUTER_MANDATORY, &mandatory, sizeof(int));
+		socket->bind("tcp://*:5565");
+
+		// watch the distribution socket for the client count
+		zmq_socket_monitor(*socket, "inproc://distribution-monitor", ZMQ_EVENT_ACCEPTED | ZMQ_EVENT_DISCONNECTED);
+		zmq::socket_t* monitor = new zmq::socket_t(*context, ZMQ_PAIR);
+		monitor->connect("inproc://distribution-monitor");
+
+		zmq::pollitem_t items[] = {
+			{ *socket, 0, ZMQ_POLLIN, 0 },
+			{ *monitor, 0, ZMQ_POLLIN, 0 }
+		};
+		VPET_LOG_INFO("SceneDistributorPlugin.server", "zeroMQ running, now entering while.");
+
+		// objects requests wait here for the background geometry build, the others are answered meanwhile
+		std::vector<std::string> pendingObjectRequests;
 
-					if (m_sharedState->nodeTypeList[i] == NodeType::GEO)
-						responseLength += sizeof_nodegeo;
-					else if (m_sharedState->nodeTypeList[i] == NodeType::LIGHT)
-						responseLength += sizeof_nodelight;
-					else if (m_sharedState->nodeTypeList[i] == NodeType::CAMERA)
-						responseLength += sizeof_nodecam;
-					else
-						responseLength += sizeof_node;
+		while (!m_stopThread)
+		{
+			// a failing request must not end the thread, it is logged and the next one is served
+			try
+			{
+				zmq::poll(items, 2, pendingObjectRequests.empty() ? -1 : 20);
+
+				if (items[1].revents & ZMQ_POLLIN)
+					handleMonitorEvent(monitor, &m_sharedState->stats);
 
+				if (!pendingObjectRequests.empty() && objectsReady(m_sharedState))
+				{
+					for (int i = 0; i < pendingObjectRequests.size(); i++)
+						answerRequest(socket, m_sharedState, pendingObjectRequests[i], requestNames[REQUEST_OBJECTS]);
+					pendingObjectRequests.clear();
 				}
 
-				// allocate memory for out byte stream
-				messageStart = responseMessageContent = (char*)malloc(responseLength);
+				if (!(items[0].revents & ZMQ_POLLIN))
+					continue;
 
-				// iterate over node list copy data to out byte stream
-				for (int i = 0; i < m_sharedState->nodeList.size(); i++)
+				// routing id, the empty delimiter of REQ clients and the request
+				zmq::message_t identityMessage;
+				zmq::message_t message;
+				socket->recv(&identityMessage);
+				bool more = identityMessage.more();
+				while (more)
 				{
-					Node* node = m_sharedState->nodeList[i];
+					socket->recv(&message);
+					more = message.more();
+				}
+				std::string identity(static_cast<const char*>(identityMessage.data()), identityMessage.size());
 
-					// First Copy node type
-					int nodeType = m_sharedState->nodeTypeList[i];
-					memcpy(responseMessageContent, (char*)&nodeType, sizeof(int));
-					responseMessageContent += sizeof(int);
+				std::string msgString;
+				const char* msgPointer = static_cast<const char*>(message.data());
+				if (msgPointer == NULL)
+				{
+					VPET_LOG_ERROR("SceneDistributorPlugin.server", "Error msgPointer is NULL");
+				}
+				else
+				{
+					msgString = std::string(static_cast<char*>(message.data()), message.size());
+				}
 
-					// Copy specific node data
-					if (m_sharedState->nodeTypeList[i] == NodeType::GEO)
-					{
-						memcpy(responseMessageContent, node, sizeof_nodegeo);
-						responseMessageContent += sizeof_nodegeo;
-					}
-					else if (m_sharedState->nodeTypeList[i] == NodeType::LIGHT)
-					{
-						memcpy(responseMessageContent, node, sizeof_nodelight);
-						responseMessageContent += sizeof_nodelight;
-					}
-					else if (m_sharedState->nodeTypeList[i] == NodeType::CAMERA)
-					{
-						memcpy(responseMessageContent, node, sizeof_nodecam);
-						responseMessageContent += sizeof_nodecam;
-					}
-					else
-					{
-						memcpy(responseMessageContent, node, sizeof_node);
-						responseMessageContent += sizeof_node;
-					}
+				VPET_LOG_INFO("SceneDistributorPlugin.server", "Got request string: " << msgString);
 
+				if (requestTypeFromString(msgString) == REQUEST_OBJECTS && !objectsReady(m_sharedState))
+				{
+					VPET_LOG_DEBUG("SceneDistributorPlugin.server", "Objects request waits for " << m_sharedState->objPackList.size() - m_sharedState->numObjectsReady << " meshes");
+					pendingObjectRequests.push_back(identity);
+					continue;
 				}
 
+				answerRequest(socket, m_sharedState, identity, msgString);
+			}
+			catch (const zmq::error_t &e)
+			{
+				if (e.num() == ETERM)
+					break;
+				VPET_LOG_ERROR("SceneDistributorPlugin.server", "Request failed: " << e.what());
 			}
-
-			std::cout << "[INFO SceneDistributorPlugin.server] Send message length: " << responseLength << std::endl;
-			zmq::message_t responseMessage((void*)messageStart, responseLength, NULL);
-			socket->send(responseMessage);
 		}
 		
-		std::cout << "Zmq Thread ended, closing socket..." << std::endl;
+		VPET_LOG_INFO("SceneDistributorPlugin.server", "Zmq Thread ended, closing socket...");
+		delete monitor;
 		delete socket;
-		std::cout << "Deleting context..." << std::endl;
+		VPET_LOG_INFO("SceneDistributorPlugin.server", "Deleting context...");
 		delete context;
 
 		return 0;
@@ -312,32 +746,44 @@ namespace VPET
 	void SceneDistributor::buildLocation(UsdPrim *prim)
 	{
 		//UsdPrimRange range(root);
-		std::cout << "Build: " << prim->GetName() << std::endl;
+		VPET_LOG_DEBUG("SceneDistributor.buildLocation", "Build: " << prim->GetName());
 
 		// Get scenegraph location type
 		std::string typeName = prim->GetTypeName().GetString();
 
 		m_state.node = 0;
 
-		if (typeName == "Mesh") {
+		// bind the skinned meshes of a skel root before its children are visited
+		if (typeName == "SkelRoot")
+			bindSkelRoot(prim);
+
+		if (typeName == "Mesh" && m_skinBindings.count(prim->GetPath().GetString())) {
+			m_state.node = new NodeSkinnedGeo();
+			buildNode((NodeSkinnedGeo*)m_state.node, prim);
+		}
+		else if (typeName == "Mesh") {
 			m_state.node = new NodeGeo();
 			buildNode((NodeGeo*) m_state.node, prim);
-			std::cout << "Found geo node ";
+		}
+		else if (typeName == "Skeleton") {
+			m_state.node = new Node();
+			m_state.nodeTypeList.push_back(NodeType::CHARACTER);
 		}
 		else if (typeName == "Camera") {
 			m_state.node = new NodeCam();
 			buildNode((NodeCam*)m_state.node, prim);
-			std::cout << "Found camera node ";
 		}
 		else if (typeName.find("Light") != std::string::npos) {
 			m_state.node = new NodeLight();
 			buildNode((NodeLight*)m_state.node, prim);
-			std::cout << "Found light node ";
+		}
+		else if (typeName == "PointInstancer") {
+			m_state.node = new NodeInstancer();
+			buildNode((NodeInstancer*)m_state.node, prim);
 		}
 		else {
 			m_state.node = new Node();
 			m_state.nodeTypeList.push_back(NodeType::GROUP);
-			std::cout << "Found empty type, create group node ";
 		}
 
 		// node name
@@ -346,50 +792,9 @@ namespace VPET
 			name = "world";
 		name = name.substr(0, 63);
 		strcpy_s(m_state.node->name, name.c_str());
-		std::cout << name << std::endl;
-
-		GfMatrix4d rotMat, shearMat, projectionMat;
-		rotMat.SetIdentity();
-		shearMat.SetIdentity();
-		projectionMat.SetIdentity();
-		GfVec3d scale, translation, rotationI;
-		scale.Set(1.0, 1.0, 1.0);
-		translation.Set(0.0, 0.0, 0.0);
-		double rotationW = 1.0;
-		rotationI.Set(0.0, 0.0, 0.0);
+		VPET_LOG_DEBUG("SceneDistributor.buildLocation", "Found " << typeName << " node " << name);
 
-		UsdAttribute xFormAttr = prim->GetAttribute(TfToken("xformOp:transform"));
-		if (xFormAttr) {
-			GfMatrix4d transformMat;
-			xFormAttr.Get(&transformMat);
-
-			//transformMat = 
-			//	GfMatrix4d(	 *transformMat[0], -*transformMat[4], -*transformMat[8],  *transformMat[3],
-			//				-*transformMat[1],  *transformMat[5],  *transformMat[9],  *transformMat[7],
-			//				-*transformMat[2],  *transformMat[6],  *transformMat[10], *transformMat[11],
-			//				-*transformMat[12], *transformMat[13], *transformMat[14], *transformMat[15]);
-
-			transformMat.Factor(&rotMat, &scale, &shearMat, &translation, &projectionMat);
-		}
-
-		GfQuaternion rotQuat = rotMat.ExtractRotation().GetQuaternion();
-		//GfQuaternion zQuat = GfQuaternion(1.0, GfVec3f(0, 1, 0));
-		//rotQuat *= zQuat;
-		rotationW = rotQuat.GetReal();
-		rotationI = rotQuat.GetImaginary();
-
-		m_state.node->position[0] = translation[0];
-		m_state.node->position[1] = translation[1];
-		m_state.node->position[2] = translation[2];
-
-		m_state.node->rotation[0] = rotationI[0];
-		m_state.node->rotation[1] = rotationI[1];
-		m_state.node->rotation[2] = rotationI[2];
-		m_state.node->rotation[3] = rotationW;
-
-		m_state.node->scale[0] = scale[0];
-		m_state.node->scale[1] = scale[1];
-		m_state.node->scale[2] = scale[2];
+		setNodeTransform(m_state.node, localTransform(*prim));
 
 		m_state.node->childCount = 0;
 
@@ -425,8 +830,13 @@ namespace VPET
 			//}
 		}
 
-		std::cout << "[INFO SceneDistributor.SceneIterator] Add Node: " << m_state.node->name << std::endl;
+		VPET_LOG_DEBUG("SceneDistributor.SceneIterator", "Add Node: " << m_state.node->name);
+		m_state.nodeIdByPath[prim->GetPath().GetString()] = m_state.nodeList.size();
 		m_state.nodeList.push_back(m_state.node);
+
+		// joints are no prims, add them as child nodes of the skeleton
+		if (typeName == "Skeleton")
+			buildSkeleton(prim);
 		
 		// Recurse to children
 		for (UsdPrimSiblingIterator cIter = childs.begin(); cIter != childs.end(); cIter++)
@@ -445,7 +855,7 @@ namespace VPET
 		if (prim->IsInstance()) {
 			
 			instanceID = prim->GetPath().GetString();
-			std::cout << "[INFO SceneDistributor.GeometryScenegraphLocationDelegate] instanceID : " << instanceID << std::endl;
+			VPET_LOG_DEBUG("SceneDistributor.GeometryScenegraphLocationDelegate", "instanceID : " << instanceID);
 
 			int i = 0;
 			for (; i < m_state.objPackList.size(); ++i)
@@ -459,7 +869,7 @@ namespace VPET
 			if (i < m_state.objPackList.size())
 			{
 				node->geoId = i;
-				std::cout << "[INFO SceneDistributor.GeometryScenegraphLocationDelegate] Instantiate to: " << node->geoId << std::endl;
+				VPET_LOG_DEBUG("SceneDistributor.GeometryScenegraphLocationDelegate", "Instantiate to: " << node->geoId);
 			}
 		}
 		
@@ -467,254 +877,25 @@ namespace VPET
 		UsdGeomMesh mesh = UsdGeomMesh(*prim);
 
 		if (!mesh) {
-			std::cout << prim->GetName() << " is no point based primitive!" << std::endl;
+			VPET_LOG_WARN("SceneDistributor.GeometryScenegraphLocationDelegate", prim->GetName() << " is no point based primitive!");
 			return;
 		}
 
 		if (node->geoId < 0)
 		{
-			// Create Unity Package
+			// reserve the package, the geometry is built in the background while the scene is served
 			ObjectPackage objPack;
 			objPack.instanceId = instanceID;
-
-			// Faces
-			VtArray<int> faceVIndices, faceVCounts;
-			mesh.GetFaceVertexIndicesAttr().Get(&faceVIndices, 0);
-			mesh.GetFaceVertexCountsAttr().Get(&faceVCounts, 0);
-
-			// Vertices / Points
-			VtVec3fArray PData;
-			UsdAttribute pointsAttr = mesh.GetPointsAttr();
-			bool getPoints = pointsAttr.Get(&PData, 0);
-
-			// Normal
-			// 1st regular method
-			VtVec3fArray NData;
-			VtArray<int> NiData;
-			UsdAttribute normalsAttr = mesh.GetNormalsAttr();
-			bool gotNormals = normalsAttr.Get(&NData, 0);
-			bool gotNormalIndices = false;
-			// 2nd try alternative naming
-			if (!gotNormals) {
-				UsdGeomPrimvar normalPrimvar = mesh.GetPrimvar(UsdGeomTokens->normals);
-				gotNormals = normalPrimvar.Get(&NData, 0);
-				gotNormalIndices = normalPrimvar.GetIndices(&NiData, 0);
-			}
-
-			// todo if no normals found, search for prim var normals!
-
-			// ST or UV
-			VtVec2fArray STData;
-			VtArray<int> STindices;
-			UsdGeomPrimvar stPrimvar = mesh.GetPrimvar(TfToken("primvars:UVMap"));
-			if (!stPrimvar)
-				stPrimvar = mesh.GetPrimvar(TfToken("primvars:Texture_uv"));
-			bool gotSTs = stPrimvar.Get(&STData, 0);
-			bool gotSTIndices = false;
-			
-			if (!gotSTs) {
-				stPrimvar = mesh.GetPrimvar(TfToken("primvars:st"));
-				gotSTs = stPrimvar.Get(&STData, 0);
-			}
-			gotSTIndices = stPrimvar.GetIndices(&STindices, 0);  // .GetIndices because "primvars:st:indices" is not allowed
-
-			// std::cout << "Prepare Geo" << std::endl;
-
-			// Get indices, normals, uvs
-			// Iter over polygon indices, convert n-gons to triangles and store indices pointing to the vertex data
-			// rebuild normal- and uv-data arrays to get one normal/uv per vertex (using the same indices)
-			int startIdx = 0;
-			int endIdx = 0;
-			if (gotNormals) // assume defined edges including hard edge and therefor do not share vertices
-			{
-				for (int poly = 0; poly < faceVCounts.size(); poly++)
-				{
-					endIdx = startIdx + faceVCounts[poly]-1;
-
-					for (int i = startIdx + 1; i < endIdx; i++)
-					{
-						// point indices
-						int pIdx1, pIdx2, pIdx3;
-						pIdx1 = faceVIndices[startIdx];
-						pIdx2 = faceVIndices[i];
-						pIdx3 = faceVIndices[i+1];
-
-						// point 1
-						objPack.vertices.push_back(PData[pIdx1][0]);
-						objPack.vertices.push_back(PData[pIdx1][1]);
-						objPack.vertices.push_back(PData[pIdx1][2]);
-						// point 2
-						objPack.vertices.push_back(PData[pIdx2][0]);
-						objPack.vertices.push_back(PData[pIdx2][1]);
-						objPack.vertices.push_back(PData[pIdx2][2]);
-						// point 3
-						objPack.vertices.push_back(PData[pIdx3][0]);
-						objPack.vertices.push_back(PData[pIdx3][1]);
-						objPack.vertices.push_back(PData[pIdx3][2]);
-
-						// indices
-						objPack.indices.push_back(objPack.vertices.size() / 3 - 3);
-						objPack.indices.push_back(objPack.vertices.size() / 3 - 2);
-						objPack.indices.push_back(objPack.vertices.size() / 3 - 1);
-
-						// normal indices
-						int nIdx1, nIdx2, nIdx3;
-						if (gotNormalIndices) {
-							nIdx1 = NiData[startIdx];
-							nIdx2 = NiData[i];
-							nIdx3 = NiData[i+1];
-						}
-						else {
-							nIdx1 = startIdx;
-							nIdx2 = i;
-							nIdx3 = i+1;
-						}
-
-						// normals for every vertex
-						// n1
-						objPack.normals.push_back(NData[nIdx1][0]);
-						objPack.normals.push_back(NData[nIdx1][1]);
-						objPack.normals.push_back(NData[nIdx1][2]);
-						// n2
-						objPack.normals.push_back(NData[nIdx2][0]);
-						objPack.normals.push_back(NData[nIdx2][1]);
-						objPack.normals.push_back(NData[nIdx2][2]);
-						// n3
-						objPack.normals.push_back(NData[nIdx3][0]);
-						objPack.normals.push_back(NData[nIdx3][1]);
-						objPack.normals.push_back(NData[nIdx3][2]);
-						
-						if (gotSTs) // get uvs
-						{
-							// same for UVs but two values per index
-							// (use different index map (st.index))
-							int uvIdx0, uvIdx1, uvIdx2;
-							if (gotSTIndices) {
-								uvIdx0 = STindices[startIdx];
-								uvIdx1 = STindices[i];
-								uvIdx2 = STindices[i+1];
-							}
-							else {
-								uvIdx0 = startIdx;
-								uvIdx1 = i;
-								uvIdx2 = i+1;
-							}
-
-							// uv1
-							objPack.uvs.push_back(STData[uvIdx0][0]);
-							objPack.uvs.push_back(STData[uvIdx0][1]);
-
-							// uv2
-							objPack.uvs.push_back(STData[uvIdx1][0]);
-							objPack.uvs.push_back(STData[uvIdx1][1]);
-
-							// uv3
-							objPack.uvs.push_back(STData[uvIdx2][0]);
-							objPack.uvs.push_back(STData[uvIdx2][1]);
-						}
-					}
-					startIdx = endIdx + 1;
-				}
-
-			}
-			else // assume all edges soft and therefor share vertices
-			{
-
-				// Normal
-				VtArray<GfVec3f> normals(PData.size() , GfVec3f(0.0));
-
-				// Uv
-				VtArray<GfVec2f> uvs(PData.size() , GfVec2f(0.0));
-
-				// Get vertices
-				for (int i = 0; i < PData.size(); i++)
-				{
-					// TODO: hardcoded handiness
-					objPack.vertices.push_back(PData[i][0]);
-					objPack.vertices.push_back(PData[i][2]);
-					objPack.vertices.push_back(PData[i][1]);
-				}
-
-				for (int poly = 0; poly < faceVCounts.size(); poly++)
-				{
-					endIdx = startIdx + faceVCounts[poly] - 1;
-
-					for (int i = startIdx + 1; i < endIdx; i++)
-					{
-						// point indices
-						int pIdx1 = faceVIndices[startIdx];
-						int pIdx3 = faceVIndices[i];
-						int pIdx2 = faceVIndices[i+1];
-
-						// indices
-						objPack.indices.push_back(pIdx1);
-						objPack.indices.push_back(pIdx2);
-						objPack.indices.push_back(pIdx3);
-
-						// face normal
-						GfVec3f a = GfVec3f(PData[pIdx2][0], PData[pIdx2][1], PData[pIdx2][2]) - GfVec3f(PData[pIdx1][0], PData[pIdx1][1], PData[pIdx1][2]);
-						GfVec3f b = GfVec3f(PData[pIdx3][0], PData[pIdx3][1], PData[pIdx3][2]) - GfVec3f(PData[pIdx2][0], PData[pIdx2][1], PData[pIdx2][2]);
-						GfVec3f n = b ^ a;
-
-						normals[pIdx1] += n;
-						normals[pIdx2] += n;
-						normals[pIdx3] += n;
-
-						if (gotSTs) // get uvs
-						{
-							// same vor UVs but two values per index
-							// use different index map (st.index)
-							int uvIdx0, uvIdx1, uvIdx2;
-							if (gotSTIndices) {
-								uvIdx0 = STindices[pIdx1];
-								uvIdx1 = STindices[pIdx2];
-								uvIdx2 = STindices[pIdx3];
-							}
-							else { 
-								uvIdx0 = pIdx1;
-								uvIdx1 = pIdx2;
-								uvIdx2 = pIdx3;
-							}
-
-							uvs[uvIdx0] = GfVec2f(STData[uvIdx0][0], STData[uvIdx0][1]);
-							uvs[uvIdx1] = GfVec2f(STData[uvIdx1][0], STData[uvIdx1][1]);
-							uvs[uvIdx2] = GfVec2f(STData[uvIdx2][0], STData[uvIdx2][1]);
-						}
-					}
-					startIdx = endIdx + 1;
-				}
-
-				// fill normals float array
-				for (int i = 0; i < normals.size(); i++)
-				{
-					// TODO: hardcoded handiness
-					GfVec3f n = normals[i];
-					n.Normalize();
-					objPack.normals.push_back(n[0]);
-					objPack.normals.push_back(n[2]);
-					objPack.normals.push_back(n[1]);
-				}
-
-				// fill uvs float array
-				for (int i = 0; i < uvs.size(); i++)
-				{
-					objPack.uvs.push_back(uvs[i][0]);
-					objPack.uvs.push_back(uvs[i][1]);
-				}
-
-			}
-
-			std::cout << "Point Count:" << objPack.vertices.size() / 3.0 << " Normal Count: " << objPack.normals.size() / 3.0 << " Vertex Count: " << objPack.indices.size() << std::endl;
-
-			// store the object package
 			m_state.objPackList.push_back(objPack);
 
 			// get geo id
 			node->geoId = m_state.objPackList.size() - 1;
+			m_meshJobs.push_back(std::make_pair(node->geoId, *prim));
 
 		} // if ( nodeGeo->geoId < 0 )
 
 		// get material
+		ScopedPhaseTimer materialTimer(m_state.stats, PHASE_MATERIAL);
 		UsdShadeMaterialBindingAPI::DirectBinding materialBindung = UsdShadeMaterialBindingAPI(mesh).GetDirectBinding();
 		UsdShadeMaterial material = materialBindung.GetMaterial();
 
@@ -745,7 +926,7 @@ namespace VPET
 							if (filePath.substr(posDel + 1) != "jpg") 
 								filePath = filePath.substr(0, posDel + 1) + "jpg";
 
-							std::cout << "Map: " << filePath << std::endl;
+							VPET_LOG_DEBUG("SceneDistributor.GeometryScenegraphLocationDelegate", "Map: " << filePath);
 
 							VPET::TexturePackage texPack;
 							texPack.path = filePath;
@@ -759,10 +940,11 @@ namespace VPET
 								node->textureId = i;
 							else {
 								// try load the image
+								ScopedPhaseTimer textureTimer(m_state.stats, PHASE_TEXTURE);
 								if (!LoadMap(filePath, texPack.colorMapData, &texPack.colorMapDataSize))
-									std::cout << "Error reading map" << std::endl;
+									VPET_LOG_WARN("SceneDistributor.GeometryScenegraphLocationDelegate", "Error reading map");
 								else {
-									std::cout << "Done reading map" << std::endl;
+									VPET_LOG_DEBUG("SceneDistributor.GeometryScenegraphLocationDelegate", "Done reading map");
 									m_state.texPackList.push_back(texPack);
 									node->textureId = m_state.texPackList.size() - 1;
 								}
@@ -810,6 +992,279 @@ namespace VPET
 		m_state.numObjectNodes++;
 	}
 	
+	void SceneDistributor::buildMesh(const UsdPrim &prim, ObjectPackage &objPack)
+	{
+		UsdGeomMesh mesh = UsdGeomMesh(prim);
+
+		// Faces
+		VtArray<int> faceVIndices, faceVCounts;
+		mesh.GetFaceVertexIndicesAttr().Get(&faceVIndices, 0);
+		mesh.GetFaceVertexCountsAttr().Get(&faceVCounts, 0);
+
+		// Vertices / Points
+		VtVec3fArray PData;
+		UsdAttribute pointsAttr = mesh.GetPointsAttr();
+		bool getPoints = pointsAttr.Get(&PData, 0);
+
+		// Normal
+		// 1st regular method
+		VtVec3fArray NData;
+		VtArray<int> NiData;
+		UsdAttribute normalsAttr = mesh.GetNormalsAttr();
+		bool gotNormals = normalsAttr.Get(&NData, 0);
+		bool gotNormalIndices = false;
+		// 2nd try alternative naming
+		if (!gotNormals) {
+			UsdGeomPrimvar normalPrimvar = mesh.GetPrimvar(UsdGeomTokens->normals);
+			gotNormals = normalPrimvar.Get(&NData, 0);
+			gotNormalIndices = normalPrimvar.GetIndices(&NiData, 0);
+		}
+
+		// todo if no normals found, search for prim var normals!
+
+		// ST or UV
+		VtVec2fArray STData;
+		VtArray<int> STindices;
+		UsdGeomPrimvar stPrimvar = mesh.GetPrimvar(TfToken("primvars:UVMap"));
+		if (!stPrimvar)
+			stPrimvar = mesh.GetPrimvar(TfToken("primvars:Texture_uv"));
+		bool gotSTs = stPrimvar.Get(&STData, 0);
+		bool gotSTIndices = false;
+		
+		if (!gotSTs) {
+			stPrimvar = mesh.GetPrimvar(TfToken("primvars:st"));
+			gotSTs = stPrimvar.Get(&STData, 0);
+		}
+		gotSTIndices = stPrimvar.GetIndices(&STindices, 0);  // .GetIndices because "primvars:st:indices" is not allowed
+
+		// std::cout << "Prepare Geo" << std::endl;
+
+		// source point of every emitted vertex, empty if points are shared
+		std::vector<int> pointIndices;
+
+		// Get indices, normals, uvs
+		// Iter over polygon indices, convert n-gons to triangles and store indices pointing to the vertex data
+		// rebuild normal- and uv-data arrays to get one normal/uv per vertex (using the same indices)
+		int startIdx = 0;
+		int endIdx = 0;
+		if (gotNormals) // assume defined edges including hard edge and therefor do not share vertices
+		{
+			for (int poly = 0; poly < faceVCounts.size(); poly++)
+			{
+				endIdx = startIdx + faceVCounts[poly]-1;
+
+				for (int i = startIdx + 1; i < endIdx; i++)
+				{
+					// point indices
+					int pIdx1, pIdx2, pIdx3;
+					pIdx1 = faceVIndices[startIdx];
+					pIdx2 = faceVIndices[i];
+					pIdx3 = faceVIndices[i+1];
+
+					// point 1
+					objPack.vertices.push_back(PData[pIdx1][0]);
+					objPack.vertices.push_back(PData[pIdx1][1]);
+					objPack.vertices.push_back(PData[pIdx1][2]);
+					// point 2
+					objPack.vertices.push_back(PData[pIdx2][0]);
+					objPack.vertices.push_back(PData[pIdx2][1]);
+					objPack.vertices.push_back(PData[pIdx2][2]);
+					// point 3
+					objPack.vertices.push_back(PData[pIdx3][0]);
+					objPack.vertices.push_back(PData[pIdx3][1]);
+					objPack.vertices.push_back(PData[pIdx3][2]);
+
+					pointIndices.push_back(pIdx1);
+					pointIndices.push_back(pIdx2);
+					pointIndices.push_back(pIdx3);
+
+					// indices
+					objPack.indices.push_back(objPack.vertices.size() / 3 - 3);
+					objPack.indices.push_back(objPack.vertices.size() / 3 - 2);
+					objPack.indices.push_back(objPack.vertices.size() / 3 - 1);
+
+					// normal indices
+					int nIdx1, nIdx2, nIdx3;
+					if (gotNormalIndices) {
+						nIdx1 = NiData[startIdx];
+						nIdx2 = NiData[i];
+						nIdx3 = NiData[i+1];
+					}
+					else {
+						nIdx1 = startIdx;
+						nIdx2 = i;
+						nIdx3 = i+1;
+					}
+
+					// normals for every vertex
+					// n1
+					objPack.normals.push_back(NData[nIdx1][0]);
+					objPack.normals.push_back(NData[nIdx1][1]);
+					objPack.normals.push_back(NData[nIdx1][2]);
+					// n2
+					objPack.normals.push_back(NData[nIdx2][0]);
+					objPack.normals.push_back(NData[nIdx2][1]);
+					objPack.normals.push_back(NData[nIdx2][2]);
+					// n3
+					objPack.normals.push_back(NData[nIdx3][0]);
+					objPack.normals.push_back(NData[nIdx3][1]);
+					objPack.normals.push_back(NData[nIdx3][2]);
+					
+					if (gotSTs) // get uvs
+					{
+						// same for UVs but two values per index
+						// (use different index map (st.index))
+						int uvIdx0, uvIdx1, uvIdx2;
+						if (gotSTIndices) {
+							uvIdx0 = STindices[startIdx];
+							uvIdx1 = STindices[i];
+							uvIdx2 = STindices[i+1];
+						}
+						else {
+							uvIdx0 = startIdx;
+							uvIdx1 = i;
+							uvIdx2 = i+1;
+						}
+
+						// uv1
+						objPack.uvs.push_back(STData[uvIdx0][0]);
+						objPack.uvs.push_back(STData[uvIdx0][1]);
+
+						// uv2
+						objPack.uvs.push_back(STData[uvIdx1][0]);
+						objPack.uvs.push_back(STData[uvIdx1][1]);
+
+						// uv3
+						objPack.uvs.push_back(STData[uvIdx2][0]);
+						objPack.uvs.push_back(STData[uvIdx2][1]);
+					}
+				}
+				startIdx = endIdx + 1;
+			}
+
+		}
+		else // assume all edges soft and therefor share vertices
+		{
+
+			// Normal
+			VtArray<GfVec3f> normals(PData.size() , GfVec3f(0.0));
+
+			// Uv
+			VtArray<GfVec2f> uvs(PData.size() , GfVec2f(0.0));
+
+			// Get vertices
+			for (int i = 0; i < PData.size(); i++)
+			{
+				// TODO: hardcoded handiness
+				objPack.vertices.push_back(PData[i][0]);
+				objPack.vertices.push_back(PData[i][2]);
+				objPack.vertices.push_back(PData[i][1]);
+			}
+
+			for (int poly = 0; poly < faceVCounts.size(); poly++)
+			{
+				endIdx = startIdx + faceVCounts[poly] - 1;
+
+				for (int i = startIdx + 1; i < endIdx; i++)
+				{
+					// point indices
+					int pIdx1 = faceVIndices[startIdx];
+					int pIdx3 = faceVIndices[i];
+					int pIdx2 = faceVIndices[i+1];
+
+					// indices
+					objPack.indices.push_back(pIdx1);
+					objPack.indices.push_back(pIdx2);
+					objPack.indices.push_back(pIdx3);
+
+					// face normal
+					GfVec3f a = GfVec3f(PData[pIdx2][0], PData[pIdx2][1], PData[pIdx2][2]) - GfVec3f(PData[pIdx1][0], PData[pIdx1][1], PData[pIdx1][2]);
+					GfVec3f b = GfVec3f(PData[pIdx3][0], PData[pIdx3][1], PData[pIdx3][2]) - GfVec3f(PData[pIdx2][0], PData[pIdx2][1], PData[pIdx2][2]);
+					GfVec3f n = b ^ a;
+
+					normals[pIdx1] += n;
+					normals[pIdx2] += n;
+					normals[pIdx3] += n;
+
+					if (gotSTs) // get uvs
+					{
+						// same vor UVs but two values per index
+						// use different index map (st.index)
+						int uvIdx0, uvIdx1, uvIdx2;
+						if (gotSTIndices) {
+							uvIdx0 = STindices[pIdx1];
+							uvIdx1 = STindices[pIdx2];
+							uvIdx2 = STindices[pIdx3];
+						}
+						else { 
+							uvIdx0 = pIdx1;
+							uvIdx1 = pIdx2;
+							uvIdx2 = pIdx3;
+						}
+
+						uvs[uvIdx0] = GfVec2f(STData[uvIdx0][0], STData[uvIdx0][1]);
+						uvs[uvIdx1] = GfVec2f(STData[uvIdx1][0], STData[uvIdx1][1]);
+						uvs[uvIdx2] = GfVec2f(STData[uvIdx2][0], STData[uvIdx2][1]);
+					}
+				}
+				startIdx = endIdx + 1;
+			}
+
+			// fill normals float array
+			for (int i = 0; i < normals.size(); i++)
+			{
+				// TODO: hardcoded handiness
+				GfVec3f n = normals[i];
+				n.Normalize();
+				objPack.normals.push_back(n[0]);
+				objPack.normals.push_back(n[2]);
+				objPack.normals.push_back(n[1]);
+			}
+
+			// fill uvs float array
+			for (int i = 0; i < uvs.size(); i++)
+			{
+				objPack.uvs.push_back(uvs[i][0]);
+				objPack.uvs.push_back(uvs[i][1]);
+			}
+
+		}
+
+		// skinning influences of the emitted vertices
+		std::map<std::string, SkinBinding>::const_iterator skinIt = m_skinBindings.find(prim.GetPath().GetString());
+		if (skinIt != m_skinBindings.end())
+			buildSkinWeights(skinIt->second, pointIndices, objPack);
+
+		VPET_LOG_DEBUG("SceneDistributor.GeometryScenegraphLocationDelegate", "Point Count:" << objPack.vertices.size() / 3.0 << " Normal Count: " << objPack.normals.size() / 3.0 << " Vertex Count: " << objPack.indices.size());
+	}
+
+	void SceneDistributor::buildMeshes()
+	{
+		std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+		std::atomic<size_t> nextJob(0);
+		unsigned int numWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+		// stage reads are thread safe, every job writes its own package
+		std::vector<std::thread> workers;
+		for (unsigned int i = 0; i < numWorkers; i++)
+		{
+			workers.push_back(std::thread([this, &nextJob]() {
+				for (size_t job = nextJob++; job < m_meshJobs.size(); job = nextJob++)
+				{
+					buildMesh(m_meshJobs[job].second, m_state.objPackList[m_meshJobs[job].first]);
+					m_state.numObjectsReady++;
+				}
+			}));
+		}
+
+		for (int i = 0; i < workers.size(); i++)
+			workers[i].join();
+
+		// wall time, the workers overlap so their summed time would exceed the other phases
+		m_state.stats.addPhase(PHASE_MESH, microsSince(buildStart));
+		VPET_LOG_INFO("SceneDistributor", "Built " << m_meshJobs.size() << " meshes in " << microsSince(buildStart) / 1000 << " ms");
+	}
+
 	void SceneDistributor::buildNode(NodeCam *node, UsdPrim *prim)
 	{
 		m_state.node = node;
@@ -833,7 +1288,7 @@ namespace VPET
 		// Far
 		node->cFar = clippingRange[1];
 
-		std::cout << "[INFO SceneDistributor.CameraScenegraphLocationDelegate] Camera FOV: " << node->cFov << " Near: " << node->cNear << " Far: " << node->cFar << std::endl;
+		VPET_LOG_DEBUG("SceneDistributor.CameraScenegraphLocationDelegate", "Camera FOV: " << node->cFov << " Near: " << node->cNear << " Far: " << node->cFar);
 
 		// store at sharedState to access it in iterator
 		m_state.node = node;
@@ -880,15 +1335,315 @@ namespace VPET
 				delete node;
 				Node* node = new Node();
 				m_state.node = node;
-				std::cout << "[INFO SceneDistributor.LightScenegraphLocationDelegate] Found unknown Light (add as group)" << std::endl;
+				VPET_LOG_WARN("SceneDistributor.LightScenegraphLocationDelegate", "Found unknown Light (add as group)");
 				return;
 			}
 		}
-		std::cout << "[INFO SceneDistributor.LightScenegraphLocationDelegate] Light color: " << node->color[0] << " " << node->color[1] << " " << node->color[2] << " Type: " << typeName << " intensity: " << node->intensity << " exposure: " << node->exposure << " coneAngle: " << node->angle << std::endl;
+		VPET_LOG_DEBUG("SceneDistributor.LightScenegraphLocationDelegate", "Light color: " << node->color[0] << " " << node->color[1] << " " << node->color[2] << " Type: " << typeName << " intensity: " << node->intensity << " exposure: " << node->exposure << " coneAngle: " << node->angle);
 
 		// store at sharedState to access it in iterator
 		m_state.node = node;
 		m_state.numLights++;
 
 	}
+
+	void SceneDistributor::buildNode(NodeInstancer *node, UsdPrim *prim)
+	{
+		m_state.nodeTypeList.push_back(NodeType::INSTANCER);
+
+		UsdGeomPointInstancer instancer = UsdGeomPointInstancer(*prim);
+
+		InstancerPackage instPack;
+		instPack.path = prim->GetPath().GetString();
+
+		// prototypes are resolved to node ids once the whole stage is traversed
+		SdfPathVector prototypes;
+		instancer.GetPrototypesRel().GetTargets(&prototypes);
+		for (int i = 0; i < prototypes.size(); i++)
+			instPack.prototypePaths.push_back(prototypes[i].GetString());
+
+		// the prototype root transform is applied before the instance transform
+		std::vector<GfMatrix4d> prototypeTransforms;
+		for (int i = 0; i < prototypes.size(); i++)
+		{
+			UsdPrim prototype = prim->GetStage()->GetPrimAtPath(prototypes[i]);
+			prototypeTransforms.push_back(prototype ? localTransform(prototype) : GfMatrix4d(1.0));
+		}
+
+		VtArray<int> protoIndices;
+		VtVec3fArray positions, scales;
+		VtQuathArray orientations;
+		instancer.GetProtoIndicesAttr().Get(&protoIndices, 0);
+		instancer.GetPositionsAttr().Get(&positions, 0);
+		instancer.GetScalesAttr().Get(&scales, 0);
+		instancer.GetOrientationsAttr().Get(&orientations, 0);
+
+		// skip invisible and deactivated instances
+		std::vector<bool> mask = instancer.ComputeMaskAtTime(0);
+
+		int invalidIndices = 0;
+		instPack.instances.reserve(protoIndices.size());
+		for (int i = 0; i < protoIndices.size(); i++)
+		{
+			if (!mask.empty() && !mask[i])
+				continue;
+
+			if (protoIndices[i] < 0 || protoIndices[i] >= (int)prototypes.size()) {
+				invalidIndices++;
+				continue;
+			}
+
+			InstanceRecord instance = { { 0, 0, 0 }, { 0, 0, 0, 1 }, { 1, 1, 1 }, protoIndices[i] };
+
+			if (i < positions.size()) {
+				instance.position[0] = positions[i][0];
+				instance.position[1] = positions[i][1];
+				instance.position[2] = positions[i][2];
+			}
+			if (i < orientations.size()) {
+				GfVec3h imaginary = orientations[i].GetImaginary();
+				instance.rotation[0] = imaginary[0];
+				instance.rotation[1] = imaginary[1];
+				instance.rotation[2] = imaginary[2];
+				instance.rotation[3] = orientations[i].GetReal();
+			}
+			if (i < scales.size()) {
+				instance.scale[0] = scales[i][0];
+				instance.scale[1] = scales[i][1];
+				instance.scale[2] = scales[i][2];
+			}
+
+			Node instanceNode;
+			setNodeTransform(&instanceNode, prototypeTransforms[instance.protoIndex] * instanceTransform(instance));
+			memcpy(instance.position, instanceNode.position, sizeof(instance.position));
+			memcpy(instance.rotation, instanceNode.rotation, sizeof(instance.rotation));
+			memcpy(instance.scale, instanceNode.scale, sizeof(instance.scale));
+
+			instPack.instances.push_back(instance);
+		}
+
+		if (invalidIndices > 0)
+			VPET_LOG_WARN("SceneDistributor.InstancerScenegraphLocationDelegate", "Skipped " << invalidIndices << " instances of " << instPack.path << " with an invalid prototype index");
+
+		node->prototypeCount = instPack.prototypePaths.size();
+		node->instanceCount = instPack.instances.size();
+		node->instancerId = m_state.instPackList.size();
+		m_state.instPackList.push_back(instPack);
+
+		VPET_LOG_DEBUG("SceneDistributor.InstancerScenegraphLocationDelegate", "Prototypes: " << node->prototypeCount << " Instances: " << node->instanceCount);
+
+		// store at sharedState to access it in iterator
+		m_state.node = node;
+		m_state.numInstances += node->instanceCount;
+	}
+
+	void SceneDistributor::bindSkelRoot(UsdPrim *prim)
+	{
+		UsdSkelRoot skelRoot = UsdSkelRoot(*prim);
+		m_skelCache.Populate(skelRoot, UsdTraverseInstanceProxies());
+
+		std::vector<UsdSkelBinding> bindings;
+		m_skelCache.ComputeSkelBindings(skelRoot, &bindings, UsdTraverseInstanceProxies());
+
+		for (int i = 0; i < bindings.size(); i++)
+		{
+			UsdSkelSkeletonQuery skeletonQuery = m_skelCache.GetSkelQuery(bindings[i].GetSkeleton());
+			if (!skeletonQuery) {
+				VPET_LOG_WARN("SceneDistributor.SkelRootScenegraphLocationDelegate", "Invalid skeleton " << bindings[i].GetSkeleton().GetPath());
+				continue;
+			}
+
+			const VtArray<UsdSkelSkinningQuery> &targets = bindings[i].GetSkinningTargets();
+			for (int j = 0; j < targets.size(); j++)
+			{
+				if (!targets[j].HasJointInfluences())
+					continue;
+
+				SkinBinding skinBinding;
+				skinBinding.skinningQuery = targets[j];
+				skinBinding.skeletonQuery = skeletonQuery;
+				skinBinding.skeletonPath = bindings[i].GetSkeleton().GetPath().GetString();
+				m_skinBindings[targets[j].GetPrim().GetPath().GetString()] = skinBinding;
+			}
+		}
+	}
+
+	void SceneDistributor::buildSkeleton(UsdPrim *prim)
+	{
+		Node *skeletonNode = m_state.node;
+
+		UsdSkelSkeletonQuery skeletonQuery = m_skelCache.GetSkelQuery(UsdSkelSkeleton(*prim));
+		if (!skeletonQuery) {
+			VPET_LOG_WARN("SceneDistributor.SkeletonScenegraphLocationDelegate", prim->GetName() << " is not below a skel root or has an invalid topology");
+			return;
+		}
+
+		const UsdSkelTopology &topology = skeletonQuery.GetTopology();
+		VtTokenArray joints = skeletonQuery.GetJointOrder();
+		VtMatrix4dArray restTransforms;
+		skeletonQuery.ComputeJointLocalTransforms(&restTransforms, 0, true);
+
+		std::vector<std::vector<int> > jointChildren(topology.GetNumJoints());
+		std::vector<int> rootJoints;
+		for (int i = 0; i < topology.GetNumJoints(); i++)
+		{
+			int parent = topology.GetParent(i);
+			if (parent < 0)
+				rootJoints.push_back(i);
+			else
+				jointChildren[parent].push_back(i);
+		}
+
+		CharacterPackage charPack;
+		charPack.skeletonPath = prim->GetPath().GetString();
+		charPack.characterRootId = m_state.nodeList.size() - 1;
+		charPack.boneMapping.resize(topology.GetNumJoints(), -1);
+
+		// the rest pose starts with the skeleton node itself
+		charPack.skeletonMapping.push_back(charPack.characterRootId);
+		charPack.bonePosition.insert(charPack.bonePosition.end(), skeletonNode->position, skeletonNode->position + 3);
+		charPack.boneRotation.insert(charPack.boneRotation.end(), skeletonNode->rotation, skeletonNode->rotation + 4);
+		charPack.boneScale.insert(charPack.boneScale.end(), skeletonNode->scale, skeletonNode->scale + 3);
+
+		// add the joints depth first, in the same order as prim nodes
+		std::vector<int> jointStack(rootJoints.rbegin(), rootJoints.rend());
+		while (!jointStack.empty())
+		{
+			int joint = jointStack.back();
+			jointStack.pop_back();
+
+			Node *jointNode = new Node();
+			std::string name = SdfPath(joints[joint]).GetName().substr(0, 63);
+			strcpy_s(jointNode->name, name.c_str());
+			setNodeTransform(jointNode, joint < restTransforms.size() ? restTransforms[joint] : GfMatrix4d(1.0));
+			jointNode->childCount = jointChildren[joint].size();
+			jointNode->editable = true;
+
+			charPack.boneMapping[joint] = m_state.nodeList.size();
+			charPack.skeletonMapping.push_back(m_state.nodeList.size());
+			charPack.bonePosition.insert(charPack.bonePosition.end(), jointNode->position, jointNode->position + 3);
+			charPack.boneRotation.insert(charPack.boneRotation.end(), jointNode->rotation, jointNode->rotation + 4);
+			charPack.boneScale.insert(charPack.boneScale.end(), jointNode->scale, jointNode->scale + 3);
+
+			m_state.nodeTypeList.push_back(NodeType::GROUP);
+			m_state.nodeList.push_back(jointNode);
+
+			for (int i = jointChildren[joint].size() - 1; i >= 0; i--)
+				jointStack.push_back(jointChildren[joint][i]);
+		}
+
+		skeletonNode->childCount += rootJoints.size();
+		m_state.charPackList.push_back(charPack);
+
+		VPET_LOG_DEBUG("SceneDistributor.SkeletonScenegraphLocationDelegate", "Joints: " << topology.GetNumJoints());
+	}
+
+	void SceneDistributor::buildNode(NodeSkinnedGeo *node, UsdPrim *prim)
+	{
+		buildNode((NodeGeo*)node, prim);
+		m_state.nodeTypeList.back() = NodeType::SKINNEDMESH;
+
+		const SkinBinding &binding = m_skinBindings[prim->GetPath().GetString()];
+
+		// world space bind pose per joint, column vector layout as the clients expect
+		VtMatrix4dArray bindTransforms;
+		binding.skeletonQuery.GetJointWorldBindTransforms(&bindTransforms);
+		if (bindTransforms.size() > MAX_SKIN_BONES)
+			VPET_LOG_WARN("SceneDistributor.GeometryScenegraphLocationDelegate", prim->GetName() << " uses " << bindTransforms.size() << " joints, only " << MAX_SKIN_BONES << " are sent");
+
+		node->bindPoseLength = std::min((int)bindTransforms.size(), MAX_SKIN_BONES);
+		for (int i = 0; i < node->bindPoseLength; i++)
+			for (int row = 0; row < 4; row++)
+				for (int column = 0; column < 4; column++)
+					node->bindPoses[i * 16 + row * 4 + column] = bindTransforms[i][column][row];
+
+		// local bounds of the mesh points, the triangulated geometry is built later
+		VtVec3fArray points;
+		if (UsdGeomMesh(*prim).GetPointsAttr().Get(&points, 0))
+		{
+			GfRange3f bounds;
+			for (int i = 0; i < points.size(); i++)
+				bounds.UnionWith(points[i]);
+
+			if (!bounds.IsEmpty()) {
+				GfVec3f center = bounds.GetMidpoint();
+				GfVec3f extents = bounds.GetMax() - center;
+				for (int i = 0; i < 3; i++) {
+					node->boundCenter[i] = center[i];
+					node->boundExtents[i] = extents[i];
+				}
+			}
+		}
+
+		// character root and bone ids are set once all skeletons are built
+		m_skinnedNodes.push_back(std::make_pair(node, binding.skeletonPath));
+	}
+
+	void SceneDistributor::buildSkinWeights(const SkinBinding &binding, const std::vector<int> &pointIndices, ObjectPackage &objPack)
+	{
+		VtIntArray jointIndices;
+		VtFloatArray jointWeights;
+		if (!binding.skinningQuery.ComputeJointInfluences(&jointIndices, &jointWeights, 0)) {
+			VPET_LOG_WARN("SceneDistributor.GeometryScenegraphLocationDelegate", "No joint influences for " << binding.skinningQuery.GetPrim().GetPath());
+			return;
+		}
+
+		int numInfluences = binding.skinningQuery.GetNumInfluencesPerComponent();
+		bool isConstant = binding.skinningQuery.GetInterpolation() == UsdGeomTokens->constant;
+
+		// map a mesh specific joint order to the skeleton joint order
+		std::vector<int> jointRemap;
+		VtTokenArray meshJoints;
+		if (binding.skinningQuery.GetJointOrder(&meshJoints))
+		{
+			VtTokenArray skeletonJoints = binding.skeletonQuery.GetJointOrder();
+			jointRemap.resize(meshJoints.size(), -1);
+			for (int i = 0; i < meshJoints.size(); i++)
+				for (int j = 0; j < skeletonJoints.size(); j++)
+					if (meshJoints[i] == skeletonJoints[j]) {
+						jointRemap[i] = j;
+						break;
+					}
+		}
+
+		// keep the 4 strongest influences per vertex and normalize them
+		int numVertices = objPack.vertices.size() / 3;
+		int numKept = std::min(numInfluences, 4);
+		objPack.boneWeights.assign(numVertices * 4, 0.0f);
+		objPack.boneIndices.assign(numVertices * 4, 0);
+
+		std::vector<std::pair<float, int> > influences(numInfluences);
+		for (int v = 0; v < numVertices; v++)
+		{
+			int point = pointIndices.empty() ? v : pointIndices[v];
+			int offset = isConstant ? 0 : point * numInfluences;
+			if (offset + numInfluences > jointIndices.size())
+				continue;
+
+			for (int i = 0; i < numInfluences; i++)
+			{
+				int joint = jointIndices[offset + i];
+				if (!jointRemap.empty())
+					joint = joint < jointRemap.size() ? jointRemap[joint] : -1;
+
+				if (joint < 0)
+					influences[i] = std::make_pair(0.0f, 0);
+				else
+					influences[i] = std::make_pair(jointWeights[offset + i], joint);
+			}
+
+			std::partial_sort(influences.begin(), influences.begin() + numKept, influences.end(),
+				[](const std::pair<float, int> &a, const std::pair<float, int> &b) { return a.first > b.first; });
+
+			float weightSum = 0.0f;
+			for (int i = 0; i < numKept; i++)
+				weightSum += influences[i].first;
+
+			for (int i = 0; i < numKept; i++)
+			{
+				objPack.boneWeights[v * 4 + i] = weightSum > 0.0f ? influences[i].first / weightSum : (i == 0 ? 1.0f : 0.0f);
+				objPack.boneIndices[v * 4 + i] = influences[i].second;
+			}
+		}
+	}
 }
@@ -39,11 +39,15 @@ will have to contact Filmakademie (research<at>filmakademie.de).
 #include <zmq.hpp>
 #include "pxr/usd/usd/prim.h"
 #include "pxr/usd/usd/primRange.h"
+#include "pxr/usd/usdSkel/cache.h"
+#include "pxr/usd/usdSkel/skeletonQuery.h"
+#include "pxr/usd/usdSkel/skinningQuery.h"
 #include "SceneDistributionState.h"
 
 #include <math.h>
 #include <algorithm>
 #include <fstream>
+#include <map>
 
 #define PI 3.14159265
 
@@ -53,10 +57,18 @@ namespace VPET
 	// zeroMQ server
 	static void* server(void* scene);
 
+	// skinning of a mesh below a skel root
+	struct SkinBinding
+	{
+		UsdSkelSkinningQuery skinningQuery;
+		UsdSkelSkeletonQuery skeletonQuery;
+		std::string skeletonPath;
+	};
+
 	class SceneDistributor
 	{
 	public:
-		SceneDistributor(const std::string &pathName);
+		SceneDistributor(const std::string &pathName, const SocketSettings &socketSettings = SocketSettings(), bool expandInstances = false);
 		~SceneDistributor();
 
 	private:
@@ -65,9 +77,24 @@ namespace VPET
 		void buildNode(NodeGeo *node, UsdPrim *prim);
 		void buildNode(NodeCam *node, UsdPrim *prim);
 		void buildNode(NodeLight *node, UsdPrim *prim);
+		void buildNode(NodeInstancer *node, UsdPrim *prim);
+		void buildNode(NodeSkinnedGeo *node, UsdPrim *prim);
+		void buildSkeleton(UsdPrim *prim);
+		void bindSkelRoot(UsdPrim *prim);
+		void buildSkinWeights(const SkinBinding &binding, const std::vector<int> &pointIndices, ObjectPackage &objPack);
+		void buildMesh(const UsdPrim &prim, ObjectPackage &objPack);
+		void buildMeshes();
 		
 		SceneDistributorState m_state;
 
+		// UsdSkel queries, filled per skel root during traversal
+		UsdSkelCache m_skelCache;
+		std::map<std::string, SkinBinding> m_skinBindings;
+		std::vector<std::pair<NodeSkinnedGeo*, std::string> > m_skinnedNodes;
+
+		// deferred geometry, geo id and mesh prim
+		std::vector<std::pair<int, UsdPrim> > m_meshJobs;
+
 		//! float extension: lens focal length to vertical field of view
 		inline float lensToVFov(float lens, float sensorHeight = 24.0f, float focalMultiplier = 1.0f) const 
 		{
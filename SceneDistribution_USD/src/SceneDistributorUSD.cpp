@@ -34,8 +34,12 @@ will have to contact Filmakademie (research<at>filmakademie.de).
 */
 
 #include "SceneDistributor.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <string>
 
 
 bool file_exist(const char *fileName)
@@ -46,12 +50,61 @@ bool file_exist(const char *fileName)
 
 int main(int argc, char *argv[], char *envp[])
 {
-	if ((argc <= 1))
-		std::cout << "No valid filepath. Please entnter a path and a filename e.g. c:\\USD\\kitchen.usda" << std::endl;
-	else if (!file_exist(argv[1]))
-		std::cout << "File not found." << std::endl;
+	const char* filePath = NULL;
+
+	VPET::SocketSettings socketSettings;
+	bool expandInstances = false;
+
+	// usage: SceneDistributorUSD [--log-level debug|info|warn|error|off] [--send-hwm n] [--recv-hwm n]
+	//                            [--linger ms] [--keepalive-idle s (0 disables)] [--expand-instances] <file>
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool isOption = arg.size() > 1 && arg[0] == '-';
+		bool takesValue = arg == "--send-hwm" || arg == "--recv-hwm" || arg == "--linger" || arg == "--keepalive-idle" || arg == "--log-level";
+
+		if (takesValue && i + 1 >= argc) {
+			VPET_LOG_ERROR("SceneDistributorUSD", "Missing value for " << arg << ".");
+			VPET::Logger::instance().flush();
+			return 1;
+		}
+
+		if (arg == "--expand-instances")
+			expandInstances = true;
+		else if (arg == "--send-hwm")
+			socketSettings.sendHighWaterMark = std::max(atoi(argv[++i]), 1);
+		else if (arg == "--recv-hwm")
+			socketSettings.receiveHighWaterMark = std::max(atoi(argv[++i]), 1);
+		else if (arg == "--linger")
+			socketSettings.linger = std::max(atoi(argv[++i]), 0);
+		else if (arg == "--keepalive-idle")
+			socketSettings.keepaliveIdle = std::max(atoi(argv[++i]), 0);
+		else if (arg == "--log-level") {
+			VPET::LogLevel level;
+			if (VPET::Logger::parseLevel(argv[++i], &level))
+				VPET::Logger::instance().setLevel(level);
+			else {
+				VPET_LOG_ERROR("SceneDistributorUSD", "Unknown log level " << argv[i] << ", use debug, info, warn, error or off.");
+				VPET::Logger::instance().flush();
+				return 1;
+			}
+		}
+		else if (isOption || filePath) {
+			VPET_LOG_ERROR("SceneDistributorUSD", (isOption ? "Unknown option " : "Unexpected argument ") << arg << ".");
+			VPET::Logger::instance().flush();
+			return 1;
+		}
+		else
+			filePath = argv[i];
+	}
+
+	if (!filePath)
+		VPET_LOG_ERROR("SceneDistributorUSD", "No valid filepath. Please entnter a path and a filename e.g. c:\\USD\\kitchen.usda");
+	else if (!file_exist(filePath))
+		VPET_LOG_ERROR("SceneDistributorUSD", "File not found.");
 	else
-		VPET::SceneDistributor distributor((argv[1]));
+		VPET::SceneDistributor distributor(filePath, socketSettings, expandInstances);
 
+	VPET::Logger::instance().flush();
 }
 
@@ -32,9 +32,9 @@ void UpdateReceiverThread::DoWork()
 			return;
 		}
 
-		const char* msgPointer = static_cast<const char*>(message.data());
-		if (msgPointer == NULL) {
-			DOL(doLog, Error, "[RECV Thread] Error msgPointer is NULL");
+		VPET::Protocol::Header header;
+		if (!VPET::Protocol::decodeHeader(static_cast<const uint8_t*>(message.data()), message.size(), header)) {
+			DOL(doLog, Error, "[RECV Thread] Error message is empty or shorter than the header");
 		}
 		else
 		{
@@ -47,20 +47,20 @@ void UpdateReceiverThread::DoWork()
 			}
 
 			// Process message 
-			// Byte zero -> cID
 			// Ignore message from host
-			if (byteVector[0] != cID)
+			if (header.clientID != cID)
 			{
-				// Byte 1 -> time
-				// Byte 2 -> Parameter update
-				switch ((MessageType)byteVector[2])
+				switch (header.type)
 				{
 				case MessageType::LOCK:
 				{
 					//decodeLockMessage(ref input);
 					UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Lock message"));
-					int16_t objectID = *reinterpret_cast<int16_t*>(&byteVector[4]);
-					bool lockState = *reinterpret_cast<bool*>(&byteVector[6]);
+					VPET::Protocol::LockMessage lock;
+					if (!VPET::Protocol::decodeLock(byteVector.data(), byteVector.size(), lock))
+						break;
+					int16_t objectID = lock.objectID;
+					bool lockState = lock.locked;
 					manager->DecodeLockMessage(&objectID, &lockState);
 					break;
 				}
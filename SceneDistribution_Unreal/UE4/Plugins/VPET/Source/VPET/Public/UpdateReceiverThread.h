@@ -4,6 +4,7 @@
 
 #include <zmq.hpp>
 #include "Async/AsyncWork.h"
+#include "VPETProtocol.h"
 #include "VPETModule.h"
 
 // Development output log macro
@@ -24,12 +25,7 @@ public:
 	uint8_t cID;
 	AVPETModule* manager;
 
-	enum class MessageType
-	{
-		PARAMETERUPDATE, LOCK, // node
-		SYNC, PING, RESENDUPDATE, // sync
-		UNDOREDOADD, RESETOBJECT // undo redo
-	};
+	using MessageType = VPET::Protocol::MessageType;
 
 	UpdateReceiverThread(zmq::socket_t* pSocket, std::vector<std::vector<uint8_t>>* pQueue, uint8_t m_ID, bool pLog, AVPETModule* pMod) : socket(pSocket), msgQ(pQueue), cID(m_ID), doLog(pLog), manager(pMod) { }
 
@@ -4,6 +4,7 @@
 
 #include <zmq.hpp>
 #include "Async/AsyncWork.h"
+#include "VPETProtocol.h"
 
 // Development output log macro
 #define DOL(logType, logVerbosity, logString, ...) if(logType) UE_LOG(LogTemp, logVerbosity, TEXT(logString), __VA_ARGS__);
@@ -24,12 +25,7 @@ public:
 	bool doLog;
 	uint8_t cID;
 
-	enum class MessageType
-	{
-		PARAMETERUPDATE, LOCK, // node
-		SYNC, PING, RESENDUPDATE, // sync
-		UNDOREDOADD, RESETOBJECT // undo redo
-	};
+	using MessageType = VPET::Protocol::MessageType;
 
 	UpdateSenderThread(zmq::socket_t* pSocket, std::vector<std::vector<uint8_t>>* pQueue, uint8_t m_ID, bool pLog, std::vector<char*>* pData, std::vector<int>* pLen) : socket(pSocket), msgQ(pQueue), cID(m_ID), doLog(pLog), msgData(pData), msgLen(pLen) { }
 
@@ -31,6 +31,7 @@ Filmakademie (research<at>filmakademie.de).
 -----------------------------------------------------------------------------
 */
 
+using System.IO;
 using UnrealBuildTool;
 
 public class VPET : ModuleRules
@@ -38,6 +39,13 @@ public class VPET : ModuleRules
 	public VPET(ReadOnlyTargetRules Target) : base(Target)
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Shared VPET protocol headers, taken from the repository checkout or,
+		// for a plugin copied into a project, from ThirdParty/VPET_Protocol
+		string protocolInclude = Path.GetFullPath(Path.Combine(ModuleDirectory, "..", "..", "..", "..", "..", "..", "VPET_Protocol", "include"));
+		if (!Directory.Exists(protocolInclude))
+			protocolInclude = Path.Combine(PluginDirectory, "ThirdParty", "VPET_Protocol", "include");
+		PublicIncludePaths.Add(protocolInclude);
 			
 		
 	
@@ -0,0 +1,193 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#include "NetworkThread.h"
+
+NetworkThread::NetworkThread(zmq::context_t* pContext, UpdateSendQueue* pSendQueue, int pSendTimeout, bool pLog,
+	UpdateReceiverThread* pReceiver, UpdateSenderThread* pSender, ClockSyncThread* pPinger) :
+	context(pContext), sendQueue(pSendQueue), sendTimeout(pSendTimeout), doLog(pLog),
+	receiver(pReceiver), sender(pSender), pinger(pPinger),
+	wakeSender(*pContext, ZMQ_PAIR)
+{
+	// One endpoint per instance, the context is shared with other sockets of the module
+	wakeEndpoint = "inproc://vpet-network-wakeup-" + std::to_string(reinterpret_cast<uintptr_t>(this));
+	int linger = 0;
+	wakeSender.setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+	wakeSender.bind(wakeEndpoint);
+	sendQueue->SetOnPush([this]() { WakeUp(); });
+}
+
+NetworkThread::~NetworkThread()
+{
+	if (thread)
+	{
+		thread->Kill(true);
+		delete thread;
+	}
+	sendQueue->SetOnPush(nullptr);
+}
+
+bool NetworkThread::Start()
+{
+	thread = FRunnableThread::Create(this, TEXT("VPET Network"), 0, TPri_AboveNormal);
+	return thread != nullptr;
+}
+
+void NetworkThread::Stop()
+{
+	stopping = true;
+	WakeUp();
+}
+
+void NetworkThread::WakeUp()
+{
+	if (wakePending.exchange(true))
+		return;
+	std::lock_guard<std::mutex> lock(wakeMutex);
+	uint8_t signal = 0;
+	wakeSender.send(&signal, sizeof(signal), ZMQ_DONTWAIT);
+}
+
+// Network thread
+uint32 NetworkThread::Run()
+{
+	DOL(doLog, Warning, "[VPET2 NET Thread] zeroMQ network thread running");
+
+	try {
+		zmq::socket_t wakeReceiver(*context, ZMQ_PAIR);
+		int linger = 0;
+		wakeReceiver.setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+		wakeReceiver.connect(wakeEndpoint);
+
+		std::unique_ptr<zmq::socket_t> pingSocket;
+		if (pinger)
+		{
+			pingSocket.reset(new zmq::socket_t(*context, ZMQ_REQ));
+			pinger->OpenSocket(*pingSocket);
+		}
+		const double pingInterval = pinger ? pinger->GetIntervalMillis() / 1000.0 : 0.0;
+		double nextPing = FPlatformTime::Seconds();
+
+		enum { WAKE };
+		std::vector<zmq::pollitem_t> items = {
+			{ static_cast<void*>(wakeReceiver), 0, ZMQ_POLLIN, 0 }
+		};
+		const size_t receiverItem = items.size();
+		if (receiver)
+			items.push_back({ static_cast<void*>(*receiver->socket), 0, ZMQ_POLLIN, 0 });
+		const size_t pingItem = items.size();
+		if (pingSocket)
+			items.push_back({ static_cast<void*>(*pingSocket), 0, ZMQ_POLLIN, 0 });
+		zmq::message_t signal;
+
+		while (!stopping)
+		{
+			// A blocked publisher has no poll event, it is retried every millisecond
+			long timeout = blocked ? 1 : -1;
+			if (pingSocket)
+			{
+				const long untilPing = FMath::Max(0L, (long)((nextPing - FPlatformTime::Seconds()) * 1000.0) + 1);
+				timeout = timeout < 0 ? untilPing : FMath::Min(timeout, untilPing);
+			}
+			zmq::poll(items.data(), items.size(), timeout);
+
+			const uint64 busyStart = FPlatformTime::Cycles64();
+			wakeUps.fetch_add(1, std::memory_order_relaxed);
+
+			if (items[WAKE].revents & ZMQ_POLLIN)
+				while (wakeReceiver.recv(&signal, ZMQ_DONTWAIT)) { }
+			if (receiver && (items[receiverItem].revents & ZMQ_POLLIN) && !receiver->ReceivePending())
+				break;
+
+			if (pingSocket)
+			{
+				if (items[pingItem].revents & ZMQ_POLLIN)
+					pinger->HandleReply(*pingSocket);
+				const double now = FPlatformTime::Seconds();
+				if (now >= nextPing)
+				{
+					pinger->SendPing(*pingSocket);
+					nextPing = FMath::Max(nextPing + pingInterval, now);
+				}
+			}
+
+			// Cleared before taking, a push after the take sends the next wake up
+			wakePending = false;
+			if (!TakeOutbound() || !FlushOutbound())
+				break;
+
+			busyCycles.fetch_add(FPlatformTime::Cycles64() - busyStart, std::memory_order_relaxed);
+		}
+	}
+	catch (const zmq::error_t& e)
+	{
+		FString errName = FString(zmq_strerror(e.num()));
+		DOL(doLog, Error, "[VPET2 NET Thread] socket exception: %s", *errName);
+	}
+
+	// Unsent messages release their frames
+	outbound.clear();
+	for (UpdateSendQueue::Entry& entry : taken)
+		sendQueue->Discard(entry);
+	taken.clear();
+
+	DOL(doLog, Warning, "[VPET2 NET Thread] zeroMQ network thread stopped");
+	return 0;
+}
+
+bool NetworkThread::TakeOutbound()
+{
+	if (!sendQueue->TryTake(taken))
+		return false;
+	for (UpdateSendQueue::Entry& entry : taken)
+	{
+		outbound.emplace_back();
+		outbound.back().entry = entry;
+		sender->Prepare(entry, outbound.back().message);
+	}
+	taken.clear();
+	return true;
+}
+
+bool NetworkThread::FlushOutbound()
+{
+	while (!outbound.empty())
+	{
+		Outbound& next = outbound.front();
+		bool sent;
+		try {
+			sent = sender->socket->send(next.message, ZMQ_DONTWAIT);
+		}
+		catch (const zmq::error_t& e)
+		{
+			FString errName = FString(zmq_strerror(e.num()));
+			DOL(doLog, Error, "[VPET2 NET Thread] send exception: %s", *errName);
+			return false;
+		}
+
+		if (sent)
+		{
+			sendQueue->RecordSent(next.entry);
+			outbound.pop_front();
+			blocked = false;
+			continue;
+		}
+
+		// At the high-water mark, the message stays in front until it fits or times out
+		const double now = FPlatformTime::Seconds();
+		if (!blocked)
+		{
+			blocked = true;
+			blockedSince = now;
+			return true;
+		}
+		if ((now - blockedSince) * 1000.0 < sendTimeout)
+			return true;
+
+		DOL(doLog, Verbose, "[VPET2 NET Thread] Send timed out, message dropped");
+		sendQueue->RecordDropped(next.entry);
+		outbound.pop_front();
+		blockedSince = now;
+	}
+	blocked = false;
+	return true;
+}
@@ -2,7 +2,7 @@
 
 #include "Parameter.h"
 
-void NullParse(std::vector<uint8_t> kMsg, AActor* actor)
+void NullParse(ByteSpan kMsg, AActor* actor)
 {
 	UE_LOG(LogTemp, Error, TEXT("NO FUNC"));
 }
@@ -3,16 +3,16 @@
 #include "SceneObject.h"
 
 // Message parsing pre-declarations
-void UpdatePosition(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateRotation(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateScale(std::vector<uint8_t> kMsg, AActor* actor);
+void UpdatePosition(ByteSpan kMsg, AActor* actor);
+void UpdateRotation(ByteSpan kMsg, AActor* actor);
+void UpdateScale(ByteSpan kMsg, AActor* actor);
 
 
 // Sets default values for this component's properties
 USceneObject::USceneObject()
 {
-	// Set to be ticked every frame.
-	PrimaryComponentTick.bCanEverTick = true;
+	// Not ticked, the module checks the objects flagged by the change notifications
+	PrimaryComponentTick.bCanEverTick = false;
 }
 
 // Called when the game starts
@@ -46,21 +46,65 @@ void USceneObject::BeginPlay()
 		Scale_Vpet_Param = new Parameter(sca, thisActor, "scale", &UpdateScale, this);
 	}
 	
-	
+	if (USceneComponent* root = thisActor->GetRootComponent())
+		root->TransformUpdated.AddUObject(this, &USceneObject::HandleTransformUpdated);
+}
+
+void USceneObject::HandleTransformUpdated(USceneComponent* updatedComponent, EUpdateTransformFlags updateTransformFlags, ETeleportType teleport)
+{
+	// Compared by the module every tick in batched mode
+	if (!_batched)
+		MarkDirty(true, false);
 }
 
-// Using the update loop to check for local parameter changes
-void USceneObject::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void USceneObject::MarkDirty(bool transform, bool properties)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	const bool wasDirty = _transformDirty || _propertiesDirty;
+	_transformDirty |= transform;
+	_propertiesDirty |= properties;
+	if (!wasDirty && (_transformDirty || _propertiesDirty))
+		SceneObject_IsDirty.ExecuteIfBound(this);
+}
 
+bool USceneObject::CheckForChanges()
+{
 	if (_lock)
-		return;
+		return true;
 
+	if (_propertiesDirty)
+	{
+		_propertiesDirty = false;
+		CheckProperties();
+	}
+	// Remote edits blended by the module are compared once the blending is over
+	if (_transformDirty && !_smoothing)
+	{
+		_transformDirty = false;
+		CheckTransform();
+	}
+	return _transformDirty;
+}
+
+// Compares the transform against the cached parameter values
+void USceneObject::CheckTransform()
+{
 	FVector pos;
 	FQuat rot;
 	FVector sca;
+	ReadTransform(pos, rot, sca);
+
+	uint8 changed = 0;
+	if (pos != Position_Vpet_Param->getValue())
+		changed |= PositionChanged;
+	if (rot != Rotation_Vpet_Param->getValue())
+		changed |= RotationChanged;
+	if (sca != Scale_Vpet_Param->getValue())
+		changed |= ScaleChanged;
+	CommitTransform(changed, pos, rot, sca);
+}
 
+void USceneObject::ReadTransform(FVector& pos, FQuat& rot, FVector& sca) const
+{
 	if (thisActor->GetAttachParentActor() != nullptr)
 	{
 		// Get local position, rotation, and scale directly.
@@ -76,17 +120,25 @@ void USceneObject::TickComponent(float DeltaTime, ELevelTick TickType, FActorCom
 		rot = thisActor->GetActorRotation().Quaternion();
 		sca = thisActor->GetActorScale3D();
 	}
+}
 
+void USceneObject::GetTransformParameters(FVector& pos, FQuat& rot, FVector& sca) const
+{
+	pos = Position_Vpet_Param->getValue();
+	rot = Rotation_Vpet_Param->getValue();
+	sca = Scale_Vpet_Param->getValue();
+}
 
-	
-	if (pos != Position_Vpet_Param->getValue())
+void USceneObject::CommitTransform(uint8 changed, const FVector& pos, const FQuat& rot, const FVector& sca)
+{
+	if (changed & PositionChanged)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("LOC CHANGE - pos: %s, Position_Vpet_Param: %s"), *pos.ToString(), *Position_Vpet_Param->getValue().ToString());
 		ParameterObject_HasChanged.Broadcast(Position_Vpet_Param);
 		Position_Vpet_Param->setValue(pos);
 	}
 	
-	if (rot != Rotation_Vpet_Param->getValue())
+	if (changed & RotationChanged)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("ROT CHANGE - rot: %s, Rotation_Vpet_Param: %s"), *rot.ToString(), *Rotation_Vpet_Param->getValue().ToString());
 		ParameterObject_HasChanged.Broadcast(Rotation_Vpet_Param);
@@ -94,7 +146,7 @@ void USceneObject::TickComponent(float DeltaTime, ELevelTick TickType, FActorCom
 
 	}
 	
-	if (sca != Scale_Vpet_Param->getValue())
+	if (changed & ScaleChanged)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("SCA CHANGE - sca: %s, Scale_Vpet_Param: %s"), *sca.ToString(), *Scale_Vpet_Param->getValue().ToString());
 		ParameterObject_HasChanged.Broadcast(Scale_Vpet_Param);
@@ -104,30 +156,29 @@ void USceneObject::TickComponent(float DeltaTime, ELevelTick TickType, FActorCom
 	
 }
 
-// Parses a message for position change
-void UpdatePosition(std::vector<uint8_t> kMsg, AActor* actor)
+// Decodes a position message into the relative location of the actor
+bool DecodePosition(ByteSpan kMsg, FVector& position)
 {
-	float lX = *reinterpret_cast<float*>(&kMsg[0]);
-	float lY = *reinterpret_cast<float*>(&kMsg[4]);
-	float lZ = *reinterpret_cast<float*>(&kMsg[8]);
-	UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type POS: %f %f %f"), lX, lY, lZ);
-
-	// Transform actor pos
-	FVector aLoc(-lX, lZ, lY);
-
-	aLoc *= 100.0;
-
-	actor->SetActorRelativeLocation(aLoc);
+	if (!VpetWire::DecodePosition(kMsg, position))
+		return false;
+	UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type POS: %f %f %f"), position.X, position.Y, position.Z);
+	return true;
+}
 
+// Parses a message for position change
+void UpdatePosition(ByteSpan kMsg, AActor* actor)
+{
+	FVector aLoc;
+	if (DecodePosition(kMsg, aLoc))
+		actor->SetActorRelativeLocation(aLoc);
 }
 
-// Parses a message for rotation change
-void UpdateRotation(std::vector<uint8_t> kMsg, AActor* actor)
+// Decodes a rotation message into the relative rotation of the actor
+bool DecodeRotation(ByteSpan kMsg, AActor* actor, FQuat& rotation)
 {
-	float lX = *reinterpret_cast<float*>(&kMsg[0]);
-	float lY = *reinterpret_cast<float*>(&kMsg[4]);
-	float lZ = *reinterpret_cast<float*>(&kMsg[8]);
-	float lW = *reinterpret_cast<float*>(&kMsg[12]);
+	float lX, lY, lZ, lW;
+	if (!kMsg.Read(0, lX) || !kMsg.Read(4, lY) || !kMsg.Read(8, lZ) || !kMsg.Read(12, lW))
+		return false;
 	UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type ROT: %f %f %f %f"), lX, lY, lZ, lW);
 
 	// Transform actor rot
@@ -143,15 +194,24 @@ void UpdateRotation(std::vector<uint8_t> kMsg, AActor* actor)
 		aRot *= transRot;
 	}
 
-	actor->SetActorRelativeRotation(aRot);
+	rotation = aRot;
+	return true;
+}
+
+// Parses a message for rotation change
+void UpdateRotation(ByteSpan kMsg, AActor* actor)
+{
+	FQuat aRot;
+	if (DecodeRotation(kMsg, actor, aRot))
+		actor->SetActorRelativeRotation(aRot);
 }
 
 // Parses a message for scale change
-void UpdateScale(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateScale(ByteSpan kMsg, AActor* actor)
 {
-	float lX = *reinterpret_cast<float*>(&kMsg[0]);
-	float lY = *reinterpret_cast<float*>(&kMsg[4]);
-	float lZ = *reinterpret_cast<float*>(&kMsg[8]);
+	float lX, lY, lZ;
+	if (!kMsg.Read(0, lX) || !kMsg.Read(4, lY) || !kMsg.Read(8, lZ))
+		return;
 	UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type SCALE: %f %f %f"), lX, lY, lZ);
 
 	// transform actor sca
@@ -3,13 +3,13 @@
 #include "SceneObjectCamera.h"
 
 // Message parsing pre-declarations
-void UpdateFov(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateAspect(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateNearClipPlane(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateFarClipPlane(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateFocalDistance(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateAperture(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateSensorSize(std::vector<uint8_t> kMsg, AActor* actor);
+void UpdateFov(ByteSpan kMsg, AActor* actor);
+void UpdateAspect(ByteSpan kMsg, AActor* actor);
+void UpdateNearClipPlane(ByteSpan kMsg, AActor* actor);
+void UpdateFarClipPlane(ByteSpan kMsg, AActor* actor);
+void UpdateFocalDistance(ByteSpan kMsg, AActor* actor);
+void UpdateAperture(ByteSpan kMsg, AActor* actor);
+void UpdateSensorSize(ByteSpan kMsg, AActor* actor);
 
 // Called when the game starts
 void USceneObjectCamera::BeginPlay()
@@ -53,14 +53,11 @@ void USceneObjectCamera::BeginPlay()
 	}
 }
 
-// Using the update loop to check for local parameter changes
-void USceneObjectCamera::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+// Checks the camera parameters for local changes
+void USceneObjectCamera::CheckProperties()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	Super::CheckProperties();
 
-	if (_lock)
-		return;
-	
 	if (kCamComp)
 	{
 		float aspect = kCamComp->AspectRatio; // default: 2
@@ -125,13 +122,15 @@ void USceneObjectCamera::TickComponent(float DeltaTime, ELevelTick TickType, FAc
 }
 
 // Parses a message for fov change
-void UpdateFov(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateFov(ByteSpan kMsg, AActor* actor)
 {
 	ACameraActor* kCam = Cast<ACameraActor>(actor);
 	ACineCameraActor* kCineCam = Cast<ACineCameraActor>(actor);
 	if (kCam)
 	{
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 		UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type FOV: %f"), lK);
 
 		float aspect = kCam->GetCameraComponent()->AspectRatio;
@@ -146,12 +145,14 @@ void UpdateFov(std::vector<uint8_t> kMsg, AActor* actor)
 }
 
 // Parses a message for aspect ratio change - does not work properly with CineCameras
-void UpdateAspect(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateAspect(ByteSpan kMsg, AActor* actor)
 {
 	ACameraActor* kCam = Cast<ACameraActor>(actor);
 	if (kCam)
 	{
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 		UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type ASPECT RATIO: %f"), lK);
 
 		kCam->GetCameraComponent()->AspectRatio = lK;
@@ -159,35 +160,41 @@ void UpdateAspect(std::vector<uint8_t> kMsg, AActor* actor)
 }
 
 // Parses a message for near clip change
-void UpdateNearClipPlane(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateNearClipPlane(ByteSpan kMsg, AActor* actor)
 {
 	ACameraActor* kCam = Cast<ACameraActor>(actor);
 	if (kCam)
 	{
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 		UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type NEAR CLIP PLANE: %f (not used)"), lK);
 	}
 }
 
 // Parses a message for far clip change
-void UpdateFarClipPlane(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateFarClipPlane(ByteSpan kMsg, AActor* actor)
 {
 	ACameraActor* kCam = Cast<ACameraActor>(actor);
 	if (kCam)
 	{
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 		UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type FAR CLIP PLANE: %f (not used)"), lK);
 	}
 }
 
 // Parses a message for focal distance change
-void UpdateFocalDistance(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateFocalDistance(ByteSpan kMsg, AActor* actor)
 {
 	ACameraActor* kCam = Cast<ACameraActor>(actor);
 	ACineCameraActor* kCineCam = Cast<ACineCameraActor>(actor);
 	if (kCam)
 	{
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 
 		if (kCineCam == NULL)
 		{
@@ -203,13 +210,15 @@ void UpdateFocalDistance(std::vector<uint8_t> kMsg, AActor* actor)
 }
 
 // Parses a message for aperture change
-void UpdateAperture(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateAperture(ByteSpan kMsg, AActor* actor)
 {
 	ACameraActor* kCam = Cast<ACameraActor>(actor);
 	ACineCameraActor* kCineCam = Cast<ACineCameraActor>(actor);
 	if (kCam)
 	{
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 
 		if (kCineCam == NULL)
 		{
@@ -225,14 +234,15 @@ void UpdateAperture(std::vector<uint8_t> kMsg, AActor* actor)
 }
 
 // Parses a message for sensor size change
-void UpdateSensorSize(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateSensorSize(ByteSpan kMsg, AActor* actor)
 {
 	ACameraActor* kCam = Cast<ACameraActor>(actor);
 	ACineCameraActor* kCineCam = Cast<ACineCameraActor>(actor);
 	if (kCam)
 	{
-		float lX = *reinterpret_cast<float*>(&kMsg[0]);
-		float lY = *reinterpret_cast<float*>(&kMsg[4]);
+		float lX, lY;
+		if (!kMsg.Read(0, lX) || !kMsg.Read(4, lY))
+			return;
 
 		if (kCineCam == NULL)
 		{
@@ -3,8 +3,8 @@
 #include "SceneObjectLight.h"
 
 // Message parsing pre-declarations
-void UpdateColor(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateIntensity(std::vector<uint8_t> kMsg, AActor* actor);
+void UpdateColor(ByteSpan kMsg, AActor* actor);
+void UpdateIntensity(ByteSpan kMsg, AActor* actor);
 
 // Called when the game starts
 void USceneObjectLight::BeginPlay()
@@ -22,30 +22,52 @@ void USceneObjectLight::BeginPlay()
 	}
 }
 
-// Using the update loop to check for local parameter changes
-void USceneObjectLight::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+// Checks the light parameters for local changes
+void USceneObjectLight::CheckProperties()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-	if (_lock)
-		return;
-	
-	if (kLit)
+	Super::CheckProperties();
+
+	// Color and intensity are compared by the module in batched mode
+	if (kLit && !_batched)
 	{
-		FVector col = kLit->GetLightColor();
-		float lit = kLit->GetBrightness() * lightFactor;
+		FVector4d col;
+		float lit;
+		ReadLight(col, lit);
 
+		uint8 changed = 0;
 		if (col != Col_Vpet_Param->getValue())
-		{
-			UE_LOG(LogTemp, Warning, TEXT("COL CHANGE"));
-			ParameterObject_HasChanged.Broadcast(Col_Vpet_Param);
-			Col_Vpet_Param->setValue(col);
-		}
+			changed |= ColorChanged;
 		if (lit != lit_Vpet_Param->getValue())
-		{
-			UE_LOG(LogTemp, Warning, TEXT("LIT CHANGE"));
-			ParameterObject_HasChanged.Broadcast(lit_Vpet_Param);
-			lit_Vpet_Param->setValue(lit);
-		}
+			changed |= IntensityChanged;
+		CommitLight(changed, col, lit);
+	}
+}
+
+void USceneObjectLight::ReadLight(FVector4d& col, float& lit) const
+{
+	col = (FVector4d)kLit->GetLightColor();
+	lit = kLit->GetBrightness() * lightFactor;
+}
+
+void USceneObjectLight::GetLightParameters(FVector4d& col, float& lit) const
+{
+	col = Col_Vpet_Param->getValue();
+	lit = lit_Vpet_Param->getValue();
+}
+
+void USceneObjectLight::CommitLight(uint8 changed, const FVector4d& col, float lit)
+{
+	if (changed & ColorChanged)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("COL CHANGE"));
+		ParameterObject_HasChanged.Broadcast(Col_Vpet_Param);
+		Col_Vpet_Param->setValue(col);
+	}
+	if (changed & IntensityChanged)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("LIT CHANGE"));
+		ParameterObject_HasChanged.Broadcast(lit_Vpet_Param);
+		lit_Vpet_Param->setValue(lit);
 	}
 }
 
@@ -68,15 +90,15 @@ void USceneObjectLight::TickComponent(float DeltaTime, ELevelTick TickType, FAct
 	*/
 
 // Parses a message for color change
-void UpdateColor(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateColor(ByteSpan kMsg, AActor* actor)
 {
 	UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Try Type COLOR"));
 	ALight* kLit = Cast<ALight>(actor);
 	if (kLit)
 	{
-		float lR = *reinterpret_cast<float*>(&kMsg[0]);
-		float lG = *reinterpret_cast<float*>(&kMsg[4]);
-		float lB = *reinterpret_cast<float*>(&kMsg[8]);
+		float lR, lG, lB;
+		if (!kMsg.Read(0, lR) || !kMsg.Read(4, lG) || !kMsg.Read(8, lB))
+			return;
 		UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type COLOR: %f %f %f"), lR, lG, lB);
 
 		kLit->SetLightColor(FLinearColor(lR, lG, lB));
@@ -84,13 +106,15 @@ void UpdateColor(std::vector<uint8_t> kMsg, AActor* actor)
 }
 
 // Parses a message for intensity change
-void UpdateIntensity(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateIntensity(ByteSpan kMsg, AActor* actor)
 {
 	UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Try Type INTENSITY"));
 	ALight* kLit = Cast<ALight>(actor);
 	if (kLit)
 	{
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 		UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type INTENSITY: %f"), lK);
 
 		float lightFactor = 0.2;
@@ -3,7 +3,7 @@
 #include "SceneObjectPointLight.h"
 
 // Message parsing pre-declarations
-void UpdatePointRange(std::vector<uint8_t> kMsg, AActor* actor);
+void UpdatePointRange(ByteSpan kMsg, AActor* actor);
 
 // Called when the game starts
 void USceneObjectPointLight::BeginPlay()
@@ -20,14 +20,11 @@ void USceneObjectPointLight::BeginPlay()
 	}
 }
 
-// Using the update loop to check for local parameter changes
-void USceneObjectPointLight::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+// Checks the point light parameters for local changes
+void USceneObjectPointLight::CheckProperties()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	Super::CheckProperties();
 
-	if (_lock)
-		return;
-	
 	if (pointLgtCmp)
 	{
 		float range = pointLgtCmp->AttenuationRadius * rangeFactor;
@@ -42,7 +39,7 @@ void USceneObjectPointLight::TickComponent(float DeltaTime, ELevelTick TickType,
 }
 
 // Parses a message for range change
-void UpdatePointRange(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdatePointRange(ByteSpan kMsg, AActor* actor)
 {
 	UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Try Type RANGE"));
 	APointLight* kPointLgt = Cast<APointLight>(actor);
@@ -53,7 +50,9 @@ void UpdatePointRange(std::vector<uint8_t> kMsg, AActor* actor)
 	{
 		float rangeFactor = 0.005;
 
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 		UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type RANGE: %f"), lK);
 
 		pointLgtCmp->AttenuationRadius = lK / rangeFactor;
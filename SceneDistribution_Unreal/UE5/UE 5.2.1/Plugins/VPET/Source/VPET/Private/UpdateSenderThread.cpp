@@ -11,7 +11,10 @@ void UpdateSenderThread::DoWork()
 	int type;
 	size_t type_size = sizeof(type);
 
-	while (1)
+	std::vector<UpdateSendQueue::Entry> batch;
+
+	// Woken by every push, the timeout only serves the socket check below
+	while (sendQueue->WaitAndTake(batch, std::chrono::milliseconds(100)))
 	{
 		// Try something using the socket just to be able to stop the thread when the socket is closed by EndPlay
 		try {
@@ -21,35 +24,49 @@ void UpdateSenderThread::DoWork()
 		{
 			FString errName = FString(zmq_strerror(e.num()));
 			DOL(doLog, Error, "[SEND Thread] socket exception: %s", *errName);
+			for (UpdateSendQueue::Entry& entry : batch)
+				sendQueue->Discard(entry);
 			return;
 		}
 
 		// Process messages
-		int count = 0;
-		for (size_t i = 0; i < msgData->size(); i++)
+		for (size_t i = 0; i < batch.size(); i++)
 		{
-			count++;
-
 			// Send message
-			DOL(doLog, Log, "[SEND Thread] Send message length: %d", msgLen->at(i));
-			zmq::message_t responseMessage((void*)msgData->at(i), msgLen->at(i), NULL);
+			zmq::message_t responseMessage;
+			Prepare(batch[i], responseMessage);
+			bool sent;
 			try {
-				socket->send(responseMessage);
+				// Blocks for at most the send timeout while the socket is at its high-water mark
+				sent = socket->send(responseMessage);
 			}
 			catch (const zmq::error_t& e)
 			{
 				FString errName = FString(zmq_strerror(e.num()));
 				DOL(doLog, Error, "[SEND Thread] send exception: %s", *errName);
+				for (size_t j = i + 1; j < batch.size(); j++)
+					sendQueue->Discard(batch[j]);
 				return;
 			}
+			if (sent)
+				sendQueue->RecordSent(batch[i]);
+			else
+			{
+				DOL(doLog, Verbose, "[SEND Thread] Send timed out, message dropped");
+				sendQueue->RecordDropped(batch[i]);
+			}
 		}
 
 		// Clean processed messages
-		msgData->erase(msgData->begin(), msgData->begin() + count);
-		msgLen->erase(msgLen->begin(), msgLen->begin() + count);
-
-		// Safety halt
-		// Keeps the thread from running wild
-		Sleep(10);
+		batch.clear();
 	}
-}
\ No newline at end of file
+}
+
+void UpdateSenderThread::Prepare(const UpdateSendQueue::Entry& entry, zmq::message_t& message)
+{
+	DOL(doLog, Log, "[SEND Thread] Send message length: %d", entry.length);
+	if (recorder)
+		recorder->append(VPET::Protocol::LogDirection::OUTBOUND, entry.frame->data, entry.length);
+	// The frame goes back to its pool once zmq is done with it
+	message.rebuild((void*)entry.frame->data, entry.length, UpdateFramePool::ReleaseFrame, entry.frame);
+}
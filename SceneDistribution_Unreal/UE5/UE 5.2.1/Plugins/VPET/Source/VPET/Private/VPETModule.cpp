@@ -1,6 +1,9 @@
 // Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
 
 #include "VPETModule.h"
+#include "NetworkThread.h"
+#include "SceneDistributionThread.h"
+#include "HAL/FileManager.h"
 
 class UMaterialExpressionTextureBase;
 class UMaterialExpressionParameter;
@@ -28,6 +31,52 @@ AVPETModule::AVPETModule()
 	LogFolder = false;
 	LogLayer = false;
 	LogGeoBuild = false;
+	RecordSession = false;
+	ReplaySpeed = 1.0f;
+	UpdatesReceived = 0;
+	UpdatesApplied = 0;
+	UpdatesCoalesced = 0;
+	SyncClockToServer = true;
+	PingInterval = 0.5f;
+	SequenceUpdates = false;
+	JitterBufferDelay = 2;
+	SmoothingExtrapolationLimit = 0.1f;
+	SmoothingMaxSampleInterval = 0.25f;
+	UpdatesLate = 0;
+	UpdatesEarly = 0;
+	ClockRoundTripMs = 0.0f;
+	ClockRoundTripMinMs = 0.0f;
+	ClockJitterMs = 0.0f;
+	ClockOffsetSteps = 0.0f;
+	ClockPings = 0;
+	ClockPingTimeouts = 0;
+	ClockSyncs = 0;
+	ClockJumps = 0;
+	UpdatesMissed = 0;
+	UpdatesRecovered = 0;
+	UpdatesDuplicate = 0;
+	UpdatesStale = 0;
+	UpdatesResent = 0;
+	SingleNetworkThread = true;
+	SendHighWaterMark = 256;
+	ReceiveHighWaterMark = 1024;
+	SendTimeout = 100;
+	SocketLinger = 100;
+	TcpKeepAlive = true;
+	TcpKeepAliveIdle = 10;
+	TcpKeepAliveInterval = 2;
+	LatestStateUpdates = true;
+	ConflateReceivedUpdates = false;
+	ReceiveQueueOverflows = 0;
+	SendDropped = 0;
+	UpdatesHeldBack = 0;
+	SendBacklog = 0;
+	NetworkWakeUps = 0;
+	NetworkBusyMs = 0.0f;
+	PollSceneObjectProperties = false;
+	BatchedChangeDetection = false;
+	ParallelChangeDetection = true;
+	SceneObjectsChecked = 0;
 }
 
 // Called when the game starts or when spawned
@@ -67,6 +116,7 @@ void AVPETModule::BeginPlay()
 	m_state.lodTag = "lo";
 
 	DOL(LogBasic, Log, "[VPET BeginPlay] Building scene...");
+	std::chrono::steady_clock::time_point traverseStart = std::chrono::steady_clock::now();
 
 	// World tweak - creating a global root
 	buildWorld();
@@ -90,6 +140,7 @@ void AVPETModule::BeginPlay()
 	// Edit root child count
 	m_state.nodeList.at(0)->childCount = rootChildrenCount;
 	DOL(LogBasic, Log, "[VPET BeginPlay] Root children count: %i", m_state.nodeList.at(0)->childCount);
+	m_state.stats.addPhase(PHASE_TRAVERSE, microsSince(traverseStart));
 
 	// Print stats
 	DOL(LogBasic, Log, "[VPET BeginPlay] Texture Count: %i", m_state.texPackList.size());
@@ -99,6 +150,7 @@ void AVPETModule::BeginPlay()
 	DOL(LogBasic, Log, "[VPET BeginPlay] Objects: %i", m_state.numObjectNodes);
 	DOL(LogBasic, Log, "[VPET BeginPlay] Lights: %i", m_state.numLights);
 	DOL(LogBasic, Log, "[VPET BeginPlay] Cameras: %i", m_state.numCameras);
+	DOL(LogBasic, Log, "[VPET BeginPlay] Build stats: %s", UTF8_TO_TCHAR(m_state.stats.toJson().c_str()));
 
 
 	// Open ØMQ context
@@ -108,6 +160,7 @@ void AVPETModule::BeginPlay()
 	// Distribution thread - for hosting the scene - TODO promote the port value to somewhere easier to find
 	FString distributionPort(":5555");
 	socket_d = new zmq::socket_t(*context, ZMQ_REP);
+	ConfigureSocket(socket_d);
 
 	// Safe attempt to bind - if socket exists, stop it all
 	try {
@@ -126,9 +179,12 @@ void AVPETModule::BeginPlay()
 	DOL(LogBasic, Warning, "[VPET2 BeginPlay] Distribution socket created!");
 	OSD(FColor::Cyan, "[VPET2 BeginPlay] Distribution socket created!");
 
-	// Start distribution (request / reply) thread
-	auto tDistribute = new FAutoDeleteAsyncTask<SceneSenderThread>(socket_d, &m_state, LogBasic);
-	tDistribute->StartBackgroundTask();
+	// Start distribution (request / reply) thread, a SceneDistributionThread serves the socket otherwise
+	if (!SingleNetworkThread)
+	{
+		auto tDistribute = new FAutoDeleteAsyncTask<SceneSenderThread>(context, socket_d, &m_state, LogBasic);
+		tDistribute->StartBackgroundTask();
+	}
 
 
 	// Update Receiver Thread
@@ -137,6 +193,12 @@ void AVPETModule::BeginPlay()
 	socket_r = new zmq::socket_t(*context, ZMQ_SUB);
 	// cpp method
 	socket_r->setsockopt(ZMQ_SUBSCRIBE, "", 0);
+	ConfigureSocket(socket_r);
+	if (ConflateReceivedUpdates)
+	{
+		int conflate = 1;
+		socket_r->setsockopt(ZMQ_CONFLATE, &conflate, sizeof(conflate));
+	}
 
 	// Safe attempt to connect - if socket exists, stop it all
 	try {
@@ -156,20 +218,90 @@ void AVPETModule::BeginPlay()
 	OSD(FColor::Cyan, "[VPET2 BeginPlay] Update receiver socket created!");
 
 	// Start the message queues
-	msgQ.clear();
-	msgQs.clear();
-	msgData.clear();
-	msgLen.clear();
+	msgQ.Reset();
+	msgQOverflowsReported = 0;
+	numPendingUpdates = 0;
+	pendingSlotByParam.Reset();
+	UpdatesReceived = 0;
+	UpdatesApplied = 0;
+	UpdatesCoalesced = 0;
+	UpdatesLate = 0;
+	UpdatesEarly = 0;
+	smoothingTracks.Reset();
+	smoothingTrackByObject.Reset();
+	activeSmoothingTracks.Reset();
+	sendQueue.Reset();
+	updateHistory.Reset();
+	UpdatesMissed = 0;
+	UpdatesRecovered = 0;
+	UpdatesDuplicate = 0;
+	UpdatesStale = 0;
+	UpdatesResent = 0;
+	ReceiveQueueOverflows = 0;
+	SendDropped = 0;
+	UpdatesHeldBack = 0;
+	SendBacklog = 0;
+	NetworkWakeUps = 0;
+	NetworkBusyMs = 0.0f;
+	SceneObjectsChecked = 0;
+	sequenceMissed = 0;
+	sequenceRecovered = 0;
+	sequenceDuplicates = 0;
+	sequenceResent = 0;
+
+	// Time steps, the clock starts before the receiver can deliver SYNC messages
+	m_timesteps = (uint8_t)((s_timestepsBase / framerate) * framerate);
+	m_time = 0;
+	clockSync.Reset(m_timesteps, framerate, FPlatformTime::Seconds());
 
-	// Start synchronization (receiver) thread
-	auto tUpdateReceiver = new FAutoDeleteAsyncTask<UpdateReceiverThread>(socket_r, &msgQ, m_id, LogBasic, this);
-	tUpdateReceiver->StartBackgroundTask();
+	// Session log recording
+	sessionRecorder.reset();
+	if (RecordSession)
+	{
+		FString logDirectory = SessionLogDirectory.IsEmpty() ? FPaths::ProjectSavedDir() / TEXT("VPET") : SessionLogDirectory;
+		IFileManager::Get().MakeDirectory(*logDirectory, true);
+		FString logPath = FPaths::ConvertRelativePathToFull(logDirectory / FString::Printf(TEXT("Session_%s.vpetlog"), *FDateTime::Now().ToString()));
+		auto recorder = std::make_shared<VPET::Protocol::SessionLogWriter>();
+		if (recorder->open(TCHAR_TO_UTF8(*logPath)))
+		{
+			sessionRecorder = recorder;
+			DOL(LogBasic, Warning, "[VPET2 BeginPlay] Recording session to %s", *logPath);
+		}
+		else
+			DOL(LogBasic, Error, "[VPET2 BeginPlay] Could not create session log %s", *logPath);
+	}
+
+	// Session log replay, replaces the messages of the sync server
+	sessionReplay.reset();
+	if (!ReplaySessionLog.IsEmpty())
+	{
+		auto replay = std::make_shared<SessionReplay>();
+		replay->speed = FMath::Max(ReplaySpeed, 0.0f);
+		if (replay->reader.open(TCHAR_TO_UTF8(*FPaths::ConvertRelativePathToFull(ReplaySessionLog))))
+			sessionReplay = replay;
+		else
+			DOL(LogBasic, Error, "[VPET2 BeginPlay] Could not open session log %s, receiving from the sync server", *ReplaySessionLog);
+	}
+
+	// Start synchronization (receiver) thread, a replay reads its log on its own thread in both designs
+	if (!SingleNetworkThread || sessionReplay)
+	{
+		auto tUpdateReceiver = new FAutoDeleteAsyncTask<UpdateReceiverThread>(socket_r, &msgQ, m_id, LogBasic, this, SyncClockToServer ? &clockSync : nullptr, sessionRecorder, sessionReplay);
+		tUpdateReceiver->StartBackgroundTask();
+	}
 
 
 	// Update Sender Thread
 	FString updateSenderPort(":5557");
 	// Prepare ZMQ Publisher socket
 	socket_s = new zmq::socket_t(*context, ZMQ_PUB);
+	ConfigureSocket(socket_s);
+	// At the high-water mark sends block for the send timeout instead of silently dropping,
+	// the sender thread counts the messages that still did not fit
+	int noDrop = 1;
+	socket_s->setsockopt(ZMQ_XPUB_NODROP, &noDrop, sizeof(noDrop));
+	int sendTimeout = FMath::Max(SendTimeout, 0);
+	socket_s->setsockopt(ZMQ_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
 
 	// Safe attempt to connect - if socket exists, stop it all
 	try {
@@ -189,168 +321,255 @@ void AVPETModule::BeginPlay()
 	OSD(FColor::Cyan, "[VPET2 BeginPlay] Update sender socket created!");
 
 	// Start synchronization (sender) thread
-	auto tUpdateSender = new FAutoDeleteAsyncTask<UpdateSenderThread>(socket_s, &msgQs, m_id, LogBasic, &msgData, &msgLen);//, &runThreadSend);
-	tUpdateSender->StartBackgroundTask();
+	if (!SingleNetworkThread)
+	{
+		auto tUpdateSender = new FAutoDeleteAsyncTask<UpdateSenderThread>(socket_s, &sendQueue, m_id, LogBasic, sessionRecorder);
+		tUpdateSender->StartBackgroundTask();
+	}
+
+	// Clock sync thread - pings the sync server, a replayed session has no server to ping
+	FString pingPort(":5558");
+	FString pingAddress = FString("tcp://") + HostIP + pingPort;
+	const bool pingServer = SyncClockToServer && !sessionReplay;
+	if (pingServer && !SingleNetworkThread)
+	{
+		auto tClockSync = new FAutoDeleteAsyncTask<ClockSyncThread>(context, std::string(TCHAR_TO_UTF8(*pingAddress)), &clockSync, m_id, PingInterval, LogBasic);
+		tClockSync->StartBackgroundTask();
+	}
+
+	// Network thread - one poll loop over the update and ping sockets, the thread classes above handle their socket in it.
+	// Scene replies are built and sent on their own thread, so a large objects or textures reply does not stall the updates.
+	if (SingleNetworkThread)
+	{
+		sceneThread = new SceneDistributionThread(new SceneSenderThread(context, socket_d, &m_state, LogBasic), LogBasic);
+		if (!sceneThread->Start())
+		{
+			DOL(LogBasic, Error, "[VPET2 BeginPlay] ERROR Scene distribution thread could not be created");
+			OSD(FColor::Red, "[VPET2 BeginPlay] ERROR Scene distribution thread could not be created");
+		}
+
+		networkThread = new NetworkThread(context, &sendQueue, SendTimeout, LogBasic,
+			sessionReplay ? nullptr : new UpdateReceiverThread(socket_r, &msgQ, m_id, LogBasic, this, SyncClockToServer ? &clockSync : nullptr, sessionRecorder),
+			new UpdateSenderThread(socket_s, &sendQueue, m_id, LogBasic, sessionRecorder),
+			pingServer ? new ClockSyncThread(context, std::string(TCHAR_TO_UTF8(*pingAddress)), &clockSync, m_id, PingInterval, LogBasic) : nullptr);
+		if (!networkThread->Start())
+		{
+			DOL(LogBasic, Error, "[VPET2 BeginPlay] ERROR Network thread could not be created");
+			OSD(FColor::Red, "[VPET2 BeginPlay] ERROR Network thread could not be created");
+		}
+	}
 
 #if WITH_EDITOR
 	// Manage editor selection changes 
 	FLevelEditorModule& levelEditor = FModuleManager::GetModuleChecked<FLevelEditorModule>("LevelEditor");
 	FLevelEditorModule::FActorSelectionChangedEvent fasce = levelEditor.OnActorSelectionChanged();
 	levelEditor.OnActorSelectionChanged().AddUObject(this, &AVPETModule::HandleOnActorSelectionChanged);
+	// Manage details panel edits of light and camera properties
+	propertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &AVPETModule::HandleObjectPropertyChanged);
 #endif // WITH_EDITOR
-	// subscribe to delegate 
+	// subscribe to delegate and give every parameter its slot in the modified set
+	VPET_ParameterSlots.Reset();
+	dirtySceneObjects.Reset();
+	polledSceneObjects.Reset();
+	sceneObjectBatch.Reset();
 	for (auto i=1; i<VPET_SceneObjectList.Num(); i++)
 	{
-		VPET_SceneObjectList[i]->ParameterObject_HasChanged.AddUObject(this, &AVPETModule::HasChangedIsCalled);
+		USceneObject* sceneObj = VPET_SceneObjectList[i];
+		if (BatchedChangeDetection)
+		{
+			sceneObj->_batched = true;
+			sceneObj->_transformDirty = false;
+			sceneObjectBatch.Add(sceneObj);
+		}
+		for (AbstractParameter* param : *sceneObj->GetParameterList())
+			param->_slot = VPET_ParameterSlots.Add(param);
+		sceneObj->ParameterObject_HasChanged.AddUObject(this, &AVPETModule::HasChangedIsCalled);
+		// the objects report their changes, only the dirty ones are checked in Tick
+		sceneObj->SceneObject_IsDirty.BindUObject(this, &AVPETModule::HandleSceneObjectDirty);
+		if (sceneObj->_transformDirty || sceneObj->_propertiesDirty)
+			dirtySceneObjects.Add(sceneObj);
+		if (sceneObj->HasPolledProperties())
+			polledSceneObjects.Add(sceneObj);
 	}
+	VPET_ModifiedParameters.Init(false, VPET_ParameterSlots.Num());
+	VPET_ParameterOrigins.Init(ParameterOrigin(), VPET_ParameterSlots.Num());
+	VPET_modifiedParametersCount = 0;
 
-	m_timesteps = (uint8_t)((s_timestepsBase / framerate) * framerate);
-
+	// the ring holds one bucket per time step, disabled without delay
+	if (JitterBufferDelay > 0)
+		jitterBuffer.Reset(m_timesteps, JitterPlayoutTime());
+	else
+		jitterBuffer.Reset(0, 0);
 	
 	GetWorld()->GetTimerManager().SetTimer(MemberTimerHandle, this, &AVPETModule::UpdateTime, 1.0f/framerate, true);
 }
 
 void AVPETModule::UpdateTime()
 {
-	m_time = (m_time > (m_timesteps - 2) ? 0 : m_time + 1);
+	const uint8_t previousTime = m_time;
+	if (SyncClockToServer)
+		m_time = clockSync.Advance(FPlatformTime::Seconds());
+	else
+		m_time = (m_time > (m_timesteps - 2) ? 0 : m_time + 1);
 
-	if ((m_time % framerate) == 0)
+	// a slewed clock can stay on a step for two ticks
+	if (m_time != previousTime && (m_time % framerate) == 0)
 	{
 		queueSyncMessage(m_time);
 	}
 }
 
-//time sync msg between server and client
-void AVPETModule::queueSyncMessage(uint8_t time)
+void AVPETModule::ConfigureSocket(zmq::socket_t* socket)
 {
-	
-	char* messageStart = NULL;
-	int responseLength = 0;
-	char* m_controlMessage = NULL;
-	
-	responseLength = 3;
-	messageStart = m_controlMessage = (char*)malloc(responseLength);
-
-	//client ID
-	uint8_t intVal = m_id;
-	memcpy(m_controlMessage, &intVal, sizeof(uint8_t)); m_controlMessage += sizeof(uint8_t);
-
-	//Time
-	intVal = time;
-	memcpy(m_controlMessage, &intVal, sizeof(uint8_t)); m_controlMessage += sizeof(uint8_t);
-
-	//Type sync val 2 in unity code
-	intVal = 2;
-	memcpy(m_controlMessage, &intVal, sizeof(uint8_t));
-	
-	msgData.push_back(messageStart);
-	msgLen.push_back(responseLength);
-	
-}
-
-// add or remove a parameter to the VPET_ModifiedParameterList if the parameter was modified.
-void AVPETModule::HasChangedIsCalled(AbstractParameter* param)
-{
-	UE_LOG(LogTemp, Error, TEXT("change is called with param type %hhd"), param->_type);
-	UE_LOG(LogTemp, Error, TEXT("change is called with param dataSyze %d"), param->dataSize());
-	
-	bool paramInList = VPET_ModifiedParameterList.Contains(param);
-	
-	if (paramInList)
-	{
-			VPET_ModifiedParameterList.Remove(param);
-			VPET_modifiedParametersDataSize -= param->dataSize();
-	}
-	
-	else if (!paramInList)
+	int sendHighWaterMark = FMath::Max(SendHighWaterMark, 1);
+	int receiveHighWaterMark = FMath::Max(ReceiveHighWaterMark, 1);
+	int linger = FMath::Max(SocketLinger, 0);
+	socket->setsockopt(ZMQ_SNDHWM, &sendHighWaterMark, sizeof(sendHighWaterMark));
+	socket->setsockopt(ZMQ_RCVHWM, &receiveHighWaterMark, sizeof(receiveHighWaterMark));
+	socket->setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+
+	int keepAlive = TcpKeepAlive ? 1 : 0;
+	socket->setsockopt(ZMQ_TCP_KEEPALIVE, &keepAlive, sizeof(keepAlive));
+	if (TcpKeepAlive)
 	{
-		VPET_ModifiedParameterList.Add(param);
-		VPET_modifiedParametersDataSize += param->dataSize();
+		int idle = FMath::Max(TcpKeepAliveIdle, 1);
+		int interval = FMath::Max(TcpKeepAliveInterval, 1);
+		int probes = 3;
+		socket->setsockopt(ZMQ_TCP_KEEPALIVE_IDLE, &idle, sizeof(idle));
+		socket->setsockopt(ZMQ_TCP_KEEPALIVE_INTVL, &interval, sizeof(interval));
+		socket->setsockopt(ZMQ_TCP_KEEPALIVE_CNT, &probes, sizeof(probes));
 	}
-	
-	UE_LOG(LogTemp, Error, TEXT("m_modifiedParametersDataSize = %d"), VPET_modifiedParametersDataSize);
 }
 
-void AVPETModule::CreateParameterMessage()
+// time step of the jitter buffer bucket that is due for playout
+uint8_t AVPETModule::JitterPlayoutTime() const
 {
+	return (uint8_t)((m_time + m_timesteps - (JitterBufferDelay % m_timesteps)) % m_timesteps);
+}
 
-	char* responseMessageContent = NULL;
-	char* messageStart = NULL;
-	char* parameterData = NULL;
-	int responseLength = 0;
-	
-	responseLength = 3 + VPET_modifiedParametersDataSize + 7 * VPET_ModifiedParameterList.Num();
-	messageStart = responseMessageContent = (char*)malloc(responseLength);
-
+//time sync msg between server and client
+void AVPETModule::queueSyncMessage(uint8_t time)
+{
+	UpdateFrame* frame = framePool.Acquire(VPET::Protocol::CONTROL_MESSAGE_SIZE);
+	size_t responseLength = VPET::Protocol::encodeControl(reinterpret_cast<uint8_t*>(frame->data), frame->capacity, m_id, time, VPET::Protocol::MessageType::SYNC);
+	sendQueue.Push(frame, (int)responseLength);
+}
 
-	//header
+// mark a parameter as modified, it is sent with the next parameter message
+// marking an already modified parameter again changes nothing, the latest value is serialized
+void AVPETModule::HasChangedIsCalled(AbstractParameter* param)
+{
+	if (param->_slot < 0 || VPET_ModifiedParameters[param->_slot])
+		return;
 
-	//client ID
-	uint8_t intVal = m_id;
-	memcpy(responseMessageContent, &intVal, sizeof(uint8_t)); responseMessageContent += sizeof(uint8_t);
+	VPET_ModifiedParameters[param->_slot] = true;
+	VPET_modifiedParametersCount++;
 
-	//Time 
-	intVal = m_time;
-	memcpy(responseMessageContent, &intVal, sizeof(uint8_t)); responseMessageContent += sizeof(uint8_t);
+	DOL(LogBasic, Log, "[VPET2 Sync] Parameter %d of object %d modified, %d parameters pending", param->_id, param->_parent ? param->_parent->ID : -1, VPET_modifiedParametersCount);
+}
 
-	//Type parameter update  val 0 in unity code
-	intVal = 0;
-	memcpy(responseMessageContent, &intVal, sizeof(uint8_t)); responseMessageContent += sizeof(uint8_t);
+// Sends the modified parameters and clears their bits. Sizes are taken from the current values,
+// variable size parameters may have grown since they were marked. Parameters that do not fit
+// the frame anymore stay marked for the next message. Returns the number of cleared parameters.
+int32 AVPETModule::CreateParameterMessage()
+{
+	size_t totalDataSize = 0;
+	for (TConstSetBitIterator<> it(VPET_ModifiedParameters); it; ++it)
+	{
+		AbstractParameter* parameter = VPET_ParameterSlots[it.GetIndex()];
+		std::lock_guard lock(parameter->mtx);
+		totalDataSize += FMath::Min((size_t)parameter->dataSize(), VPET::Protocol::MAX_PARAMETER_DATA_SIZE);
+	}
 
-	//start of the msg after the header (pos 3)
-	int start = 3;
-	for (auto &parameter: VPET_ModifiedParameterList )
+	size_t responseLength = VPET::Protocol::parameterMessageSize(VPET_modifiedParametersCount, totalDataSize, SequenceUpdates);
+	// recycled frame, returned to the pool after it is sent
+	UpdateFrame* frame = framePool.Acquire(responseLength);
+
+	VPET::Protocol::Header header;
+	header.clientID = m_id;
+	header.time = m_time;
+	header.type = VPET::Protocol::MessageType::PARAMETERUPDATE;
+	header.sequenced = SequenceUpdates;
+	header.sequence = nextSequence;
+	VPET::Protocol::ParameterMessageWriter writer(reinterpret_cast<uint8_t*>(frame->data), frame->capacity, header);
+
+	TArray<int32, TInlineAllocator<64>> clearedSlots;
+	int32 records = 0;
+	for (TConstSetBitIterator<> it(VPET_ModifiedParameters); it; ++it)
 	{
-		//the length of the parameter msg + parameter data!
-		int length = 7 + parameter->dataSize();
+		AbstractParameter* parameter = VPET_ParameterSlots[it.GetIndex()];
 
 		//lock the parameter!
 		std::lock_guard lock(parameter->mtx);
 
-		//scene id
-		uint8_t sceneID_Val = m_id;
-		memcpy(responseMessageContent, &sceneID_Val, sizeof(uint8_t)); responseMessageContent += sizeof(uint8_t);
-		
-		//Scene object ID
-		uint16_t shortVal = parameter->_parent->ID;
-		memcpy(responseMessageContent, &shortVal, sizeof(uint16_t)); responseMessageContent += sizeof(uint16_t);
+		// a value longer than a record can hold is never sent, it must not hold back the others
+		const int dataSize = parameter->dataSize();
+		if (dataSize > (int)VPET::Protocol::MAX_PARAMETER_DATA_SIZE)
+		{
+			DOL(LogBasic, Error, "[VPET2 Sync] Parameter %d of object %d has %d bytes, more than a parameter record holds, not sent", parameter->_id, parameter->_parent->ID, dataSize);
+			clearedSlots.Add(it.GetIndex());
+			continue;
+		}
 
-		//parameter ID(location, rotation, scale...)
-		shortVal = parameter->_id;
-		memcpy(responseMessageContent, &shortVal, sizeof(uint16_t)); responseMessageContent += sizeof(uint16_t);
+		//TODO add scene id
+		uint8_t* data = writer.addParameter(m_id, parameter->_parent->ID, parameter->_id, parameter->_type, dataSize);
+		if (!data)
+			break;
 
-		// Parameter VPET type!
-		intVal = static_cast<uint8_t>(parameter->_type);
-		memcpy(responseMessageContent, &intVal, sizeof(uint8_t)); responseMessageContent += sizeof(uint8_t);
+		// the serialization of the parameter DATA, straight into the frame!
+		parameter->Serialize(reinterpret_cast<char*>(data));
+		clearedSlots.Add(it.GetIndex());
+		records++;
+	}
 
-		// the length of 1 parameter msg without the header.
-		intVal = length;
-		memcpy(responseMessageContent, &intVal, sizeof(uint8_t)); responseMessageContent += sizeof(uint8_t);
+	for (int32 slot : clearedSlots)
+		VPET_ModifiedParameters[slot] = false;
+	VPET_modifiedParametersCount -= clearedSlots.Num();
 
-		// the serialization of the parameter DATA!
+	if (records == 0)
+	{
+		framePool.Release(frame);
+		return clearedSlots.Num();
+	}
 
-		parameterData = (char*)malloc(parameter->dataSize());
-		parameter->Serialize(parameterData, parameter->GetName());
-		memcpy(responseMessageContent, parameterData, parameter->dataSize()); responseMessageContent += parameter->dataSize();
+	// Keep a copy for resend requests
+	if (SequenceUpdates)
+	{
+		updateHistory.Store(nextSequence, frame->data, writer.size());
+		nextSequence++;
+	}
 
-		//TODO MAGIC NR  
-		char* startOfData = responseMessageContent - 13;
+	// Push to queue
+	sendQueue.Push(frame, (int)writer.size());
+	return clearedSlots.Num();
+}
 
-		// Log each float in data:
-		for (int i = 0; i < 3; i++)
-		{
-			float floatValue;
-			std::memcpy(&floatValue, startOfData + i * sizeof(float), sizeof(float));
-			UE_LOG(LogTemp, Warning, TEXT("Float value %d: %f"), i, floatValue);
-		}
-		free(parameterData);
+// Asks a sender to publish a range of its sequenced updates again
+void AVPETModule::QueueResendRequest(uint8_t targetID, uint16_t firstSequence, int count)
+{
+	VPET::Protocol::ResendRequest request;
+	request.header.clientID = m_id;
+	request.header.time = m_time;
+	request.header.type = VPET::Protocol::MessageType::RESENDUPDATE;
+	request.targetID = targetID;
+	request.firstSequence = firstSequence;
+	request.count = (uint8_t)FMath::Clamp(count, 0, 255);
+
+	UpdateFrame* frame = framePool.Acquire(VPET::Protocol::RESEND_REQUEST_SIZE);
+	size_t requestLength = VPET::Protocol::encodeResendRequest(reinterpret_cast<uint8_t*>(frame->data), frame->capacity, request);
+	sendQueue.Push(frame, (int)requestLength);
+}
 
-		start += length;
-	}
-	// Push to queue
-	msgData.push_back(messageStart);
-	msgLen.push_back(responseLength);
-	
+// Publishes the requested updates again as far as they are still in the history
+void AVPETModule::AnswerResendRequest(uint16_t firstSequence, int count)
+{
+	const int resent = updateHistory.ForEach(firstSequence, count, [this](const uint8_t* data, size_t size)
+	{
+		UpdateFrame* frame = framePool.Acquire(size);
+		FMemory::Memcpy(frame->data, data, size);
+		sendQueue.Push(frame, (int)size);
+	});
+	sequenceResent += resent;
 }
 
 // Called every frame
@@ -358,17 +577,67 @@ void AVPETModule::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// Process messages
-	int count = 0;
-	for (size_t i = 0; i < msgQ.size(); i++)
+	// Process messages, slots are handed back to the receiver after parsing
+	// or after being copied into the bucket of their time step
+	while (zmq::message_t* msg = msgQ.Peek())
+	{
+		const ByteSpan message(msg->data(), msg->size());
+		uint8_t time = 0;
+		if (!jitterBuffer.IsEnabled() || !message.Read(1, time)
+			|| jitterBuffer.Add(time, message, JitterBufferDelay + s_jitterBufferSlack) != UpdateJitterBuffer::Placement::Buffered)
+			ParseParameterUpdate(message);
+		msgQ.Pop();
+	}
+
+	// Play out all time steps up to the synchronized time minus the delay
+	if (jitterBuffer.IsEnabled())
+	{
+		jitterBuffer.PlayOut(JitterPlayoutTime(), [this](ByteSpan message) { ParseParameterUpdate(message); });
+		UpdatesLate = jitterBuffer.GetLateCount();
+		UpdatesEarly = jitterBuffer.GetEarlyCount();
+	}
+
+	UpdatesMissed = sequenceMissed;
+	UpdatesRecovered = sequenceRecovered;
+	UpdatesDuplicate = sequenceDuplicates;
+	UpdatesResent = sequenceResent;
+	SendDropped = sendQueue.GetDroppedCount();
+	SendBacklog = sendQueue.GetBacklog();
+	if (networkThread)
+	{
+		NetworkWakeUps = networkThread->GetWakeUps();
+		NetworkBusyMs = (float)(networkThread->GetBusySeconds() * 1000.0);
+	}
+
+	if (SyncClockToServer)
 	{
-		std::vector<uint8_t> msg = msgQ.at(i);
-		ParseParameterUpdate(msg);
-		count++;
+		const ClockSync::Stats clockStats = clockSync.GetStats();
+		ClockRoundTripMs = (float)clockStats.rttMillis;
+		ClockRoundTripMinMs = (float)clockStats.minRttMillis;
+		ClockJitterMs = (float)clockStats.jitterMillis;
+		ClockOffsetSteps = (float)clockStats.offsetSteps;
+		ClockPings = clockStats.pings;
+		ClockPingTimeouts = clockStats.pingTimeouts;
+		ClockSyncs = clockStats.syncs;
+		ClockJumps = clockStats.jumps;
 	}
 
-	// Clean processed messages
-	msgQ.erase(msgQ.begin(), msgQ.begin() + count);
+	// Apply only the latest value of every updated parameter
+	ApplyPendingUpdates();
+
+	// Blend all remotely moved objects towards their received transforms
+	UpdateTransformSmoothing(GetWorld()->GetRealTimeSeconds());
+
+	// Look for local changes of the objects that were moved or edited
+	CheckSceneObjects();
+
+	const uint64_t overflows = msgQ.GetOverflowCount();
+	if (overflows != msgQOverflowsReported)
+	{
+		DOL(LogBasic, Warning, "[VPET2 Tick] Update queue overflowed, %llu messages dropped so far", (unsigned long long)overflows);
+		msgQOverflowsReported = overflows;
+		ReceiveQueueOverflows = (int64)overflows;
+	}
 
 
 #if WITH_EDITOR
@@ -394,38 +663,49 @@ void AVPETModule::Tick(float DeltaTime)
 	}
 
 #endif // WITH_EDITOR
-	if (VPET_ModifiedParameterList.Num()>0)
+	// While the socket is backed up the modified set keeps collecting, the held back
+	// parameters go out with their latest values in one message once it has drained
+	if (VPET_modifiedParametersCount > 0 && LatestStateUpdates && sendQueue.GetBacklog() > 0)
+		UpdatesHeldBack++;
+	else
 	{
-		CreateParameterMessage();
-		VPET_ModifiedParameterList.Empty();
-		VPET_modifiedParametersDataSize = 0;
+		// one message per frame worth of parameters, until the set is empty or nothing fits anymore
+		while (VPET_modifiedParametersCount > 0)
+		{
+			if (CreateParameterMessage() == 0)
+				break;
+		}
 	}
 
 }
 
 
-void AVPETModule::ParseParameterUpdate(std::vector<uint8_t> kMsg)
+void AVPETModule::ParseParameterUpdate(ByteSpan kMsg)
 {
 	// Development print - print a bunch of bytes
 	// Grab a byte
 	/*uint8_t fByte;
-	for (size_t j = 0; j < kMsg.size(); j++)
+	for (size_t j = 0; j < kMsg.Size(); j++)
 	{
-		fByte = kMsg[j];
+		kMsg.Read(j, fByte);
 		DOL(LogBasic, Error, "[Parse] Byte: %d, value: %d", j, fByte);
 	}*/
 
-	for (int i = 3; i < kMsg.size() ; )
+	VPET::Protocol::Header header;
+	if (!VPET::Protocol::decodeHeader(kMsg.Data(), kMsg.Size(), header))
+		return;
+
+	VPET::Protocol::ParameterMessageReader reader(kMsg.Data(), kMsg.Size());
+	VPET::Protocol::ParameterRecord record;
+	while (reader.next(record))
 	{
-		int16_t objectID = *reinterpret_cast<int16_t*>(&kMsg[i+1]);
-		int16_t paramID = *reinterpret_cast<int16_t*>(&kMsg[i+3]);
-		int length = *&kMsg[i+6];
-		//DOL(LogBasic, Error, "Length from position &kMsg[i+5] : %d", length);
+		const int objectID = record.objectID;
+		const int paramID = record.parameterID;
 
 		DOL(LogBasic, Log, "[SYNC Parse] obj Id: %d", objectID);
 		//OSD(FColor::Yellow, "[SYNC Parse] obj Id: %d", objectID);
 
-		if (actorList.Num() <= objectID)
+		if (actorList.Num() <= objectID || VPET_SceneObjectList.Num() <= objectID || !VPET_SceneObjectList[objectID])
 		{
 			DOL(LogBasic, Error, "[SYNC Parse] Failed to grab object refered by Id: %d", objectID);
 			OSD(FColor::Red, "[SYNC Parse] Failed to grab object refered by Id: %d", objectID);
@@ -434,28 +714,205 @@ void AVPETModule::ParseParameterUpdate(std::vector<uint8_t> kMsg)
 		//AActor* sceneActor = actorList[objectID];
 		DOL(LogBasic, Log, "[SYNC Parse] Param ID: %d", paramID);
 
-		//ParameterType paramType = (ParameterType)kMsg[i+4];
-		//DOL(LogBasic, Log, "[SYNC Parse] Param type: %d", paramType);
-
 		// grab scene object and its parameters
 		USceneObject* sceneObj = VPET_SceneObjectList[objectID];
 		TArray<AbstractParameter*>* tempArray = sceneObj->GetParameterList();
 
 		if (paramID < tempArray->Num())
 		{
-			// pass actual message to a parameter from an object
+			// keep the value for the parameter of the object, applied at the end of the tick
 			AbstractParameter* tempParam = (*tempArray)[paramID];
-			std::vector<uint8_t> subMsg = std::vector<uint8_t>(kMsg.begin()+i+7, kMsg.begin()+i+length);
-			tempParam->ParseMessage(subMsg);
+			if (tempParam->_slot >= 0)
+			{
+				// a recovered update of a sender must not replace a newer value of the same sender
+				ParameterOrigin& origin = VPET_ParameterOrigins[tempParam->_slot];
+				if (header.sequenced && origin.sender == header.clientID && VPET::Protocol::sequenceDelta(header.sequence, origin.sequence) < 0)
+				{
+					UpdatesStale++;
+					continue;
+				}
+				origin.sender = header.sequenced ? header.clientID : -1;
+				origin.sequence = header.sequence;
+			}
+			QueueParameterUpdate(tempParam, ByteSpan(record.data, record.dataSize));
 		}
 		else
 		{
 			DOL(LogBasic, Error, "[SYNC Parse] Trying to edid param ID %d but it's not available", paramID);
 		}
-		i+=length;
 	}
+
+	if (reader.failed())
+	{
+		DOL(LogBasic, Error, "[SYNC Parse] Truncated parameter record at byte %d, dropping the rest of the message", (int)reader.offset());
+	}
+}
+
+
+// Stores the value as the pending update of the parameter, replacing an older one from the same tick
+void AVPETModule::QueueParameterUpdate(AbstractParameter* param, ByteSpan value)
+{
+	UpdatesReceived++;
+
+	int32* slot = pendingSlotByParam.Find(param);
+	PendingUpdate* update;
+	if (slot)
+	{
+		UpdatesCoalesced++;
+		update = &pendingUpdates[*slot];
+	}
+	else
+	{
+		if (numPendingUpdates == pendingUpdates.Num())
+			pendingUpdates.AddDefaulted();
+		pendingSlotByParam.Add(param, numPendingUpdates);
+		update = &pendingUpdates[numPendingUpdates++];
+		update->param = param;
+	}
+
+	// Value buffers keep their allocation between ticks
+	update->value.SetNumUninitialized(value.Size(), false);
+	if (value.Size() > 0)
+		FMemory::Memcpy(update->value.GetData(), value.Data(), value.Size());
 }
 
+// Applies the pending updates in order of their first arrival
+void AVPETModule::ApplyPendingUpdates()
+{
+	const double now = GetWorld()->GetRealTimeSeconds();
+	for (int32 i = 0; i < numPendingUpdates; i++)
+	{
+		PendingUpdate& update = pendingUpdates[i];
+		const ByteSpan value(update.value.GetData(), update.value.Num());
+		if (!QueueTransformSample(update.param, value, now))
+			update.param->ParseMessage(value);
+		UpdatesApplied++;
+	}
+
+	numPendingUpdates = 0;
+	pendingSlotByParam.Reset();
+}
+
+// Keeps a received position or rotation as sample of the smoothing track of its object,
+// false if the parameter is not smoothed and has to be applied directly
+bool AVPETModule::QueueTransformSample(AbstractParameter* param, ByteSpan value, double now)
+{
+	USceneObject* sceneObj = Cast<USceneObject>(param->_parent);
+	if (!sceneObj || !sceneObj->thisActor || sceneObj->TransformSmoothing == EVpetTransformSmoothing::None)
+		return false;
+
+	const bool isPosition = param == sceneObj->GetPositionParameter();
+	const bool isRotation = param == sceneObj->GetRotationParameter();
+	if (!isPosition && !isRotation)
+		return false;
+
+	int32* index = smoothingTrackByObject.Find(sceneObj);
+	if (!index)
+	{
+		FTransformSmoothingTrack& newTrack = smoothingTracks.AddDefaulted_GetRef();
+		newTrack.object = sceneObj;
+		newTrack.actor = sceneObj->thisActor;
+		index = &smoothingTrackByObject.Add(sceneObj, smoothingTracks.Num() - 1);
+	}
+	FTransformSmoothingTrack& track = smoothingTracks[*index];
+
+	if (isPosition)
+	{
+		FVector position;
+		if (!DecodePosition(value, position))
+			return true;
+		track.position.Push(position, now, SmoothingMaxSampleInterval);
+		track.positionActive = true;
+	}
+	else
+	{
+		FQuat rotation;
+		if (!DecodeRotation(value, track.actor, rotation))
+			return true;
+		track.rotation.Push(rotation, now, SmoothingMaxSampleInterval);
+		track.rotationActive = true;
+	}
+
+	if (!track.active)
+	{
+		track.active = true;
+		activeSmoothingTracks.Add(*index);
+		sceneObj->_smoothing = true;
+	}
+	return true;
+}
+
+// One pass over the active smoothing tracks, finished tracks leave the active list
+void AVPETModule::UpdateTransformSmoothing(double now)
+{
+	for (int32 i = activeSmoothingTracks.Num() - 1; i >= 0; i--)
+	{
+		FTransformSmoothingTrack& track = smoothingTracks[activeSmoothingTracks[i]];
+		const EVpetTransformSmoothing mode = track.object->TransformSmoothing;
+
+		if (track.positionActive)
+		{
+			FVector position;
+			track.positionActive = track.position.Evaluate(now, mode, SmoothingExtrapolationLimit, position);
+			track.actor->SetActorRelativeLocation(position);
+		}
+		if (track.rotationActive)
+		{
+			FQuat rotation;
+			track.rotationActive = track.rotation.Evaluate(now, mode, SmoothingExtrapolationLimit, rotation);
+			track.actor->SetActorRelativeRotation(rotation);
+		}
+
+		if (!track.positionActive && !track.rotationActive)
+		{
+			track.active = false;
+			track.object->_smoothing = false;
+			activeSmoothingTracks.RemoveAtSwap(i, 1, false);
+		}
+	}
+}
+
+// Queues a scene object for the change check of the next tick
+void AVPETModule::HandleSceneObjectDirty(USceneObject* sceneObj)
+{
+	dirtySceneObjects.Add(sceneObj);
+}
+
+// Compares the dirty scene objects against their cached parameters, changed ones are broadcast
+// to HasChangedIsCalled. Locked objects and blended transforms stay in the list until released.
+// With BatchedChangeDetection all transforms, light colors and intensities are compared first
+void AVPETModule::CheckSceneObjects()
+{
+	if (PollSceneObjectProperties)
+	{
+		for (USceneObject* sceneObj : polledSceneObjects)
+			sceneObj->MarkDirty(false, true);
+	}
+
+	// the batch is filled in BeginPlay, the remaining light and camera properties still go through the dirty list
+	SceneObjectsChecked = sceneObjectBatch.Update(ParallelChangeDetection);
+	SceneObjectsChecked += dirtySceneObjects.Num();
+	for (int32 i = dirtySceneObjects.Num() - 1; i >= 0; i--)
+	{
+		if (!dirtySceneObjects[i]->CheckForChanges())
+			dirtySceneObjects.RemoveAtSwap(i, 1, false);
+	}
+}
+
+#if WITH_EDITOR
+void AVPETModule::HandleObjectPropertyChanged(UObject* object, FPropertyChangedEvent& event)
+{
+	if (!object)
+		return;
+	AActor* actor = Cast<AActor>(object);
+	if (!actor)
+		actor = object->GetTypedOuter<AActor>();
+	if (!actor)
+		return;
+	if (USceneObject* sceneObj = actor->FindComponentByClass<USceneObject>())
+		sceneObj->MarkDirty(false, true);
+}
+#endif // WITH_EDITOR
 
 // Called when the game ends
 void AVPETModule::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -464,6 +921,25 @@ void AVPETModule::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	DOL(LogBasic, Warning, "[VPET2 EndPlay] Game ended.");
 
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(propertyChangedHandle);
+#endif // WITH_EDITOR
+
+	// Stop the network threads, the sockets are closed once they no longer use them
+	if (sceneThread)
+	{
+		DOL(LogBasic, Warning, "[VPET2 Endplay] Stopping scene distribution thread...");
+		delete sceneThread;
+		sceneThread = nullptr;
+	}
+	if (networkThread)
+	{
+		DOL(LogBasic, Warning, "[VPET2 Endplay] Stopping network thread...");
+		DOL(LogBasic, Warning, "[VPET2 Endplay] Network thread woke %lld times, %.1f ms busy", (long long)networkThread->GetWakeUps(), networkThread->GetBusySeconds() * 1000.0);
+		delete networkThread;
+		networkThread = nullptr;
+	}
+
 	// Stop distribution thread
 	DOL(LogBasic, Warning, "[VPET2 Endplay] Closing Zmq distribution socket...");
 	if (socket_d)
@@ -472,16 +948,27 @@ void AVPETModule::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// Stop listener thread
 	DOL(LogBasic, Warning, "[VPET2 Endplay] Closing Zmq update receiver socket...");
+	if (sessionReplay)
+		sessionReplay->stop = true;
 	if (socket_r)
 		socket_r->close();
 	delete socket_r;
 
 	// Stop sender thread
 	DOL(LogBasic, Warning, "[VPET2 Endplay] Closing Zmq update sender socket...");
+	sendQueue.Close();
+	DOL(LogBasic, Warning, "[VPET2 Endplay] Sent %lld updates, enqueue to send latency: %s", (long long)sendQueue.GetSentCount(), UTF8_TO_TCHAR(sendQueue.LatencyToString().c_str()));
 	if (socket_s)
 		socket_s->close();
 	delete socket_s;
 
+	// The threads may still hold the recorder, appending to a closed log is a no-op
+	if (sessionRecorder)
+	{
+		sessionRecorder->close();
+		DOL(LogBasic, Warning, "[VPET2 Endplay] Session log closed, %lld messages recorded, %lld lost", (long long)sessionRecorder->recordCount(), (long long)sessionRecorder->failedCount());
+	}
+
 	DOL(LogBasic, Warning, "[VPET2 Endplay] Destroying Zmq context...");
 	if (context)
 		context->close();
@@ -793,7 +1280,7 @@ bool AVPETModule::buildLocation(AActor* prim)
 			obj->SetID(VPET_SceneObjectList.Num());
 			obj->SetcID(m_id);
 			VPET_SceneObjectList.Add(obj);
-			obj->SetSenderQueue(&msgData, &msgLen);
+			obj->SetSenderQueue(&sendQueue);
 
 			// Warn in case is not movable
 			if (!prim->IsRootComponentMovable())
@@ -832,7 +1319,7 @@ bool AVPETModule::buildLocation(AActor* prim)
 		obj->SetID(VPET_SceneObjectList.Num());
 		obj->SetcID(m_id);
 		VPET_SceneObjectList.Add(obj);
-		obj->SetSenderQueue(&msgData, &msgLen);
+		obj->SetSenderQueue(&sendQueue);
 	}
 
 	// Development counter hack - add sub group for counter-rotating children, if it has any
@@ -952,6 +1439,8 @@ void AVPETModule::buildNode(NodeGeo* node, AActor* prim)
 
 	if (node->geoId < 0)
 	{
+		ScopedPhaseTimer meshTimer(m_state.stats, PHASE_MESH);
+
 		// Create Package
 		ObjectPackage objPack;
 		objPack.instanceId = instanceID;
@@ -1028,6 +1517,7 @@ void AVPETModule::buildNode(NodeGeo* node, AActor* prim)
 
 
 	// Grab first material
+	ScopedPhaseTimer materialTimer(m_state.stats, PHASE_MATERIAL);
 	UMaterialInterface* cMat = staticMeshComponent->GetMaterial(0);
 
 	DOL(LogMaterial, Warning, "[DIST buildNode] num mat: %d", staticMeshComponent->GetNumMaterials());
@@ -1276,6 +1766,7 @@ void AVPETModule::buildNode(NodeGeo* node, AActor* prim)
 		// prepare texture if needed
 		if (prepTexture)
 		{
+			ScopedPhaseTimer textureTimer(m_state.stats, PHASE_TEXTURE);
 			DOL(LogMaterial, Log, "Preparing texture for %s", *matName);
 			TexturePackage texPack;
 
@@ -1438,43 +1929,24 @@ void AVPETModule::buildNode(NodeLight* node, AActor* prim, FString className)
 
 void AVPETModule::EncodeLockMessage(int16_t objID, bool lockState)
 {
-	// Prepare the byte array
-	char* responseMessageContent = NULL;
-	char* messageStart = NULL;
-	int responseLength = 7;
-	messageStart = responseMessageContent = (char*)malloc(responseLength);
-	// header
-	uint8_t intVal = m_id;
-	memcpy(responseMessageContent, (char*)&intVal, sizeof(uint8_t));
-	responseMessageContent += sizeof(uint8_t);
-	// time
-	intVal = m_time; 
-	memcpy(responseMessageContent, (char*)&intVal, sizeof(uint8_t));
-	responseMessageContent += sizeof(uint8_t);
-	// type lock
-	intVal = 1;
-	memcpy(responseMessageContent, (char*)&intVal, sizeof(uint8_t));
-	responseMessageContent += sizeof(uint8_t);
-	// Scene ID
-	intVal = m_id;
-	memcpy(responseMessageContent, (char*)&intVal, sizeof(uint8_t));
-	responseMessageContent += sizeof(uint8_t);
-	// object id - int 16
-	int16_t shortVal = objID;
-	memcpy(responseMessageContent, (char*)&shortVal, sizeof(uint16_t));
-	responseMessageContent += sizeof(uint16_t);
-	// true?
-	bool lockVal = lockState;
-	memcpy(responseMessageContent, (char*)&lockVal, sizeof(bool));
-	responseMessageContent += sizeof(bool);
-	
-	msgData.push_back(messageStart);
-	msgLen.push_back(responseLength);
+	VPET::Protocol::LockMessage lock;
+	lock.header.clientID = m_id;
+	lock.header.time = m_time;
+	lock.header.type = VPET::Protocol::MessageType::LOCK;
+	lock.sceneID = m_id;
+	lock.objectID = objID;
+	lock.locked = lockState;
+
+	UpdateFrame* frame = framePool.Acquire(VPET::Protocol::LOCK_MESSAGE_SIZE);
+	size_t responseLength = VPET::Protocol::encodeLock(reinterpret_cast<uint8_t*>(frame->data), frame->capacity, lock);
+	sendQueue.Push(frame, (int)responseLength);
 }
 
 void AVPETModule::DecodeLockMessage(int16_t* objID, bool* lockState)
 {
 	DOL(LogBasic, Log, "Lock message Id: %d %d", *objID, *lockState);
+	if (*objID <= 0 || *objID >= VPET_SceneObjectList.Num())
+		return;
 	USceneObject* sceneObj = VPET_SceneObjectList[*objID];
 	sceneObj->_lock = *lockState;
 }
\ No newline at end of file
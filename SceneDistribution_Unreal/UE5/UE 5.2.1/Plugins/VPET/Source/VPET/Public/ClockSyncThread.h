@@ -0,0 +1,67 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <zmq.hpp>
+#include "Async/AsyncWork.h"
+#include "ClockSync.h"
+#include "VPETProtocol.h"
+
+#include <string>
+
+// Development output log macro
+#define DOL(logType, logVerbosity, logString, ...) \
+if (logType) { \
+UE_LOG(LogTemp, logVerbosity, TEXT(logString), ##__VA_ARGS__); \
+}
+
+
+// Clock sync thread, pings the sync server and feeds the round trips to the clock.
+// Owns its socket and ends when the context is closed.
+class ClockSyncThread : public FNonAbandonableTask
+{
+	friend class FAutoDeleteAsyncTask<ClockSyncThread>;
+public:
+	zmq::context_t* context;
+	std::string endpoint;
+	ClockSync* clockSync;
+	uint8_t cID;
+	// Seconds between pings
+	float interval;
+	bool doLog;
+
+	using MessageType = VPET::Protocol::MessageType;
+
+	ClockSyncThread(zmq::context_t* pContext, std::string pEndpoint, ClockSync* pClockSync, uint8_t m_ID, float pInterval, bool pLog) :
+		context(pContext), endpoint(pEndpoint), clockSync(pClockSync), cID(m_ID), interval(pInterval), doLog(pLog) { }
+
+	void DoWork();
+
+	// Sets the options of the REQ socket and connects it to the endpoint
+	void OpenSocket(zmq::socket_t& socket);
+
+	// Sends the next ping, a still unanswered previous one is counted as timed out
+	void SendPing(zmq::socket_t& socket);
+
+	// Receives a waiting reply without blocking and feeds its round trip to the clock
+	bool HandleReply(zmq::socket_t& socket);
+
+	// Time sent of the last ping, FPlatformTime seconds
+	double sentSeconds = 0.0;
+
+	long GetIntervalMillis() const
+	{
+		return FMath::Max(1L, (long)(interval * 1000.0f));
+	}
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FGenericTask, STATGROUP_TaskGraphTasks);
+	}
+
+private:
+	uint8_t ping[VPET::Protocol::CONTROL_MESSAGE_SIZE];
+	zmq::message_t reply;
+	bool awaitingReply = false;
+
+};
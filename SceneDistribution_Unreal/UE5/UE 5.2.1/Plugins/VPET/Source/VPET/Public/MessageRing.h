@@ -0,0 +1,80 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free ring between exactly one producer and one consumer thread.
+// Slots are allocated once and reused, the producer may fill a slot and only
+// publish it if it wants to keep the content.
+template <typename SlotType, size_t Capacity>
+class TMessageRing
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	TMessageRing() : WriteIndex(0), ReadIndex(0), Overflows(0) { }
+
+	// Producer: slot to fill, nullptr if the ring is full
+	SlotType* BeginWrite()
+	{
+		const size_t write = WriteIndex.load(std::memory_order_relaxed);
+		if (write - ReadIndex.load(std::memory_order_acquire) >= Capacity)
+			return nullptr;
+		return &Slots[write & (Capacity - 1)];
+	}
+
+	// Producer: publish the slot returned by BeginWrite
+	void CommitWrite()
+	{
+		WriteIndex.store(WriteIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Producer: a message was dropped because the ring was full
+	void CountOverflow()
+	{
+		Overflows.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Consumer: oldest published slot, nullptr if the ring is empty
+	SlotType* Peek()
+	{
+		const size_t read = ReadIndex.load(std::memory_order_relaxed);
+		if (read == WriteIndex.load(std::memory_order_acquire))
+			return nullptr;
+		return &Slots[read & (Capacity - 1)];
+	}
+
+	// Consumer: hand the slot returned by Peek back to the producer
+	void Pop()
+	{
+		ReadIndex.store(ReadIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Only while neither side is running
+	void Reset()
+	{
+		WriteIndex.store(0, std::memory_order_relaxed);
+		ReadIndex.store(0, std::memory_order_relaxed);
+	}
+
+	size_t Num() const
+	{
+		return WriteIndex.load(std::memory_order_acquire) - ReadIndex.load(std::memory_order_acquire);
+	}
+
+	uint64_t GetOverflowCount() const
+	{
+		return Overflows.load(std::memory_order_relaxed);
+	}
+
+private:
+	SlotType Slots[Capacity];
+
+	// Separate cache lines, each index is written by one side only
+	alignas(64) std::atomic<size_t> WriteIndex;
+	alignas(64) std::atomic<size_t> ReadIndex;
+	std::atomic<uint64_t> Overflows;
+};
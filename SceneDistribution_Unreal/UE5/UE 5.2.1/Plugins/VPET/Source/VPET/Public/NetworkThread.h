@@ -0,0 +1,94 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <zmq.hpp>
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "UpdateReceiverThread.h"
+#include "UpdateSenderThread.h"
+#include "ClockSyncThread.h"
+#include "UpdateSendQueue.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Development output log macro
+#define DOL(logType, logVerbosity, logString, ...) \
+if (logType) { \
+UE_LOG(LogTemp, logVerbosity, TEXT(logString), ##__VA_ARGS__); \
+}
+
+
+// Network thread, receives and sends the updates and pings the sync server in one zmq poll loop
+// instead of a blocking pool task per socket. The task classes handle their socket for it, the
+// distribution socket has its own SceneDistributionThread so scene replies do not delay updates. Every push to the send queue wakes the loop through an inproc socket.
+// The module sockets are only used by this thread while it runs and closed by the module after it stopped.
+class NetworkThread : public FRunnable
+{
+public:
+	// Takes ownership of the handlers, receiver (replayed session) and pinger (no clock sync) are optional
+	NetworkThread(zmq::context_t* pContext, UpdateSendQueue* pSendQueue, int pSendTimeout, bool pLog,
+		UpdateReceiverThread* pReceiver, UpdateSenderThread* pSender, ClockSyncThread* pPinger);
+
+	// Stops and waits for the thread
+	virtual ~NetworkThread();
+
+	bool Start();
+
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+	// Loop iterations and the time spent handling them, for comparison with the task per socket
+	int64 GetWakeUps() const { return wakeUps.load(std::memory_order_relaxed); }
+	double GetBusySeconds() const { return FPlatformTime::ToSeconds64(busyCycles.load(std::memory_order_relaxed)); }
+
+private:
+	// Any thread, at most one wake up message is in flight
+	void WakeUp();
+
+	// Moves the queued messages behind the blocked ones
+	bool TakeOutbound();
+
+	// Sends until the publisher is at its high-water mark, a message blocked there
+	// for longer than the send timeout is dropped. False once the socket is closed.
+	bool FlushOutbound();
+
+	struct Outbound
+	{
+		UpdateSendQueue::Entry entry;
+		zmq::message_t message;
+	};
+
+	zmq::context_t* context;
+	UpdateSendQueue* sendQueue;
+	// Milliseconds
+	int sendTimeout;
+	bool doLog;
+
+	std::unique_ptr<UpdateReceiverThread> receiver;
+	std::unique_ptr<UpdateSenderThread> sender;
+	std::unique_ptr<ClockSyncThread> pinger;
+
+	FRunnableThread* thread = nullptr;
+	std::atomic<bool> stopping{ false };
+
+	// Sending end of the wake up pair, pushes come from the game thread and the receiver handler
+	zmq::socket_t wakeSender;
+	std::string wakeEndpoint;
+	std::mutex wakeMutex;
+	std::atomic<bool> wakePending{ false };
+
+	// Messages taken from the queue, the front one is retried while the publisher is blocked
+	std::vector<UpdateSendQueue::Entry> taken;
+	std::deque<Outbound> outbound;
+	bool blocked = false;
+	double blockedSince = 0.0;
+
+	std::atomic<int64> wakeUps{ 0 };
+	std::atomic<uint64> busyCycles{ 0 };
+};
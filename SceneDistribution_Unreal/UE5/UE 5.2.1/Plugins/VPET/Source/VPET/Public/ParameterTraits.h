@@ -0,0 +1,247 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#include "CoreMinimal.h"
+#include "ByteSpan.h"
+#include "VPETProtocol.h"
+
+// Wire format of the VPET parameter types, one specialization per supported value type.
+// Type is the VPET type id, WireSize the encoded size in bytes (-1 if it depends on the value).
+template <class T>
+struct VpetTypeTraits;
+
+namespace VpetWire
+{
+    inline char* WriteFloat(char* data, double value)
+    {
+        const float f = static_cast<float>(value);
+        std::memcpy(data, &f, sizeof(float));
+        return data + sizeof(float);
+    }
+
+    inline bool ReadFloats(const ByteSpan& data, float* out, int count)
+    {
+        for (int i = 0; i < count; i++)
+            if (!data.Read(i * sizeof(float), out[i]))
+                return false;
+        return true;
+    }
+}
+
+template <>
+struct VpetTypeTraits<TFunction<void()>>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::ACTION;
+    static constexpr int WireSize = 0;
+    static int Size(const TFunction<void()>&) { return WireSize; }
+    static void Encode(const TFunction<void()>&, char*) { }
+    static bool Decode(const ByteSpan&, TFunction<void()>&) { return true; }
+};
+
+template <>
+struct VpetTypeTraits<bool>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::BOOL;
+    static constexpr int WireSize = 1;
+    static int Size(const bool&) { return WireSize; }
+    static void Encode(const bool& value, char* data) { *data = value ? 1 : 0; }
+    static bool Decode(const ByteSpan& data, bool& value)
+    {
+        uint8_t b;
+        if (!data.Read(0, b))
+            return false;
+        value = b != 0;
+        return true;
+    }
+};
+
+template <>
+struct VpetTypeTraits<int32>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::INT;
+    static constexpr int WireSize = 4;
+    static int Size(const int32&) { return WireSize; }
+    static void Encode(const int32& value, char* data) { std::memcpy(data, &value, sizeof(int32)); }
+    static bool Decode(const ByteSpan& data, int32& value) { return data.Read(0, value); }
+};
+
+template <>
+struct VpetTypeTraits<float>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::FLOAT;
+    static constexpr int WireSize = 4;
+    static int Size(const float&) { return WireSize; }
+    static void Encode(const float& value, char* data) { std::memcpy(data, &value, sizeof(float)); }
+    static bool Decode(const ByteSpan& data, float& value) { return data.Read(0, value); }
+};
+
+template <>
+struct VpetTypeTraits<FVector2D>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::VECTOR2;
+    static constexpr int WireSize = 8;
+    static int Size(const FVector2D&) { return WireSize; }
+    static void Encode(const FVector2D& value, char* data)
+    {
+        data = VpetWire::WriteFloat(data, value.X);
+        VpetWire::WriteFloat(data, value.Y);
+    }
+    static bool Decode(const ByteSpan& data, FVector2D& value)
+    {
+        float f[2];
+        if (!VpetWire::ReadFloats(data, f, 2))
+            return false;
+        value = FVector2D(f[0], f[1]);
+        return true;
+    }
+};
+
+// Y and Z are swapped between Unreal and VPET
+template <>
+struct VpetTypeTraits<FVector>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::VECTOR3;
+    static constexpr int WireSize = 12;
+    static int Size(const FVector&) { return WireSize; }
+    static void Encode(const FVector& value, char* data)
+    {
+        data = VpetWire::WriteFloat(data, value.X);
+        data = VpetWire::WriteFloat(data, value.Z);
+        VpetWire::WriteFloat(data, value.Y);
+    }
+    static bool Decode(const ByteSpan& data, FVector& value)
+    {
+        float f[3];
+        if (!VpetWire::ReadFloats(data, f, 3))
+            return false;
+        value = FVector(f[0], f[2], f[1]);
+        return true;
+    }
+};
+
+template <>
+struct VpetTypeTraits<FVector4>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::VECTOR4;
+    static constexpr int WireSize = 16;
+    static int Size(const FVector4&) { return WireSize; }
+    static void Encode(const FVector4& value, char* data)
+    {
+        data = VpetWire::WriteFloat(data, value.X);
+        data = VpetWire::WriteFloat(data, value.Y);
+        data = VpetWire::WriteFloat(data, value.Z);
+        VpetWire::WriteFloat(data, value.W);
+    }
+    static bool Decode(const ByteSpan& data, FVector4& value)
+    {
+        float f[4];
+        if (!VpetWire::ReadFloats(data, f, 4))
+            return false;
+        value = FVector4(f[0], f[1], f[2], f[3]);
+        return true;
+    }
+};
+
+// Handedness change, X is negated and Y and Z are swapped
+template <>
+struct VpetTypeTraits<FQuat>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::QUATERNION;
+    static constexpr int WireSize = 16;
+    static int Size(const FQuat&) { return WireSize; }
+    static void Encode(const FQuat& value, char* data)
+    {
+        data = VpetWire::WriteFloat(data, -value.X);
+        data = VpetWire::WriteFloat(data, value.Z);
+        data = VpetWire::WriteFloat(data, value.Y);
+        VpetWire::WriteFloat(data, value.W);
+    }
+    static bool Decode(const ByteSpan& data, FQuat& value)
+    {
+        float f[4];
+        if (!VpetWire::ReadFloats(data, f, 4))
+            return false;
+        value = FQuat(-f[0], f[2], f[1], f[3]);
+        return true;
+    }
+};
+
+// Channels are sent as floats in the 0-255 range of FColor
+template <>
+struct VpetTypeTraits<FColor>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::COLOR;
+    static constexpr int WireSize = 16;
+    static int Size(const FColor&) { return WireSize; }
+    static void Encode(const FColor& value, char* data)
+    {
+        data = VpetWire::WriteFloat(data, value.R);
+        data = VpetWire::WriteFloat(data, value.G);
+        data = VpetWire::WriteFloat(data, value.B);
+        VpetWire::WriteFloat(data, value.A);
+    }
+    static bool Decode(const ByteSpan& data, FColor& value)
+    {
+        float f[4];
+        if (!VpetWire::ReadFloats(data, f, 4))
+            return false;
+        value = FColor((uint8)FMath::Clamp(f[0], 0.f, 255.f), (uint8)FMath::Clamp(f[1], 0.f, 255.f), (uint8)FMath::Clamp(f[2], 0.f, 255.f), (uint8)FMath::Clamp(f[3], 0.f, 255.f));
+        return true;
+    }
+};
+
+// Strings are sent as their characters without terminator
+template <>
+struct VpetTypeTraits<std::string>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::STRING;
+    static constexpr int WireSize = -1;
+    static int Size(const std::string& value) { return static_cast<int>(value.size()); }
+    static void Encode(const std::string& value, char* data) { std::memcpy(data, value.data(), value.size()); }
+    static bool Decode(const ByteSpan& data, std::string& value)
+    {
+        value.assign(reinterpret_cast<const char*>(data.Data()), data.Size());
+        return true;
+    }
+};
+
+// UTF-8 on the wire
+template <>
+struct VpetTypeTraits<FString>
+{
+    static constexpr VPET::Protocol::ParameterType Type = VPET::Protocol::ParameterType::STRING;
+    static constexpr int WireSize = -1;
+    static int Size(const FString& value) { return FTCHARToUTF8(*value).Length(); }
+    static void Encode(const FString& value, char* data)
+    {
+        FTCHARToUTF8 utf8(*value);
+        std::memcpy(data, utf8.Get(), utf8.Length());
+    }
+    static bool Decode(const ByteSpan& data, FString& value)
+    {
+        value = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(data.Data()), data.Size()));
+        return true;
+    }
+};
+
+namespace VpetWire
+{
+    // Positions are sent in meters and X is mirrored, on top of the FVector axis swap
+    inline void EncodePosition(const FVector& value, char* data)
+    {
+        VpetTypeTraits<FVector>::Encode(FVector(value.X * -0.01, value.Y * 0.01, value.Z * 0.01), data);
+    }
+
+    inline bool DecodePosition(const ByteSpan& data, FVector& value)
+    {
+        FVector meters;
+        if (!VpetTypeTraits<FVector>::Decode(data, meters))
+            return false;
+        value = FVector(-meters.X, meters.Y, meters.Z) * 100.0;
+        return true;
+    }
+}
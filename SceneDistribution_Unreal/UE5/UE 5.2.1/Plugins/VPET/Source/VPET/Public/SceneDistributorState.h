@@ -5,12 +5,11 @@ Copyright (c) 2020 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
 
 #include <vector>
 #include "VPETModule.h"
+#include "SceneDistributorStats.h"
 
 namespace VPET
 {
 	enum LodMode { ALL, TAG }; // is needed?
-	enum NodeType { GROUP, GEO, LIGHT, CAMERA, SKINNEDMESH };
-	enum LightType { SPOT, DIRECTIONAL, POINT, AREA, RECTANGLE, DISC, NONE };
 
 	struct Node
 	{
@@ -140,6 +139,9 @@ namespace VPET
 		int numLights;
 		int numCameras;
 		int numObjectNodes;
+
+		// Build and request instrumentation
+		DistributorStats stats;
 	};
 
 	// struct sizes 
@@ -26,8 +26,9 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// Compares the camera parameters, polled by the module
+	virtual void CheckProperties() override;
+	virtual bool HasPolledProperties() const override { return kCamComp != NULL; }
 
 	ACameraActor* kCam = NULL;
 	UCameraComponent* kCamComp = NULL;
@@ -15,7 +15,4 @@ class VPET_API USceneObjectDirectionalLight : public USceneObjectLight
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
-
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 };
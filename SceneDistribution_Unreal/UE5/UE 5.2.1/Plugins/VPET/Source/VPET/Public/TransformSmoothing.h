@@ -0,0 +1,99 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SceneObject.h"
+
+// Blend between two samples, alpha above 1 continues the motion past b
+inline FVector BlendTransformSamples(const FVector& a, const FVector& b, double alpha)
+{
+	return a + (b - a) * alpha;
+}
+
+inline FQuat BlendTransformSamples(const FQuat& a, const FQuat& b, double alpha)
+{
+	if (alpha <= 1.0)
+		return FQuat::Slerp(a, b, alpha);
+
+	// continue the rotation from a to b around the same axis
+	FQuat delta = b * a.Inverse();
+	delta.EnforceShortestArcWith(FQuat::Identity);
+	FVector axis;
+	FQuat::FReal angle;
+	delta.ToAxisAndAngle(axis, angle);
+	return FQuat(axis, angle * (alpha - 1.0)) * b;
+}
+
+// The last two received samples of a transform value with their arrival time in seconds
+template <typename T>
+struct TTransformSamples
+{
+	T values[2];
+	double times[2] = { 0.0, 0.0 };
+	int count = 0;
+
+	// A sample arriving more than maxInterval after the previous one starts a new motion
+	void Push(const T& value, double time, double maxInterval)
+	{
+		if (count > 0 && time - times[1] <= maxInterval)
+		{
+			values[0] = values[1];
+			times[0] = times[1];
+			count = 2;
+		}
+		else
+			count = 1;
+		values[1] = value;
+		times[1] = time;
+	}
+
+	// Value to display at now, false once the latest sample is shown and nothing is left to blend.
+	// Interpolate runs one sample interval behind the samples, Extrapolate continues the motion
+	// for at most extrapolationLimit seconds and then returns to the latest sample in the same time.
+	bool Evaluate(double now, EVpetTransformSmoothing mode, double extrapolationLimit, T& out) const
+	{
+		if (count < 2 || mode == EVpetTransformSmoothing::None)
+		{
+			out = values[1];
+			return false;
+		}
+
+		const double interval = FMath::Max(times[1] - times[0], 0.001);
+		const double elapsed = now - times[1];
+
+		if (mode == EVpetTransformSmoothing::Interpolate)
+		{
+			const double alpha = elapsed / interval;
+			if (alpha >= 1.0)
+			{
+				out = values[1];
+				return false;
+			}
+			out = BlendTransformSamples(values[0], values[1], FMath::Max(alpha, 0.0));
+			return true;
+		}
+
+		if (elapsed >= 2.0 * extrapolationLimit)
+		{
+			out = values[1];
+			return false;
+		}
+		const double ahead = elapsed <= extrapolationLimit ? elapsed : 2.0 * extrapolationLimit - elapsed;
+		out = BlendTransformSamples(values[0], values[1], 1.0 + FMath::Max(ahead, 0.0) / interval);
+		return true;
+	}
+};
+
+// Smoothing state of one remotely edited scene object, driven by the module for all objects at once
+struct FTransformSmoothingTrack
+{
+	USceneObject* object = nullptr;
+	AActor* actor = nullptr;
+	TTransformSamples<FVector> position;
+	TTransformSamples<FQuat> rotation;
+	bool positionActive = false;
+	bool rotationActive = false;
+	// listed in the active tracks of the module
+	bool active = false;
+};
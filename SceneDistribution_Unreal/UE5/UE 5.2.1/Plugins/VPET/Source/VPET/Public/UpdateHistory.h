@@ -0,0 +1,66 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// Copies of the last sent sequenced updates, indexed by their sequence number, to answer
+// resend requests. Written by the game thread, read by the receiver thread.
+template <size_t Capacity>
+class TUpdateHistory
+{
+	static_assert(Capacity > 0 && Capacity <= 65536 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two of at most 65536");
+
+public:
+	// Entries keep their buffer, a full ring does not allocate
+	void Store(uint16_t sequence, const void* data, size_t size)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		Entry& entry = entries[sequence & (Capacity - 1)];
+		entry.sequence = sequence;
+		entry.valid = true;
+		entry.bytes.resize(size);
+		if (size > 0)
+			std::memcpy(entry.bytes.data(), data, size);
+	}
+
+	// Calls func(data, size) for every update of the range still in the history, returns their count
+	template <typename Func>
+	int ForEach(uint16_t first, int count, Func&& func)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		int found = 0;
+		for (int i = 0; i < count; i++)
+		{
+			const uint16_t sequence = static_cast<uint16_t>(first + i);
+			const Entry& entry = entries[sequence & (Capacity - 1)];
+			if (!entry.valid || entry.sequence != sequence)
+				continue;
+			func(entry.bytes.data(), entry.bytes.size());
+			found++;
+		}
+		return found;
+	}
+
+	void Reset()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		for (Entry& entry : entries)
+			entry.valid = false;
+	}
+
+private:
+	struct Entry
+	{
+		uint16_t sequence = 0;
+		bool valid = false;
+		std::vector<uint8_t> bytes;
+	};
+
+	std::mutex mtx;
+	Entry entries[Capacity];
+};
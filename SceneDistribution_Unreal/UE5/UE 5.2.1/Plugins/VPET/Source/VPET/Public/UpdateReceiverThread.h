@@ -5,6 +5,11 @@
 #include <zmq.hpp>
 #include "Async/AsyncWork.h"
 #include "VPETModule.h"
+#include "MessageRing.h"
+#include "VPETProtocol.h"
+#include "SessionLog.h"
+
+#include <memory>
 
 // Development output log macro
 #define DOL(logType, logVerbosity, logString, ...) if(logType) UE_LOG(LogTemp, logVerbosity, TEXT(logString), __VA_ARGS__);
@@ -19,22 +24,44 @@ class UpdateReceiverThread : public FNonAbandonableTask
 	friend class FAutoDeleteAsyncTask<UpdateReceiverThread>;
 public:
 	zmq::socket_t* socket;
-	std::vector<std::vector<uint8_t>>* msgQ;
+	TMessageRing<zmq::message_t, 1024>* msgQ;
 	bool doLog;
 	uint8_t cID;
 	AVPETModule* manager;
+	// Receives the SYNC messages of the server
+	ClockSync* clockSync;
+	// Optional, every received message is appended
+	std::shared_ptr<VPET::Protocol::SessionLogWriter> recorder;
+	// Optional, replaces the socket as message source
+	std::shared_ptr<SessionReplay> replay;
 
-	enum class MessageType
-	{
-		PARAMETERUPDATE, LOCK, // node
-		SYNC, PING, RESENDUPDATE, // sync
-		UNDOREDOADD, RESETOBJECT // undo redo
-	};
+	using MessageType = VPET::Protocol::MessageType;
 
-	UpdateReceiverThread(zmq::socket_t* pSocket, std::vector<std::vector<uint8_t>>* pQueue, uint8_t m_ID, bool pLog, AVPETModule* pMod) : socket(pSocket), msgQ(pQueue), cID(m_ID), doLog(pLog), manager(pMod) { }
+	UpdateReceiverThread(zmq::socket_t* pSocket, TMessageRing<zmq::message_t, 1024>* pQueue, uint8_t m_ID, bool pLog, AVPETModule* pMod, ClockSync* pClockSync,
+		std::shared_ptr<VPET::Protocol::SessionLogWriter> pRecorder = nullptr, std::shared_ptr<SessionReplay> pReplay = nullptr) :
+		socket(pSocket), msgQ(pQueue), cID(m_ID), doLog(pLog), manager(pMod), clockSync(pClockSync), recorder(pRecorder), replay(pReplay) { }
 
 	void DoWork();
 
+	// Receives and handles all messages waiting on the socket, false once the socket is closed
+	bool ReceivePending();
+
+private:
+	// Receives here while the queue is full, the message gets dropped
+	zmq::message_t overflowMessage;
+
+	void Dispatch(zmq::message_t* slot, zmq::message_t* message, double received);
+
+	// Replay clock start, FPlatformTime seconds
+	double replayStart = 0.0;
+
+	bool NextReplayMessage(zmq::message_t* message);
+
+	// Received sequence numbers by sender client ID
+	VPET::Protocol::SequenceTracker senderSequences[256];
+
+	bool CheckSequence(const VPET::Protocol::Header& header);
+
 	FORCEINLINE TStatId GetStatId() const
 	{
 		RETURN_QUICK_DECLARE_CYCLE_STAT(FGenericTask, STATGROUP_TaskGraphTasks);
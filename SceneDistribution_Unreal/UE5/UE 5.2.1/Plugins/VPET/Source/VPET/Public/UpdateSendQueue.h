@@ -0,0 +1,174 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "UpdateFramePool.h"
+
+// Outgoing update queue, filled by the game thread and drained by the update sender thread.
+// Push wakes the sender right away, the sender takes all pending messages with one swap.
+// The backlog counts messages pushed but neither sent nor dropped yet, it lets the game
+// thread hold back new updates while the socket is at its high-water mark.
+class UpdateSendQueue
+{
+public:
+	// Frames come from an UpdateFramePool, the queue owns them until sent
+	struct Entry
+	{
+		UpdateFrame* frame;
+		int length;
+		std::chrono::steady_clock::time_point enqueued;
+	};
+
+	// Enqueue to send latency buckets, bucket n counts latencies below 2^n microseconds
+	static const int LATENCY_BUCKETS = 24;
+
+	UpdateSendQueue() : closed(false), backlog(0), sentCount(0), droppedCount(0)
+	{
+		for (int i = 0; i < LATENCY_BUCKETS; i++)
+			latency[i] = 0;
+	}
+
+	~UpdateSendQueue()
+	{
+		Reset();
+	}
+
+	void Push(UpdateFrame* frame, int length)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			pending.push_back({ frame, length, std::chrono::steady_clock::now() });
+		}
+		backlog.fetch_add(1, std::memory_order_relaxed);
+		wakeUp.notify_one();
+		if (onPush)
+			onPush();
+	}
+
+	// Called after every push, for a sender that waits on something else than the queue.
+	// Only while no thread pushes.
+	void SetOnPush(std::function<void()> callback)
+	{
+		onPush = std::move(callback);
+	}
+
+	// Takes the pending messages without waiting, returns false once closed
+	bool TryTake(std::vector<Entry>& out)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		if (closed)
+			return false;
+		out.swap(pending);
+		return true;
+	}
+
+	// Blocks until messages are queued, the queue got closed or the timeout passed.
+	// Returns false once closed, out receives the pending messages in queue order.
+	bool WaitAndTake(std::vector<Entry>& out, std::chrono::milliseconds timeout)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		wakeUp.wait_for(lock, timeout, [this] { return closed || !pending.empty(); });
+		if (closed)
+			return false;
+		out.swap(pending);
+		return true;
+	}
+
+	// Wakes and stops the sender, queued messages are discarded
+	void Close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			closed = true;
+		}
+		wakeUp.notify_all();
+	}
+
+	// Only while no sender thread is running
+	void Reset()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		for (Entry& entry : pending)
+			entry.frame->pool->Release(entry.frame);
+		pending.clear();
+		closed = false;
+		backlog = 0;
+		droppedCount = 0;
+	}
+
+	void RecordSent(const Entry& entry)
+	{
+		const int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - entry.enqueued).count();
+		int bucket = 0;
+		while (bucket < LATENCY_BUCKETS - 1 && (int64_t(1) << bucket) <= micros)
+			bucket++;
+		latency[bucket].fetch_add(1, std::memory_order_relaxed);
+		sentCount.fetch_add(1, std::memory_order_relaxed);
+		backlog.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	// The socket did not take the message in time, its frame is released by zmq
+	void RecordDropped(const Entry&)
+	{
+		droppedCount.fetch_add(1, std::memory_order_relaxed);
+		backlog.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	// Releases a taken message that will not be sent, the sender is shutting down
+	void Discard(Entry& entry)
+	{
+		entry.frame->pool->Release(entry.frame);
+		backlog.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	int GetBacklog() const
+	{
+		return backlog.load(std::memory_order_relaxed);
+	}
+
+	int64_t GetSentCount() const
+	{
+		return sentCount.load(std::memory_order_relaxed);
+	}
+
+	int64_t GetDroppedCount() const
+	{
+		return droppedCount.load(std::memory_order_relaxed);
+	}
+
+	// Non empty buckets as "<upper bound us>:count" pairs
+	std::string LatencyToString() const
+	{
+		std::ostringstream s;
+		for (int i = 0; i < LATENCY_BUCKETS; i++)
+		{
+			const int64_t count = latency[i].load(std::memory_order_relaxed);
+			if (count > 0)
+				s << "<" << (int64_t(1) << i) << "us:" << count << " ";
+		}
+		return s.str();
+	}
+
+private:
+	std::mutex mtx;
+	std::condition_variable wakeUp;
+	std::function<void()> onPush;
+	std::vector<Entry> pending;
+	bool closed;
+	std::atomic<int> backlog;
+
+	std::atomic<int64_t> latency[LATENCY_BUCKETS];
+	std::atomic<int64_t> sentCount;
+	std::atomic<int64_t> droppedCount;
+};
@@ -4,6 +4,11 @@
 
 #include <zmq.hpp>
 #include "Async/AsyncWork.h"
+#include "UpdateSendQueue.h"
+#include "VPETProtocol.h"
+#include "SessionLog.h"
+
+#include <memory>
 
 // Development output log macro
 #define DOL(logType, logVerbosity, logString, ...) if(logType) UE_LOG(LogTemp, logVerbosity, TEXT(logString), __VA_ARGS__);
@@ -18,23 +23,22 @@ class UpdateSenderThread : public FNonAbandonableTask
 	friend class FAutoDeleteAsyncTask<UpdateSenderThread>;
 public:
 	zmq::socket_t* socket;
-	std::vector<std::vector<uint8_t>>* msgQ;
-	std::vector<char*>* msgData;
-	std::vector<int>* msgLen;
+	UpdateSendQueue* sendQueue;
 	bool doLog;
 	uint8_t cID;
+	// Optional, every sent message is appended
+	std::shared_ptr<VPET::Protocol::SessionLogWriter> recorder;
 
-	enum class MessageType
-	{
-		PARAMETERUPDATE, LOCK, // node
-		SYNC, PING, RESENDUPDATE, // sync
-		UNDOREDOADD, RESETOBJECT // undo redo
-	};
+	using MessageType = VPET::Protocol::MessageType;
 
-	UpdateSenderThread(zmq::socket_t* pSocket, std::vector<std::vector<uint8_t>>* pQueue, uint8_t m_ID, bool pLog, std::vector<char*>* pData, std::vector<int>* pLen) : socket(pSocket), msgQ(pQueue), cID(m_ID), doLog(pLog), msgData(pData), msgLen(pLen) { }
+	UpdateSenderThread(zmq::socket_t* pSocket, UpdateSendQueue* pQueue, uint8_t m_ID, bool pLog, std::shared_ptr<VPET::Protocol::SessionLogWriter> pRecorder = nullptr) :
+		socket(pSocket), sendQueue(pQueue), cID(m_ID), doLog(pLog), recorder(pRecorder) { }
 
 	void DoWork();
 
+	// Records the queued message to the session log and wraps its frame into message without a copy
+	void Prepare(const UpdateSendQueue::Entry& entry, zmq::message_t& message);
+
 	FORCEINLINE TStatId GetStatId() const
 	{
 		RETURN_QUICK_DECLARE_CYCLE_STAT(FGenericTask, STATGROUP_TaskGraphTasks);
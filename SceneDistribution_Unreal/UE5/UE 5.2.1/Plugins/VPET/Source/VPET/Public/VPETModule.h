@@ -5,7 +5,15 @@
 #define DEG2RAD (3.14159265/180.0)
 
 #include <zmq.hpp>
+#include <atomic>
 #include "SceneDistributorState.h"
+#include "MessageRing.h"
+#include "UpdateJitterBuffer.h"
+#include "ClockSync.h"
+#include "UpdateHistory.h"
+#include "TransformSmoothing.h"
+#include "SceneObjectBatch.h"
+#include "VPETProtocol.h"
 #include "EngineUtils.h" // for TActorIterator
 #include "Kismet/KismetMathLibrary.h" // for UKismetMathLibrary::MakeRelativeTransform
 
@@ -13,6 +21,9 @@
 #include "SceneSenderThread.h"
 #include "UpdateReceiverThread.h"
 #include "UpdateSenderThread.h"
+#include "ClockSyncThread.h"
+class NetworkThread;
+class SceneDistributionThread;
 
 // for casting tests
 #include "Materials/MaterialExpressionConstant3Vector.h"
@@ -83,6 +94,8 @@ public:
 	FTimerHandle MemberTimerHandle;
 	int s_timestepsBase = 128;
 	int framerate = 60;
+	// steps an update may be stamped ahead of the jitter buffer delay, covers clocks running slightly apart
+	int s_jitterBufferSlack = 2;
 	uint8_t m_timesteps;
 	uint8_t m_time;
 
@@ -143,6 +156,161 @@ public:
 	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Development|Logging")
 		bool LogGeoBuild;
 
+	// Record all received and sent update messages to a session log
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Development|Session Log")
+		bool RecordSession;
+	// Folder of the recorded session logs, Saved/VPET if empty
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Development|Session Log")
+		FString SessionLogDirectory;
+	// Session log to replay instead of receiving updates from the sync server
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Development|Session Log")
+		FString ReplaySessionLog;
+	// Replay speed as multiple of the recorded speed, 0 replays as fast as possible
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Development|Session Log")
+		float ReplaySpeed;
+
+	// Follow the clock of the sync server, measured by pings and its SYNC messages
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Synchronization")
+		bool SyncClockToServer;
+	// Seconds between pings to the sync server
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Synchronization", meta = (ClampMin = "0.05"))
+		float PingInterval;
+
+	// Number the sent parameter updates so receivers can detect losses and ask for a resend.
+	// Clients without sequence support ignore sequenced updates, only enable it if all clients understand them
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Synchronization")
+		bool SequenceUpdates;
+
+	// Time steps received updates are held back before they are applied, evens out uneven arrival; 0 applies them right away
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Synchronization", meta = (ClampMin = "0", ClampMax = "30"))
+		int32 JitterBufferDelay;
+	// Seconds the motion of remote edits is continued past the latest sample by objects smoothed with Extrapolate
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Synchronization", meta = (ClampMin = "0"))
+		float SmoothingExtrapolationLimit;
+	// Samples further apart in seconds are not blended, the object snaps to the new sample
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Synchronization", meta = (ClampMin = "0"))
+		float SmoothingMaxSampleInterval;
+	// Light and camera properties have no change notification at runtime, enable to check them every
+	// tick when Blueprints or Sequencer animate them. Off by default, edits in the details panel are
+	// still sent through the property changed hook and transforms are always notified
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Synchronization")
+		bool PollSceneObjectProperties;
+	// Compare the transforms, light colors and intensities of all scene objects every tick in one
+	// pass over packed copies, instead of checking the objects flagged by the change notifications
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Synchronization")
+		bool BatchedChangeDetection;
+	// Spread the batched compare over the worker threads
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Synchronization", meta = (EditCondition = "BatchedChangeDetection"))
+		bool ParallelChangeDetection;
+
+	// Serve the update and ping sockets from one network thread with a poll loop and the distribution
+	// socket from its own thread, otherwise every socket blocks a task of the engine thread pool
+	// (the previous design, kept for comparison)
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network")
+		bool SingleNetworkThread;
+	// Messages queued per connection for sending before the socket stops taking more
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network", meta = (ClampMin = "1"))
+		int32 SendHighWaterMark;
+	// Messages queued per connection on receiving before further ones are dropped by zeroMQ
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network", meta = (ClampMin = "1"))
+		int32 ReceiveHighWaterMark;
+	// Milliseconds an update waits at the send high-water mark before it is dropped
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network", meta = (ClampMin = "0"))
+		int32 SendTimeout;
+	// Milliseconds unsent messages are kept for delivery when a socket is closed
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network", meta = (ClampMin = "0"))
+		int32 SocketLinger;
+	// Detect dead connections (tablets leaving the network) with TCP keepalive probes
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network")
+		bool TcpKeepAlive;
+	// Idle seconds before the first keepalive probe and seconds between probes
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network", meta = (ClampMin = "1"))
+		int32 TcpKeepAliveIdle;
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network", meta = (ClampMin = "1"))
+		int32 TcpKeepAliveInterval;
+	// Hold back parameter messages while earlier ones are still waiting to be sent, the
+	// modified parameters are sent with their latest values once the socket has caught up
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network")
+		bool LatestStateUpdates;
+	// Keep only the newest received message (zeroMQ conflate). Also drops lock and sync
+	// messages, only for sync servers that publish nothing but transform updates
+	UPROPERTY(EditAnywhere, Category = "VPET2 Settings|Network")
+		bool ConflateReceivedUpdates;
+
+	// Parameter updates received from the sync server
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesReceived;
+	// Parameter updates applied to the scene, at most one per parameter and tick
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesApplied;
+	// Parameter updates replaced by a newer value within the same tick
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesCoalesced;
+	// Parameter updates that arrived after their time step had been played out
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesLate;
+	// Parameter updates stamped too far ahead of the local time to be buffered
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesEarly;
+	// Smoothed round trip time to the sync server in milliseconds
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		float ClockRoundTripMs;
+	// Lowest of the recent round trips in milliseconds
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		float ClockRoundTripMinMs;
+	// Round trip variation in milliseconds
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		float ClockJitterMs;
+	// Time steps the local clock still has to be slewed towards the server
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		float ClockOffsetSteps;
+	// Answered pings and unanswered ones
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 ClockPings;
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 ClockPingTimeouts;
+	// SYNC messages of the server used for the clock
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 ClockSyncs;
+	// Offsets too large to slew, the clock was set at once
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 ClockJumps;
+	// Sequenced updates found missing, a resend is requested for them
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesMissed;
+	// Missing updates that arrived later
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesRecovered;
+	// Sequenced updates received twice and dropped
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesDuplicate;
+	// Parameters of recovered updates skipped because a newer value was applied already
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesStale;
+	// Own updates sent again on request of other clients
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesResent;
+	// Received messages dropped because the update queue was full
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 ReceiveQueueOverflows;
+	// Messages dropped after waiting SendTimeout at the send high-water mark
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 SendDropped;
+	// Ticks the parameter message was held back for the send backlog, see LatestStateUpdates
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 UpdatesHeldBack;
+	// Messages waiting for the sender thread or the socket
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int32 SendBacklog;
+	// Poll loop iterations of the network thread and the milliseconds it spent handling them
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int64 NetworkWakeUps;
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		float NetworkBusyMs;
+	// Dirty scene objects visited by the change check in the last tick, all others were skipped
+	UPROPERTY(VisibleAnywhere, Category = "VPET2 Settings|Development|Stats")
+		int32 SceneObjectsChecked;
+
 	// Development print latch
 	bool doItOnce = true;
 
@@ -152,14 +320,45 @@ public:
 	zmq::socket_t* socket_r;
 	zmq::socket_t* socket_s;
 
-	// Message buffer
-	std::vector<std::vector<uint8_t>> msgQ;
+	// High-water marks, linger and keepalive of the network settings, before bind or connect
+	void ConfigureSocket(zmq::socket_t* socket);
+
+	// Serve the sockets above with SingleNetworkThread, stopped before they are closed
+	NetworkThread* networkThread = nullptr;
+	SceneDistributionThread* sceneThread = nullptr;
+
+	// Message buffer, filled by the receiver thread and drained in Tick
+	TMessageRing<zmq::message_t, 1024> msgQ;
+	uint64_t msgQOverflowsReported = 0;
+
+	// Offset of the local clock to the sync server, fed by the receiver and clock sync threads
+	ClockSync clockSync;
+
+	// Received updates by time step, played out JitterBufferDelay steps behind m_time
+	UpdateJitterBuffer jitterBuffer;
+	uint8_t JitterPlayoutTime() const;
+
+	// Message buffer for sending, the frames are recycled once sent
+	UpdateFramePool framePool;
+	UpdateSendQueue sendQueue;
 
-	// Message buffer for sending
-	std::vector<std::vector<uint8_t>> msgQs;
-	// Binary buffer for message construction
-	std::vector<char*> msgData;
-	std::vector<int> msgLen;
+	// Sequence of the next sent parameter update and copies of the recent ones for resends
+	uint16_t nextSequence = 0;
+	TUpdateHistory<256> updateHistory;
+
+	// Sequence counters, written by the receiver thread
+	std::atomic<int64> sequenceMissed{ 0 };
+	std::atomic<int64> sequenceRecovered{ 0 };
+	std::atomic<int64> sequenceDuplicates{ 0 };
+	std::atomic<int64> sequenceResent{ 0 };
+
+	// Called by the receiver thread, both only queue messages for the sender thread
+	void QueueResendRequest(uint8_t targetID, uint16_t firstSequence, int count);
+	void AnswerResendRequest(uint16_t firstSequence, int count);
+
+	// Session recording and replay, shared with the update threads
+	std::shared_ptr<VPET::Protocol::SessionLogWriter> sessionRecorder;
+	std::shared_ptr<SessionReplay> sessionReplay;
 
 	// Host ID
 	uint8_t m_id;
@@ -173,12 +372,21 @@ public:
 	// List of scene objects - for easier parameter access
 	TArray<USceneObject*> VPET_SceneObjectList;
 
-	//List of modified parameters
-	TArray<AbstractParameter*> VPET_ModifiedParameterList;
-	//Size of modified parameters
-	int VPET_modifiedParametersDataSize;
-	//Create parameter MSG function
-	void CreateParameterMessage();
+	//All parameters of the scene objects, indexed by their global slot
+	TArray<AbstractParameter*> VPET_ParameterSlots;
+	//Modified parameters, one bit per slot
+	TBitArray<> VPET_ModifiedParameters;
+	//Sender and sequence of the last applied sequenced update, per slot
+	struct ParameterOrigin
+	{
+		int16 sender = -1;
+		uint16 sequence = 0;
+	};
+	TArray<ParameterOrigin> VPET_ParameterOrigins;
+	//Number of modified parameters
+	int VPET_modifiedParametersCount;
+	//Create parameter MSG function, returns the number of parameters taken out of the modified set
+	int32 CreateParameterMessage();
 
 	
 	//UFUNCTION()
@@ -230,16 +438,54 @@ private:
 	AWorldSettings* wrldSet;
 	float lgtMult = 1.0;
 
-	void ParseParameterUpdate(std::vector<uint8_t> kMsg);
-	
+	void ParseParameterUpdate(ByteSpan kMsg);
+
+	// Latest received value of a parameter, last writer wins within a tick
+	struct PendingUpdate
+	{
+		AbstractParameter* param;
+		TArray<uint8> value;
+	};
+	// Slot pool, only the first numPendingUpdates entries are in use
+	TArray<PendingUpdate> pendingUpdates;
+	TMap<AbstractParameter*, int32> pendingSlotByParam;
+	int32 numPendingUpdates = 0;
+
+	void QueueParameterUpdate(AbstractParameter* param, ByteSpan value);
+	void ApplyPendingUpdates();
+
+	// Transform smoothing, one track per remotely moved scene object, only the active ones are updated
+	TArray<FTransformSmoothingTrack> smoothingTracks;
+	TMap<USceneObject*, int32> smoothingTrackByObject;
+	TArray<int32> activeSmoothingTracks;
+
+	bool QueueTransformSample(AbstractParameter* param, ByteSpan value, double now);
+	void UpdateTransformSmoothing(double now);
 
 	void AddActorPointer(AActor* pActor) {
 		actorList.Add(pActor);
 	}
 
+	// Scene objects with pending local changes, checked once per tick
+	TArray<USceneObject*> dirtySceneObjects;
+	// Scene objects with light or camera properties, marked dirty every tick by PollSceneObjectProperties
+	TArray<USceneObject*> polledSceneObjects;
+
+	// Packed parameters of all scene objects with BatchedChangeDetection
+	FSceneObjectBatch sceneObjectBatch;
+
+	void HandleSceneObjectDirty(USceneObject* sceneObj);
+	void CheckSceneObjects();
+
 	// Editor selection handler
 	void HandleOnActorSelectionChanged(const TArray<UObject*>& NewSelection, bool bForceRefresh);
 
+#if WITH_EDITOR
+	// Details panel edits of the distributed actors and their components
+	void HandleObjectPropertyChanged(UObject* object, FPropertyChangedEvent& event);
+	FDelegateHandle propertyChangedHandle;
+#endif // WITH_EDITOR
+
 public:
 
 	void EncodeLockMessage(int16_t objID, bool lockState);
@@ -0,0 +1,74 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#include "ClockSyncThread.h"
+
+// Clock sync thread
+void ClockSyncThread::DoWork()
+{
+	DOL(doLog, Warning, "[VPET2 CLOCK Thread] Pinging sync server at %s", UTF8_TO_TCHAR(endpoint.c_str()));
+
+	const long intervalMillis = GetIntervalMillis();
+
+	try {
+		zmq::socket_t socket(*context, ZMQ_REQ);
+		OpenSocket(socket);
+
+		zmq::pollitem_t item = { static_cast<void*>(socket), 0, ZMQ_POLLIN, 0 };
+
+		while (1)
+		{
+			SendPing(socket);
+
+			// Waiting in zmq keeps the thread responsive to the context closing
+			if (zmq::poll(&item, 1, intervalMillis) > 0 && HandleReply(socket))
+			{
+				// Rest of the interval, nothing arrives on the socket until the next ping
+				const long left = intervalMillis - (long)((FPlatformTime::Seconds() - sentSeconds) * 1000.0);
+				if (left > 0)
+					zmq::poll(&item, 1, left);
+			}
+		}
+	}
+	catch (const zmq::error_t& e)
+	{
+		// ETERM once EndPlay closes the context
+		FString errName = FString(zmq_strerror(e.num()));
+		DOL(doLog, Warning, "[VPET2 CLOCK Thread] Stopped: %s", *errName);
+	}
+}
+
+void ClockSyncThread::OpenSocket(zmq::socket_t& socket)
+{
+	// A lost reply must not block the next ping, replies are matched to their request
+	int option = 1;
+	socket.setsockopt(ZMQ_REQ_RELAXED, &option, sizeof(option));
+	socket.setsockopt(ZMQ_REQ_CORRELATE, &option, sizeof(option));
+	option = 0;
+	socket.setsockopt(ZMQ_LINGER, &option, sizeof(option));
+	socket.connect(endpoint);
+}
+
+void ClockSyncThread::SendPing(zmq::socket_t& socket)
+{
+	if (awaitingReply)
+		clockSync->CountPingTimeout();
+
+	// the time step is not used by the server, it only marks the request
+	VPET::Protocol::encodeControl(ping, sizeof(ping), cID, 0, MessageType::PING);
+	sentSeconds = FPlatformTime::Seconds();
+	socket.send(ping, sizeof(ping));
+	awaitingReply = true;
+}
+
+bool ClockSyncThread::HandleReply(zmq::socket_t& socket)
+{
+	if (!socket.recv(&reply, ZMQ_DONTWAIT))
+		return false;
+
+	const double received = FPlatformTime::Seconds();
+	VPET::Protocol::Header header;
+	if (VPET::Protocol::decodeHeader(static_cast<const uint8_t*>(reply.data()), reply.size(), header) && header.type == MessageType::PING)
+		clockSync->AddPing(sentSeconds, received, header.time);
+	awaitingReply = false;
+	return true;
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#include "SceneDistributionThread.h"
+
+SceneDistributionThread::SceneDistributionThread(SceneSenderThread* pScene, bool pLog) :
+	scene(pScene), doLog(pLog)
+{
+}
+
+SceneDistributionThread::~SceneDistributionThread()
+{
+	if (thread)
+	{
+		thread->Kill(true);
+		delete thread;
+	}
+}
+
+bool SceneDistributionThread::Start()
+{
+	thread = FRunnableThread::Create(this, TEXT("VPET Scene Distribution"), 0, TPri_Normal);
+	return thread != nullptr;
+}
+
+void SceneDistributionThread::Stop()
+{
+	stopping = true;
+}
+
+// Scene distribution thread
+uint32 SceneDistributionThread::Run()
+{
+	DOL(doLog, Warning, "[VPET2 DIST Thread] zeroMQ scene distribution thread running");
+
+	try {
+		// Watch the distribution socket for the client count
+		zmq::socket_t monitor(*scene->context, ZMQ_PAIR);
+		scene->StartMonitor(monitor);
+
+		zmq::pollitem_t items[] = {
+			{ static_cast<void*>(*scene->socket), 0, ZMQ_POLLIN, 0 },
+			{ static_cast<void*>(monitor), 0, ZMQ_POLLIN, 0 }
+		};
+
+		while (!stopping)
+		{
+			zmq::poll(items, 2, StopCheckInterval);
+
+			if (items[1].revents & ZMQ_POLLIN)
+				scene->HandleMonitorEvent(&monitor);
+			if ((items[0].revents & ZMQ_POLLIN) && !scene->ServeRequest())
+				break;
+		}
+	}
+	catch (const zmq::error_t& e)
+	{
+		FString errName = FString(zmq_strerror(e.num()));
+		DOL(doLog, Error, "[VPET2 DIST Thread] socket exception: %s", *errName);
+	}
+
+	DOL(doLog, Warning, "[VPET2 DIST Thread] zeroMQ scene distribution thread stopped");
+	return 0;
+}
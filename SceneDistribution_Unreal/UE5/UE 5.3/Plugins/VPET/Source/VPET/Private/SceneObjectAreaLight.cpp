@@ -7,9 +7,3 @@ void USceneObjectAreaLight::BeginPlay()
 {
 	Super::BeginPlay();
 }
-
-// Using the update loop to check for local parameter changes
-void USceneObjectAreaLight::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-}
@@ -0,0 +1,124 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#include "SceneObjectBatch.h"
+#include "Async/ParallelFor.h"
+
+void FSceneObjectBatch::Reset()
+{
+	objects.Reset();
+	positions.Reset();
+	rotations.Reset();
+	scales.Reset();
+	transformChanges.Reset();
+	lights.Reset();
+	colors.Reset();
+	intensities.Reset();
+	lightChanges.Reset();
+}
+
+void FSceneObjectBatch::Add(USceneObject* sceneObj)
+{
+	FVector pos;
+	FQuat rot;
+	FVector sca;
+	sceneObj->GetTransformParameters(pos, rot, sca);
+	objects.Add(sceneObj);
+	positions.Add(pos);
+	rotations.Add(rot);
+	scales.Add(sca);
+	transformChanges.Add(0);
+
+	USceneObjectLight* light = Cast<USceneObjectLight>(sceneObj);
+	if (light && light->HasLight())
+	{
+		FVector4d col;
+		float lit;
+		light->GetLightParameters(col, lit);
+		lights.Add(light);
+		colors.Add(col);
+		intensities.Add(lit);
+		lightChanges.Add(0);
+	}
+}
+
+int32 FSceneObjectBatch::Update(bool parallel)
+{
+	const EParallelForFlags flags = parallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+
+	// Locked objects are skipped, blended transforms are compared once the blending is over
+	const int32 numObjects = objects.Num();
+	ParallelFor((numObjects + ChunkSize - 1) / ChunkSize, [this, numObjects](int32 chunk)
+	{
+		const int32 end = FMath::Min(numObjects, (chunk + 1) * ChunkSize);
+		for (int32 i = chunk * ChunkSize; i < end; i++)
+		{
+			const USceneObject* sceneObj = objects[i];
+			uint8 changed = 0;
+			if (!sceneObj->_lock && !sceneObj->_smoothing)
+			{
+				FVector pos;
+				FQuat rot;
+				FVector sca;
+				sceneObj->ReadTransform(pos, rot, sca);
+				if (pos != positions[i])
+				{
+					positions[i] = pos;
+					changed |= USceneObject::PositionChanged;
+				}
+				if (rot != rotations[i])
+				{
+					rotations[i] = rot;
+					changed |= USceneObject::RotationChanged;
+				}
+				if (sca != scales[i])
+				{
+					scales[i] = sca;
+					changed |= USceneObject::ScaleChanged;
+				}
+			}
+			transformChanges[i] = changed;
+		}
+	}, flags);
+
+	const int32 numLights = lights.Num();
+	ParallelFor((numLights + ChunkSize - 1) / ChunkSize, [this, numLights](int32 chunk)
+	{
+		const int32 end = FMath::Min(numLights, (chunk + 1) * ChunkSize);
+		for (int32 i = chunk * ChunkSize; i < end; i++)
+		{
+			const USceneObjectLight* light = lights[i];
+			uint8 changed = 0;
+			if (!light->_lock)
+			{
+				FVector4d col;
+				float lit;
+				light->ReadLight(col, lit);
+				if (col != colors[i])
+				{
+					colors[i] = col;
+					changed |= USceneObjectLight::ColorChanged;
+				}
+				if (lit != intensities[i])
+				{
+					intensities[i] = lit;
+					changed |= USceneObjectLight::IntensityChanged;
+				}
+			}
+			lightChanges[i] = changed;
+		}
+	}, flags);
+
+	// The broadcasts reach the module, only on the calling thread
+	for (int32 i = 0; i < numObjects; i++)
+	{
+		if (transformChanges[i])
+			objects[i]->CommitTransform(transformChanges[i], positions[i], rotations[i], scales[i]);
+	}
+	for (int32 i = 0; i < numLights; i++)
+	{
+		if (lightChanges[i])
+			lights[i]->CommitLight(lightChanges[i], colors[i], intensities[i]);
+	}
+
+	return numObjects;
+}
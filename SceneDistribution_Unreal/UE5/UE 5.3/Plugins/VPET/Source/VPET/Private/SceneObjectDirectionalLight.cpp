@@ -7,9 +7,3 @@ void USceneObjectDirectionalLight::BeginPlay()
 {
 	Super::BeginPlay();
 }
-
-// Using the update loop to check for local parameter changes
-void USceneObjectDirectionalLight::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-}
@@ -3,8 +3,8 @@
 #include "SceneObjectSpotLight.h"
 
 // Message parsing pre-declarations
-void UpdateRange(std::vector<uint8_t> kMsg, AActor* actor);
-void UpdateAngle(std::vector<uint8_t> kMsg, AActor* actor);
+void UpdateRange(ByteSpan kMsg, AActor* actor);
+void UpdateAngle(ByteSpan kMsg, AActor* actor);
 
 // Called when the game starts
 void USceneObjectSpotLight::BeginPlay()
@@ -24,14 +24,11 @@ void USceneObjectSpotLight::BeginPlay()
 	}
 }
 
-// Using the update loop to check for local parameter changes
-void USceneObjectSpotLight::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+// Checks the spot light parameters for local changes
+void USceneObjectSpotLight::CheckProperties()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	Super::CheckProperties();
 
-	if (_lock)
-		return;
-	
 	if (spotLgtCmp)
 	{
 		float range = spotLgtCmp->AttenuationRadius * rangeFactor;
@@ -53,7 +50,7 @@ void USceneObjectSpotLight::TickComponent(float DeltaTime, ELevelTick TickType,
 }
 
 // Parses a message for range change
-void UpdateRange(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateRange(ByteSpan kMsg, AActor* actor)
 {
 	UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Try Type RANGE"));
 	ASpotLight* kSpotLgt = Cast<ASpotLight>(actor);
@@ -64,7 +61,9 @@ void UpdateRange(std::vector<uint8_t> kMsg, AActor* actor)
 	{
 		float rangeFactor = 0.005;
 
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 		UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type RANGE: %f"), lK);
 
 		spotLgtCmp->AttenuationRadius = lK / rangeFactor;
@@ -72,7 +71,7 @@ void UpdateRange(std::vector<uint8_t> kMsg, AActor* actor)
 }
 
 // Parses a message for angle change
-void UpdateAngle(std::vector<uint8_t> kMsg, AActor* actor)
+void UpdateAngle(ByteSpan kMsg, AActor* actor)
 {
 	UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Try Type SPOT ANGLE"));
 	ASpotLight* kSpotLgt = Cast<ASpotLight>(actor);
@@ -83,7 +82,9 @@ void UpdateAngle(std::vector<uint8_t> kMsg, AActor* actor)
 	{
 		float angleFactor = 2.0;
 
-		float lK = *reinterpret_cast<float*>(&kMsg[0]);
+		float lK;
+		if (!kMsg.Read(0, lK))
+			return;
 		UE_LOG(LogTemp, Warning, TEXT("[SYNC Parse] Type SPOT ANGLE: %f"), lK);
 
 		spotLgtCmp->OuterConeAngle = lK / angleFactor;
@@ -7,90 +7,202 @@
 void UpdateReceiverThread::DoWork()
 {
 	DOL(doLog, Warning, "[VPET2 RECV Thread] zeroMQ update receiver thread running");
+	if (replay)
+	{
+		DOL(doLog, Warning, "[VPET2 RECV Thread] Replaying session log at %.2fx", replay->speed);
+		replayStart = FPlatformTime::Seconds();
+	}
+
+	while (1)
+	{
+		// Receive straight into the next queue slot, it is only published for parameter updates
+		zmq::message_t* slot = msgQ->BeginWrite();
+		// A replay waits for the game thread instead of dropping
+		while (replay && !slot && !replay->stop)
+		{
+			FPlatformProcess::Sleep(0.001f);
+			slot = msgQ->BeginWrite();
+		}
+		zmq::message_t* message = slot ? slot : &overflowMessage;
 
-	zmq::message_t message;
-	std::string msgString;
-	uint8_t* byteStream;
-	std::vector<uint8_t> byteVector;
+		if (replay)
+		{
+			if (!NextReplayMessage(message))
+			{
+				DOL(doLog, Warning, "[VPET2 RECV Thread] Session replay finished");
+				return;
+			}
+		}
+		else
+		{
+			// Blocking receive
+			try {
+				socket->recv(message);
+			}
+			catch (const zmq::error_t& e)
+			{
+				FString errName = FString(zmq_strerror(e.num()));
+				DOL(doLog, Error, "[RECV Thread] recv exception: %s", *errName);
+				return;
+			}
+		}
 
-	std::vector<std::string> stringVect;
+		Dispatch(slot, message, FPlatformTime::Seconds());
+	}
+}
 
+// Receives and handles all messages waiting on the socket, false once the socket is closed
+bool UpdateReceiverThread::ReceivePending()
+{
 	while (1)
 	{
-		char* responseMessageContent = NULL;
-		char* messageStart = NULL;
-		int responseLength = 0;
-
-		// Blocking receive
+		zmq::message_t* slot = msgQ->BeginWrite();
+		zmq::message_t* message = slot ? slot : &overflowMessage;
 		try {
-			socket->recv(&message);
+			if (!socket->recv(message, ZMQ_DONTWAIT))
+				return true;
 		}
 		catch (const zmq::error_t& e)
 		{
 			FString errName = FString(zmq_strerror(e.num()));
 			DOL(doLog, Error, "[RECV Thread] recv exception: %s", *errName);
-			return;
+			return false;
 		}
+		Dispatch(slot, message, FPlatformTime::Seconds());
+	}
+}
 
-		const char* msgPointer = static_cast<const char*>(message.data());
-		if (msgPointer == NULL) {
-			DOL(doLog, Error, "[RECV Thread] Error msgPointer is NULL");
-		}
-		else
+// Records and handles one message, slot is the queue slot holding it or nullptr if the queue is full
+void UpdateReceiverThread::Dispatch(zmq::message_t* slot, zmq::message_t* message, double received)
+{
+	if (recorder)
+		recorder->append(VPET::Protocol::LogDirection::INBOUND, message->data(), message->size());
+
+	VPET::Protocol::Header header;
+	const uint8_t* byteStream = static_cast<const uint8_t*>(message->data());
+	if (!VPET::Protocol::decodeHeader(byteStream, message->size(), header)) {
+		DOL(doLog, Error, "[RECV Thread] Error message is empty or shorter than the header");
+	}
+	else
+	{
+		// Process message 
+		// Ignore message from host
+		if (header.clientID != cID)
 		{
-			// Shifting into std::vector
-			byteVector.clear();
-			byteStream = static_cast<uint8_t*>(message.data()), message.size();
-			for (size_t i = 0; i < message.size(); i++)
+			switch (header.type)
+			{
+			case MessageType::LOCK:
 			{
-				byteVector.push_back(byteStream[i]);
+				//decodeLockMessage(ref input);
+				UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Lock message"));
+				VPET::Protocol::LockMessage lock;
+				if (!VPET::Protocol::decodeLock(byteStream, message->size(), lock))
+					break;
+				int16_t objectID = lock.objectID;
+				bool lockState = lock.locked;
+				manager->DecodeLockMessage(&objectID, &lockState);
+				break;
 			}
-
-			// Process message 
-			// Byte zero -> cID
-			// Ignore message from host
-			if (byteVector[0] != cID)
+			case MessageType::SYNC:
+				UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Sync message"));
+				if (clockSync)
+					clockSync->AddSync(header.time, received);
+				break;
+			case MessageType::UNDOREDOADD:
+				//decodeUndoRedoMessage(ref input);
+				UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Undo/Redo message"));
+				break;
+			case MessageType::RESETOBJECT:
+				//decodeResetMessage(ref input);
+				UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Reset message"));
+				break;
+			case MessageType::RESENDUPDATE:
 			{
-				// Byte 1 -> time
-				// Byte 2 -> Parameter update
-				switch ((MessageType)byteVector[2])
-				{
-				case MessageType::LOCK:
+				UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Resend request"));
+				VPET::Protocol::ResendRequest request;
+				if (VPET::Protocol::decodeResendRequest(byteStream, message->size(), request) && request.targetID == cID)
+					manager->AnswerResendRequest(request.firstSequence, request.count);
+				break;
+			}
+			case MessageType::PARAMETERUPDATE:
+				// input[1] is time, Tick buckets the message by it in the jitter buffer
+				UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Parameter updated message"));
+				// The frame itself is handed to Tick, no copy
+				// Dropped updates are not tracked, their sequence number is requested again
+				if (slot)
 				{
-					//decodeLockMessage(ref input);
-					UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Lock message"));
-					int16_t objectID = *reinterpret_cast<int16_t*>(&byteVector[4]);
-					bool lockState = *reinterpret_cast<bool*>(&byteVector[6]);
-					manager->DecodeLockMessage(&objectID, &lockState);
-					break;
+					if (header.sequenced && !CheckSequence(header))
+						break;
+					msgQ->CommitWrite();
 				}
-				case MessageType::SYNC:
-					//if (!core.isServer)
-					//	decodeSyncMessage(ref input);
-					UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Sync message"));
-					break;
-				case MessageType::UNDOREDOADD:
-					//decodeUndoRedoMessage(ref input);
-					UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Undo/Redo message"));
-					break;
-				case MessageType::RESETOBJECT:
-					//decodeResetMessage(ref input);
-					UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Reset message"));
-					break;
-				case MessageType::PARAMETERUPDATE:
-					// input[1] is time
-					//m_messageBuffer[input[1]].Add(input);
-					UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Parameter updated message"));
-					msgQ->push_back(byteVector);
-					break;
-				default:
-					break;
+				else
+				{
+					msgQ->CountOverflow();
+					DOL(doLog, Warning, "[VPET2 RECV Thread] Update queue full, dropping parameter update");
 				}
+				break;
+			default:
+				break;
 			}
-			else
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Message came from host, cID: %d"), cID);
+		}
+	}
+}
+
+// Gap detection on sequenced updates, false for a duplicate that is dropped
+bool UpdateReceiverThread::CheckSequence(const VPET::Protocol::Header& header)
+{
+	using Result = VPET::Protocol::SequenceTracker::Result;
+
+	uint16_t missingFirst = 0;
+	int missingCount = 0;
+	switch (senderSequences[header.clientID].add(header.sequence, missingFirst, missingCount))
+	{
+	case Result::GAP:
+		DOL(doLog, Log, "[VPET2 RECV Thread] %d updates of client %d missing, requesting a resend", missingCount, header.clientID);
+		manager->sequenceMissed += missingCount;
+		// the recorded senders of a replay cannot answer
+		if (!replay)
+			manager->QueueResendRequest(header.clientID, missingFirst, missingCount);
+		return true;
+	case Result::RECOVERED:
+		manager->sequenceRecovered++;
+		return true;
+	case Result::DUPLICATE:
+		manager->sequenceDuplicates++;
+		return false;
+	default:
+		return true;
+	}
+}
+
+// Next inbound message of the replayed session, waits until it is due at the replay speed
+bool UpdateReceiverThread::NextReplayMessage(zmq::message_t* message)
+{
+	VPET::Protocol::LogRecord record;
+	while (!replay->stop && replay->reader.next(record))
+	{
+		if (record.direction != VPET::Protocol::LogDirection::INBOUND)
+			continue;
+
+		if (replay->speed > 0.0f)
+		{
+			const double due = replayStart + record.timeNanos / 1e9 / replay->speed;
+			double now = FPlatformTime::Seconds();
+			while (!replay->stop && now < due)
 			{
-				UE_LOG(LogTemp, Log, TEXT("[VPET2 Parse] Message came from host, cID: %d"), cID);
+				FPlatformProcess::Sleep((float)FMath::Min(due - now, 0.002));
+				now = FPlatformTime::Seconds();
 			}
 		}
+		if (replay->stop)
+			return false;
+
+		message->rebuild(record.data, record.size);
+		return true;
 	}
+	return false;
 }
@@ -0,0 +1,49 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Non-owning view on a received message, the viewed buffer has to outlive the span.
+// Reads are bounds checked and do not require aligned data.
+class ByteSpan
+{
+public:
+	ByteSpan() : data(nullptr), size(0) { }
+	ByteSpan(const void* pData, size_t pSize) : data(static_cast<const uint8_t*>(pData)), size(pSize) { }
+
+	const uint8_t* Data() const { return data; }
+	size_t Size() const { return size; }
+	bool IsEmpty() const { return size == 0; }
+
+	bool Contains(size_t offset, size_t length) const
+	{
+		return offset <= size && length <= size - offset;
+	}
+
+	// Copies the value at offset into out, false if it would read past the end
+	template <typename T>
+	bool Read(size_t offset, T& out) const
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "ByteSpan can only read trivially copyable types");
+		if (!Contains(offset, sizeof(T)))
+			return false;
+		std::memcpy(&out, data + offset, sizeof(T));
+		return true;
+	}
+
+	// View on a part of this span, empty if the range is out of bounds
+	ByteSpan Sub(size_t offset, size_t length) const
+	{
+		if (!Contains(offset, length))
+			return ByteSpan();
+		return ByteSpan(data + offset, length);
+	}
+
+private:
+	const uint8_t* data;
+	size_t size;
+};
@@ -0,0 +1,195 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+
+// Local time step clock that follows the clock of the sync server.
+// Ping replies and SYNC messages give offset samples, the sample with the lowest round
+// trip of the recent ones is the least delayed and is blended into the offset estimate.
+// The clock is advanced by one step per timer tick and slewed by a fraction of a step
+// towards the estimate, only large offsets (startup, server restart) are stepped at once.
+// Samples come from the network threads, the clock is advanced by the game thread.
+class ClockSync
+{
+public:
+	struct Stats
+	{
+		double rttMillis = 0.0;
+		double minRttMillis = 0.0;
+		double jitterMillis = 0.0;
+		double offsetSteps = 0.0;
+		int64_t pings = 0;
+		int64_t pingTimeouts = 0;
+		int64_t syncs = 0;
+		int64_t jumps = 0;
+	};
+
+	// Slew per tick in steps and the offset above which the clock is stepped
+	ClockSync(double pMaxSlew = 0.1, double pJumpThreshold = 8.0) :
+		maxSlew(pMaxSlew), jumpThreshold(pJumpThreshold)
+	{
+		Reset(0, 60, 0.0);
+	}
+
+	void Reset(int pTimesteps, int pFramerate, double now)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		timesteps = pTimesteps;
+		framerate = pFramerate > 0 ? pFramerate : 60;
+		clock = 0.0;
+		lastAdvance = now;
+		offset = 0.0;
+		hasOffset = false;
+		smoothedRtt = 0.0;
+		windowCount = 0;
+		windowNext = 0;
+		stats = Stats();
+	}
+
+	// One timer tick at now (seconds), returns the current time step
+	uint8_t Advance(double now)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		if (timesteps <= 0)
+			return 0;
+		if (std::fabs(offset) > jumpThreshold)
+		{
+			Correct(offset);
+			stats.jumps++;
+		}
+		else
+			Correct(std::max(-maxSlew, std::min(maxSlew, offset)));
+		clock = Wrap(clock + 1.0, 0.0);
+		lastAdvance = now;
+		return (uint8_t)((int)std::floor(clock) % timesteps);
+	}
+
+	// Ping sent and reply received at the given seconds, the reply carries the server time step
+	void AddPing(double sentSeconds, double receivedSeconds, uint8_t serverTime)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		if (timesteps <= 0)
+			return;
+		const double rtt = std::max(receivedSeconds - sentSeconds, 0.0);
+		if (stats.pings == 0)
+			smoothedRtt = rtt;
+		else
+		{
+			stats.jitterMillis += (std::fabs(rtt - smoothedRtt) * 1000.0 - stats.jitterMillis) / 8.0;
+			smoothedRtt += (rtt - smoothedRtt) / 8.0;
+		}
+		stats.pings++;
+		AddSample(rtt, serverTime, rtt * 0.5, receivedSeconds);
+	}
+
+	// SYNC broadcast of the server received at the given seconds, assumed to be half a round trip old
+	void AddSync(uint8_t serverTime, double receivedSeconds)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		if (timesteps <= 0)
+			return;
+		stats.syncs++;
+		const double rtt = stats.pings > 0 ? smoothedRtt : 0.0;
+		AddSample(rtt, serverTime, rtt * 0.5, receivedSeconds);
+	}
+
+	void CountPingTimeout()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stats.pingTimeouts++;
+	}
+
+	Stats GetStats() const
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		Stats result = stats;
+		result.rttMillis = smoothedRtt * 1000.0;
+		result.minRttMillis = windowCount > 0 ? window[MinRttSample()].rtt * 1000.0 : 0.0;
+		result.offsetSteps = offset;
+		return result;
+	}
+
+private:
+	struct Sample
+	{
+		double rtt;
+		double offset;
+	};
+
+	static constexpr int WINDOW = 8;
+
+	// Into [low, low + timesteps)
+	double Wrap(double steps, double low) const
+	{
+		return steps - std::floor((steps - low) / timesteps) * timesteps;
+	}
+
+	void AddSample(double rtt, uint8_t serverTime, double delay, double receivedSeconds)
+	{
+		// the server step started anywhere within its duration, take its middle
+		const double local = clock + std::max(-1.0, std::min(2.0, (receivedSeconds - lastAdvance) * framerate));
+		const double sampleOffset = Wrap(serverTime + 0.5 + delay * framerate - local, -timesteps * 0.5);
+
+		window[windowNext] = { rtt, sampleOffset };
+		windowNext = (windowNext + 1) % WINDOW;
+		windowCount = std::min(windowCount + 1, WINDOW);
+
+		const double target = window[MinRttSample()].offset;
+		const double error = Wrap(target - offset, -timesteps * 0.5);
+		if (!hasOffset)
+		{
+			offset = target;
+			hasOffset = true;
+		}
+		// far off (server restart), blending would step the clock several times on the way
+		else if (std::fabs(error) > jumpThreshold)
+			offset += error;
+		else
+			offset += error * 0.25;
+	}
+
+	// Lowest round trip in the window, the newest one of equal samples
+	int MinRttSample() const
+	{
+		int best = -1;
+		for (int i = 0; i < windowCount; i++)
+		{
+			const int index = (windowNext - 1 - i + WINDOW) % WINDOW;
+			if (best < 0 || window[index].rtt < window[best].rtt)
+				best = index;
+		}
+		return best;
+	}
+
+	// Moves the clock, the estimate and the samples are relative to it
+	void Correct(double steps)
+	{
+		if (steps == 0.0)
+			return;
+		clock = Wrap(clock + steps, 0.0);
+		offset -= steps;
+		for (int i = 0; i < windowCount; i++)
+			window[i].offset -= steps;
+	}
+
+	mutable std::mutex mtx;
+	double maxSlew;
+	double jumpThreshold;
+	int timesteps;
+	int framerate;
+	// local clock in steps, the time step is its integer part
+	double clock;
+	double lastAdvance;
+	// steps the server is ahead of the local clock, not corrected yet
+	double offset;
+	bool hasOffset;
+	double smoothedRtt = 0.0;
+	Sample window[WINDOW];
+	int windowCount;
+	int windowNext;
+	Stats stats;
+};
@@ -0,0 +1,40 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <zmq.hpp>
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "SceneSenderThread.h"
+
+#include <atomic>
+#include <memory>
+
+// Scene distribution thread, serves the distribution socket next to the network thread.
+// Objects and textures replies take long to build and send, on their own thread they do not
+// hold back the live updates. The socket is only used by this thread while it runs and closed
+// by the module after it stopped.
+class SceneDistributionThread : public FRunnable
+{
+public:
+	// Takes ownership of the handler
+	SceneDistributionThread(SceneSenderThread* pScene, bool pLog);
+
+	// Stops and waits for the thread
+	virtual ~SceneDistributionThread();
+
+	bool Start();
+
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	// Milliseconds a poll waits for a request before the stop flag is checked again
+	static constexpr long StopCheckInterval = 100;
+
+	std::unique_ptr<SceneSenderThread> scene;
+	bool doLog;
+
+	FRunnableThread* thread = nullptr;
+	std::atomic<bool> stopping{ false };
+};
@@ -0,0 +1,128 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "VPETSceneProtocol.h"
+
+namespace VPET
+{
+	//! Phases of the scene build that get timed
+	//! mesh, material and texture run inside traverse, texture inside material
+	enum BuildPhase { PHASE_OPEN, PHASE_TRAVERSE, PHASE_MESH, PHASE_MATERIAL, PHASE_TEXTURE, PHASE_SERIALIZE, PHASE_COUNT };
+	static const char* const buildPhaseNames[PHASE_COUNT] = { "open", "traverse", "mesh", "material", "texture", "serialize" };
+
+	//! Request names, node and light types come from the shared protocol
+	using namespace Protocol::Scene;
+
+	inline int64_t microsSince(const std::chrono::steady_clock::time_point &start)
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	struct PhaseCounter
+	{
+		std::atomic<int64_t> count{ 0 };
+		std::atomic<int64_t> micros{ 0 };
+	};
+
+	struct RequestCounter
+	{
+		std::atomic<int64_t> count{ 0 };
+		std::atomic<int64_t> bytesSent{ 0 };
+		std::atomic<int64_t> serializeMicros{ 0 };
+		std::atomic<int64_t> sendMicros{ 0 };
+	};
+
+	//! Lock-free counters for the scene build and the distribution socket.
+	//! Written by the build and server threads, read by the "stats" request.
+	class DistributorStats
+	{
+	public:
+		PhaseCounter phases[PHASE_COUNT];
+		RequestCounter requests[REQUEST_COUNT];
+		std::atomic<int> clients{ 0 };
+		std::atomic<int64_t> clientsTotal{ 0 };
+		//! replies the socket did not take
+		std::atomic<int64_t> repliesDropped{ 0 };
+
+		void addPhase(BuildPhase phase, int64_t micros)
+		{
+			phases[phase].count.fetch_add(1, std::memory_order_relaxed);
+			phases[phase].micros.fetch_add(micros, std::memory_order_relaxed);
+		}
+
+		void addRequest(RequestType request, int64_t bytes, int64_t serializeMicros, int64_t sendMicros)
+		{
+			RequestCounter &counter = requests[request];
+			counter.count.fetch_add(1, std::memory_order_relaxed);
+			counter.bytesSent.fetch_add(bytes, std::memory_order_relaxed);
+			counter.serializeMicros.fetch_add(serializeMicros, std::memory_order_relaxed);
+			counter.sendMicros.fetch_add(sendMicros, std::memory_order_relaxed);
+			addPhase(PHASE_SERIALIZE, serializeMicros);
+		}
+
+		void clientConnected()
+		{
+			clients.fetch_add(1, std::memory_order_relaxed);
+			clientsTotal.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void clientDisconnected()
+		{
+			clients.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		//! Snapshot of all counters as a JSON object (times in microseconds)
+		std::string toJson() const
+		{
+			std::ostringstream json;
+			json << "{\"phases\":{";
+			for (int i = 0; i < PHASE_COUNT; i++)
+			{
+				json << (i ? "," : "") << "\"" << buildPhaseNames[i] << "\":{"
+					<< "\"count\":" << phases[i].count.load(std::memory_order_relaxed)
+					<< ",\"us\":" << phases[i].micros.load(std::memory_order_relaxed) << "}";
+			}
+			json << "},\"requests\":{";
+			for (int i = 0; i < REQUEST_COUNT; i++)
+			{
+				json << (i ? "," : "") << "\"" << requestNames[i] << "\":{"
+					<< "\"count\":" << requests[i].count.load(std::memory_order_relaxed)
+					<< ",\"bytesSent\":" << requests[i].bytesSent.load(std::memory_order_relaxed)
+					<< ",\"serializeUs\":" << requests[i].serializeMicros.load(std::memory_order_relaxed)
+					<< ",\"sendUs\":" << requests[i].sendMicros.load(std::memory_order_relaxed) << "}";
+			}
+			json << "},\"clients\":" << clients.load(std::memory_order_relaxed)
+				<< ",\"clientsTotal\":" << clientsTotal.load(std::memory_order_relaxed)
+				<< ",\"repliesDropped\":" << repliesDropped.load(std::memory_order_relaxed) << "}";
+			return json.str();
+		}
+	};
+
+	//! Adds the lifetime of the timer to a build phase
+	class ScopedPhaseTimer
+	{
+	public:
+		ScopedPhaseTimer(DistributorStats &stats, BuildPhase phase) :
+			m_stats(stats),
+			m_phase(phase),
+			m_start(std::chrono::steady_clock::now())
+		{}
+
+		~ScopedPhaseTimer()
+		{
+			m_stats.addPhase(m_phase, microsSince(m_start));
+		}
+
+	private:
+		DistributorStats &m_stats;
+		BuildPhase m_phase;
+		std::chrono::steady_clock::time_point m_start;
+	};
+}
@@ -5,14 +5,33 @@
 #include <vector>
 
 #include "ARTypes.h"
+#include "Components/SceneComponent.h"
 #include "Parameter.h"
 #include "ParameterObject.h"
+#include "UpdateSendQueue.h"
 #include "SceneObject.generated.h"
 
 
 class AVPETModule;
 
+// How remote transform updates are shown between the received samples
+UENUM()
+enum class EVpetTransformSmoothing : uint8
+{
+	// snap to every received sample
+	None,
+	// blend between the last two samples, one sample interval behind
+	Interpolate,
+	// continue the motion of the last two samples for a limited time
+	Extrapolate
+};
+
+// Message parsing of the transform parameters, false if the message is too short
+bool DecodePosition(ByteSpan kMsg, FVector& position);
+bool DecodeRotation(ByteSpan kMsg, AActor* actor, FQuat& rotation);
 
+class USceneObject;
+typedef TDelegate<void(USceneObject*)> FVpet_SceneObject_Delegate;
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class VPET_API USceneObject : public UParameterObject
@@ -26,6 +45,45 @@ public:
 	// Is the sceneObject locked?
 	bool _lock = false;
 
+	// Is the module blending remote transform updates? Local change detection pauses meanwhile
+	bool _smoothing = false;
+
+	// Smoothing of remote position and rotation updates
+	UPROPERTY(EditAnywhere, Category = "VPET")
+		EVpetTransformSmoothing TransformSmoothing = EVpetTransformSmoothing::Interpolate;
+
+	// Local changes not compared yet, set by the change notifications
+	bool _transformDirty = false;
+	bool _propertiesDirty = false;
+
+	// Bound by the module, queues the object for the change check when it becomes dirty
+	FVpet_SceneObject_Delegate SceneObject_IsDirty;
+
+	// Flags the transform and/or the other parameters as possibly changed
+	void MarkDirty(bool transform, bool properties);
+
+	// Compares the dirty parameters against their cached values and broadcasts the changed ones.
+	// Returns true while something stays dirty, locked objects and blended transforms wait
+	bool CheckForChanges();
+
+	// Parameters without a change notification at runtime, the module polls them
+	virtual bool HasPolledProperties() const { return false; }
+
+	// Transform and light parameters are compared by the module in one pass (BatchedChangeDetection)
+	bool _batched = false;
+
+	// Changed transform parameters
+	static constexpr uint8 PositionChanged = 1 << 0;
+	static constexpr uint8 RotationChanged = 1 << 1;
+	static constexpr uint8 ScaleChanged = 1 << 2;
+
+	// Current transform of the actor, relative to its attach parent
+	void ReadTransform(FVector& pos, FQuat& rot, FVector& sca) const;
+	// Values of the transform parameters
+	void GetTransformParameters(FVector& pos, FQuat& rot, FVector& sca) const;
+	// Stores the changed values in their parameters and broadcasts them
+	void CommitTransform(uint8 changed, const FVector& pos, const FQuat& rot, const FVector& sca);
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
@@ -47,16 +105,16 @@ protected:
 
 
 	// Access to send queue
-	std::vector<char*>* msgData;
-	std::vector<int>* msgLen;
+	UpdateSendQueue* sendQueue;
 
-	
+	// Change checks of the dirty parameters
+	void CheckTransform();
+	virtual void CheckProperties() {}
+
+	// Root component moved, also called for moves of the attach parent
+	void HandleTransformUpdated(USceneComponent* updatedComponent, EUpdateTransformFlags updateTransformFlags, ETeleportType teleport);
 
 public:	
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-	
-	
 	AActor* thisActor;
 
 	TArray<AbstractParameter*> modifiedParameterList;
@@ -87,10 +145,19 @@ public:
 		return ID;
 	}
 
-	void SetSenderQueue(std::vector<char*>* pData, std::vector<int>* pLen)
+	AbstractParameter* GetPositionParameter()
+	{
+		return Position_Vpet_Param;
+	}
+
+	AbstractParameter* GetRotationParameter()
+	{
+		return Rotation_Vpet_Param;
+	}
+
+	void SetSenderQueue(UpdateSendQueue* pQueue)
 	{
-		msgData = pData;
-		msgLen = pLen;
+		sendQueue = pQueue;
 	}
 	
 };
@@ -0,0 +1,42 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SceneObject.h"
+#include "SceneObjectLight.h"
+
+// Packed copies of the transform and light parameters of all scene objects. One pass per tick
+// compares them against the actors, instead of a change check per scene object. The compare
+// only reads the actors and writes its own entry, so it can run on worker threads.
+class FSceneObjectBatch
+{
+public:
+	// Entries compared by one worker at a time
+	static constexpr int32 ChunkSize = 256;
+
+	void Reset();
+
+	// Takes the current parameter values as reference, the object must have begun play
+	void Add(USceneObject* sceneObj);
+
+	// Compares all entries, on worker threads if parallel. The changed values are stored in
+	// their parameters and broadcast afterwards on the calling thread. Returns the compared objects
+	int32 Update(bool parallel);
+
+	int32 Num() const { return objects.Num(); }
+
+private:
+	TArray<USceneObject*> objects;
+	TArray<FVector> positions;
+	TArray<FQuat> rotations;
+	TArray<FVector> scales;
+	// Changed transform parameters of the last compare, USceneObject::PositionChanged etc.
+	TArray<uint8> transformChanges;
+
+	TArray<USceneObjectLight*> lights;
+	TArray<FVector4d> colors;
+	TArray<float> intensities;
+	// Changed light parameters of the last compare, USceneObjectLight::ColorChanged etc.
+	TArray<uint8> lightChanges;
+};
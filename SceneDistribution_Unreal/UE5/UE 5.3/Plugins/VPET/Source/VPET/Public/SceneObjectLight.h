@@ -17,11 +17,26 @@ class VPET_API USceneObjectLight : public USceneObject
 {
 	GENERATED_BODY()
 
+public:
+	// Changed light parameters
+	static constexpr uint8 ColorChanged = 1 << 0;
+	static constexpr uint8 IntensityChanged = 1 << 1;
+
+	bool HasLight() const { return kLit != nullptr; }
+
+	// Current color and intensity of the light in VPET units
+	void ReadLight(FVector4d& col, float& lit) const;
+	// Values of the color and intensity parameters
+	void GetLightParameters(FVector4d& col, float& lit) const;
+	// Stores the changed values in their parameters and broadcasts them
+	void CommitLight(uint8 changed, const FVector4d& col, float lit);
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// Compares color and intensity, polled by the module
+	virtual void CheckProperties() override;
+	virtual bool HasPolledProperties() const override { return kLit != nullptr; }
 
 	ALight* kLit;
 	float lightFactor = 0.2;
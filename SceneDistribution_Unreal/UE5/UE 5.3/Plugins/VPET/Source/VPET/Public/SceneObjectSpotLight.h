@@ -18,8 +18,8 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// Compares range and angle after the light parameters
+	virtual void CheckProperties() override;
 
 	ASpotLight* kSpotLgt;
 	USpotLightComponent* spotLgtCmp;
@@ -21,14 +21,24 @@ class SceneSenderThread : public FNonAbandonableTask
 {
 	friend class FAutoDeleteAsyncTask<SceneSenderThread>;
 public:
+	zmq::context_t* context;
 	zmq::socket_t* socket;
 	VPET::SceneDistributorState* m_sharedState;
 	bool doLog;
 
-	SceneSenderThread(zmq::socket_t* pSocket, VPET::SceneDistributorState* pState, bool pLog) : socket(pSocket), m_sharedState(pState), doLog(pLog) { }
+	SceneSenderThread(zmq::context_t* pContext, zmq::socket_t* pSocket, VPET::SceneDistributorState* pState, bool pLog) : context(pContext), socket(pSocket), m_sharedState(pState), doLog(pLog) { }
 
 	void DoWork();
 
+	// Connects the monitor to the connect and disconnect events of the socket
+	void StartMonitor(zmq::socket_t& monitor);
+
+	// Answers one waiting request without blocking, false once the socket is closed
+	bool ServeRequest();
+
+	// Counts client connects and disconnects reported by the socket monitor
+	void HandleMonitorEvent(zmq::socket_t* monitor);
+
 	FORCEINLINE TStatId GetStatId() const
 	{
 		RETURN_QUICK_DECLARE_CYCLE_STAT(FGenericTask, STATGROUP_TaskGraphTasks);
@@ -0,0 +1,23 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <atomic>
+
+// The session log maps its file through the platform API
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include "VPETSessionLog.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+#else
+#include "VPETSessionLog.h"
+#endif
+
+// A recorded session fed into the receive path instead of the update receiver socket
+struct SessionReplay
+{
+	VPET::Protocol::SessionLogReader reader;
+	// Multiple of the recorded speed, 0 replays as fast as the queue takes it
+	float speed = 1.0f;
+	std::atomic<bool> stop{ false };
+};
@@ -0,0 +1,108 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+class UpdateFramePool;
+
+// Buffer for one outgoing message, the capacity only grows so a reused frame does not allocate
+struct UpdateFrame
+{
+	char* data = nullptr;
+	size_t capacity = 0;
+	UpdateFramePool* pool = nullptr;
+};
+
+// Recycles outgoing message buffers. Frames are acquired by the game thread and
+// returned by zmq through ReleaseFrame once the message has been sent.
+class UpdateFramePool
+{
+public:
+	// Two frames cover one message in flight while the next one is written
+	UpdateFramePool(size_t prewarmCount = 2, size_t prewarmCapacity = 1024)
+	{
+		for (size_t i = 0; i < prewarmCount; i++)
+		{
+			UpdateFrame* frame = new UpdateFrame();
+			frame->pool = this;
+			Grow(frame, prewarmCapacity);
+			freeFrames.push_back(frame);
+		}
+		frameCount = prewarmCount;
+	}
+
+	// All frames have to be back, zmq returns them before its context terminates
+	~UpdateFramePool()
+	{
+		for (UpdateFrame* frame : freeFrames)
+		{
+			free(frame->data);
+			delete frame;
+		}
+	}
+
+	UpdateFrame* Acquire(size_t size)
+	{
+		UpdateFrame* frame = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			if (!freeFrames.empty())
+			{
+				frame = freeFrames.back();
+				freeFrames.pop_back();
+			}
+		}
+		if (!frame)
+		{
+			frame = new UpdateFrame();
+			frame->pool = this;
+			std::lock_guard<std::mutex> lock(mtx);
+			frameCount++;
+		}
+		if (frame->capacity < size)
+			Grow(frame, size);
+		return frame;
+	}
+
+	void Release(UpdateFrame* frame)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		freeFrames.push_back(frame);
+	}
+
+	// zmq free function, hint is the frame
+	static void ReleaseFrame(void*, void* hint)
+	{
+		UpdateFrame* frame = static_cast<UpdateFrame*>(hint);
+		frame->pool->Release(frame);
+	}
+
+	// Frames allocated so far, the pool only grows while more messages are in flight than ever before
+	size_t GetFrameCount()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return frameCount;
+	}
+
+	// Frames waiting for reuse, equal to the frame count once every message is sent
+	size_t GetFreeCount()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return freeFrames.size();
+	}
+
+private:
+	static void Grow(UpdateFrame* frame, size_t size)
+	{
+		free(frame->data);
+		frame->data = (char*)malloc(size);
+		frame->capacity = size;
+	}
+
+	std::mutex mtx;
+	std::vector<UpdateFrame*> freeFrames;
+	size_t frameCount = 0;
+};
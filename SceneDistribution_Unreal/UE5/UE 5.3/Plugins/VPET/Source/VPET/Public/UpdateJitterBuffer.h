@@ -0,0 +1,121 @@
+// Copyright (c) 2022 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ByteSpan.h"
+
+// Holds received parameter updates in buckets indexed by the time step they were sent at
+// and plays a bucket out once the synchronized time has advanced past it plus a delay.
+// Evens out uneven arrival on congested networks, only used by the game thread.
+class UpdateJitterBuffer
+{
+public:
+	enum class Placement { Buffered, Late, Early };
+
+	UpdateJitterBuffer() : timesteps(0), playedTime(0), lateCount(0), earlyCount(0) { }
+
+	// Drops all buffered updates, playedTime is the step treated as already played out
+	void Reset(int pTimesteps, uint8_t pPlayedTime)
+	{
+		timesteps = pTimesteps;
+		playedTime = pPlayedTime;
+		buckets.resize(timesteps);
+		for (Bucket& bucket : buckets)
+			bucket.Clear();
+		lateCount = 0;
+		earlyCount = 0;
+	}
+
+	bool IsEnabled() const { return timesteps > 0; }
+
+	// Copies the message into the bucket of its time step. Messages for a step that has
+	// already been played out are Late, messages more than maxAhead steps after the last
+	// played step are Early (the sender clock is off), both are not kept and should be
+	// applied right away by the caller. Time steps outside the ring count as Early as well.
+	Placement Add(uint8_t time, ByteSpan message, int maxAhead)
+	{
+		if (time >= timesteps)
+		{
+			earlyCount++;
+			return Placement::Early;
+		}
+		const int ahead = StepsBetween(playedTime, time);
+		if (ahead == 0 || ahead > timesteps / 2)
+		{
+			lateCount++;
+			return Placement::Late;
+		}
+		if (ahead > maxAhead)
+		{
+			earlyCount++;
+			return Placement::Early;
+		}
+		buckets[time].Add(message);
+		return Placement::Buffered;
+	}
+
+	// Calls play(ByteSpan) for every update of the steps after the last played one up to
+	// and including playoutTime, in time step and arrival order. A playout time behind the
+	// last played step (the clock has been set back) only moves the playout point.
+	template <typename Func>
+	void PlayOut(uint8_t playoutTime, Func&& play)
+	{
+		if (!IsEnabled())
+			return;
+		const int steps = StepsBetween(playedTime, playoutTime);
+		if (steps <= timesteps / 2)
+		{
+			for (int i = 1; i <= steps; i++)
+			{
+				Bucket& bucket = buckets[(playedTime + i) % timesteps];
+				size_t begin = 0;
+				for (size_t end : bucket.ends)
+				{
+					play(ByteSpan(bucket.bytes.data() + begin, end - begin));
+					begin = end;
+				}
+				bucket.Clear();
+			}
+		}
+		playedTime = playoutTime;
+	}
+
+	int64_t GetLateCount() const { return lateCount; }
+	int64_t GetEarlyCount() const { return earlyCount; }
+
+private:
+	// All messages of one time step back to back, cleared buckets keep their capacity
+	struct Bucket
+	{
+		std::vector<uint8_t> bytes;
+		std::vector<size_t> ends;
+
+		void Add(ByteSpan message)
+		{
+			bytes.insert(bytes.end(), message.Data(), message.Data() + message.Size());
+			ends.push_back(bytes.size());
+		}
+
+		void Clear()
+		{
+			bytes.clear();
+			ends.clear();
+		}
+	};
+
+	// Steps from a forward to b on the time step ring
+	int StepsBetween(uint8_t a, uint8_t b) const
+	{
+		return ((int)b - (int)a + timesteps) % timesteps;
+	}
+
+	std::vector<Bucket> buckets;
+	int timesteps;
+	uint8_t playedTime;
+	int64_t lateCount;
+	int64_t earlyCount;
+};
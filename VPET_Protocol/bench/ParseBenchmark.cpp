@@ -0,0 +1,167 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! Dispatch cost of received parameter updates in the Unreal plugin, before and after ByteSpan.
+//! "vector copies" rebuilds the former path: a sub vector per parameter, passed by value to
+//! ParseMessage and on to the parse callback. "byte spans" is the current ParseParameterUpdate.
+//! Usage: VPETParseBenchmark [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "ByteSpan.h"
+#include "VPETProtocol.h"
+
+using namespace VPET::Protocol;
+
+namespace
+{
+	const int PARAMETERS_PER_MESSAGE = 500;
+
+	// Keeps the optimizer from dropping the measured work
+	volatile uint64_t g_sink = 0;
+	volatile float g_floatSink = 0;
+
+	template <typename F>
+	double run(const char* name, int iterations, size_t bytesPerIteration, F&& work)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+			work(i);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		const double nsPerIteration = seconds * 1e9 / iterations;
+		const double megabytesPerSecond = bytesPerIteration * (double)iterations / seconds / (1024.0 * 1024.0);
+		std::printf("%-32s %10.1f ns/msg %10.1f MB/s\n", name, nsPerIteration, megabytesPerSecond);
+		return nsPerIteration;
+	}
+
+	// Former parse callback and AbstractParameter::ParseMessage, both took the vector by value
+	void UpdatePositionVector(std::vector<uint8_t> kMsg)
+	{
+		float lX = *reinterpret_cast<float*>(&kMsg[0]);
+		float lY = *reinterpret_cast<float*>(&kMsg[4]);
+		float lZ = *reinterpret_cast<float*>(&kMsg[8]);
+		g_floatSink = lX + lY + lZ;
+	}
+
+	void (*parseVector)(std::vector<uint8_t>) = &UpdatePositionVector;
+
+	void ParseMessageVector(std::vector<uint8_t> kMsg)
+	{
+		parseVector(kMsg);
+	}
+
+	void ParseParameterUpdateVector(const uint8_t* kMsg, size_t kSize)
+	{
+		for (size_t i = 3; i < kSize; )
+		{
+			int16_t objectID = *reinterpret_cast<const int16_t*>(&kMsg[i+1]);
+			int length = *&kMsg[i+6];
+			g_sink += objectID;
+
+			std::vector<uint8_t> subMsg = std::vector<uint8_t>(kMsg+i+7, kMsg+i+length);
+			ParseMessageVector(subMsg);
+			i += length;
+		}
+	}
+
+	// Current parse callback and ParseMessage, a view into the received frame
+	void UpdatePositionSpan(ByteSpan kMsg)
+	{
+		float lX, lY, lZ;
+		if (!kMsg.Read(0, lX) || !kMsg.Read(4, lY) || !kMsg.Read(8, lZ))
+			return;
+		g_floatSink = lX + lY + lZ;
+	}
+
+	void (*parseSpan)(ByteSpan) = &UpdatePositionSpan;
+
+	void ParseMessageSpan(ByteSpan kMsg)
+	{
+		parseSpan(kMsg);
+	}
+
+	void ParseParameterUpdateSpan(ByteSpan kMsg)
+	{
+		for (size_t i = 3; i < kMsg.Size(); )
+		{
+			int16_t objectID, paramID;
+			uint8_t length;
+			if (!kMsg.Read(i+1, objectID) || !kMsg.Read(i+3, paramID) || !kMsg.Read(i+6, length) ||
+				length < 7 || !kMsg.Contains(i, length))
+				return;
+			g_sink += objectID;
+
+			ParseMessageSpan(kMsg.Sub(i+7, length-7));
+			i += length;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+	if (iterations <= 0)
+	{
+		std::fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	// 500 vector3 parameters, the shape of a busy multi user frame
+	const float position[3] = { 1.0f, 2.0f, 3.0f };
+	const size_t messageSize = parameterMessageSize(PARAMETERS_PER_MESSAGE, PARAMETERS_PER_MESSAGE * sizeof(position));
+	std::vector<uint8_t> message(messageSize);
+
+	Header header;
+	header.clientID = 1;
+	header.type = MessageType::PARAMETERUPDATE;
+	ParameterMessageWriter writer(message.data(), message.size(), header);
+	for (uint16_t p = 0; p < PARAMETERS_PER_MESSAGE; p++)
+		writer.addParameter(p, 0, 0, ParameterType::VECTOR3, position, sizeof(position));
+
+	const double vectorNs = run("dispatch with vector copies", iterations, messageSize, [&](int) {
+		ParseParameterUpdateVector(message.data(), message.size());
+	});
+
+	const double spanNs = run("dispatch with byte spans", iterations, messageSize, [&](int) {
+		ParseParameterUpdateSpan(ByteSpan(message.data(), message.size()));
+	});
+
+	std::printf("%-32s %10.1fx\n", "speedup", vectorNs / spanNs);
+	return 0;
+}
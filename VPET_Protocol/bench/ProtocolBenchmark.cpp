@@ -0,0 +1,126 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! Encode/decode throughput of the VPET message layouts.
+//! Usage: VPETProtocolBenchmark [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "VPETProtocol.h"
+
+using namespace VPET::Protocol;
+
+namespace
+{
+	const int PARAMETERS_PER_MESSAGE = 500;
+
+	// Keeps the optimizer from dropping the measured work
+	volatile uint64_t g_sink = 0;
+
+	template <typename F>
+	void run(const char* name, int iterations, size_t bytesPerIteration, F&& work)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+			work(i);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		const double nsPerIteration = seconds * 1e9 / iterations;
+		const double megabytesPerSecond = bytesPerIteration * (double)iterations / seconds / (1024.0 * 1024.0);
+		std::printf("%-32s %10.1f ns/msg %10.1f MB/s\n", name, nsPerIteration, megabytesPerSecond);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+	if (iterations <= 0)
+	{
+		std::fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	// 500 vector3 parameters, the shape of a busy multi user frame
+	const float position[3] = { 1.0f, 2.0f, 3.0f };
+	const size_t messageSize = parameterMessageSize(PARAMETERS_PER_MESSAGE, PARAMETERS_PER_MESSAGE * sizeof(position));
+	std::vector<uint8_t> message(messageSize);
+
+	Header header;
+	header.clientID = 1;
+	header.type = MessageType::PARAMETERUPDATE;
+
+	run("encode parameter update", iterations, messageSize, [&](int i) {
+		header.time = static_cast<uint8_t>(i);
+		ParameterMessageWriter writer(message.data(), message.size(), header);
+		for (uint16_t p = 0; p < PARAMETERS_PER_MESSAGE; p++)
+			writer.addParameter(254, p, 0, ParameterType::VECTOR3, position, sizeof(position));
+		g_sink += writer.size();
+	});
+
+	run("decode parameter update", iterations, messageSize, [&](int) {
+		ParameterMessageReader reader(message.data(), message.size());
+		ParameterRecord record;
+		uint64_t sum = 0;
+		while (reader.next(record))
+			sum += record.objectID + record.dataSize;
+		g_sink += sum;
+	});
+
+	uint8_t lock[LOCK_MESSAGE_SIZE];
+	LockMessage lockMessage;
+	lockMessage.header.type = MessageType::LOCK;
+	lockMessage.objectID = 42;
+	lockMessage.locked = true;
+
+	run("encode + decode lock", iterations * 100, LOCK_MESSAGE_SIZE, [&](int i) {
+		lockMessage.header.time = static_cast<uint8_t>(i);
+		encodeLock(lock, sizeof(lock), lockMessage);
+		LockMessage decoded;
+		decodeLock(lock, sizeof(lock), decoded);
+		g_sink += decoded.objectID;
+	});
+
+	uint8_t control[CONTROL_MESSAGE_SIZE];
+	run("encode + decode sync", iterations * 100, CONTROL_MESSAGE_SIZE, [&](int i) {
+		encodeControl(control, sizeof(control), 1, static_cast<uint8_t>(i), MessageType::SYNC);
+		Header decoded;
+		decodeHeader(control, sizeof(control), decoded);
+		g_sink += decoded.time;
+	});
+
+	return 0;
+}
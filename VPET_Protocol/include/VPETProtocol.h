@@ -0,0 +1,445 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef VPET_PROTOCOL_H
+#define VPET_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//! Wire format of the VPET synchronization messages.
+//! Header only and free of engine types, shared by the Unreal plugins and the sync tools.
+//! Multi byte values are little endian like on every VPET client.
+namespace VPET
+{
+namespace Protocol
+{
+	enum class MessageType : uint8_t
+	{
+		PARAMETERUPDATE, LOCK, // node
+		SYNC, PING, RESENDUPDATE, // sync
+		UNDOREDOADD, RESETOBJECT, // undo redo
+		DATAHUB
+	};
+
+	enum class ParameterType : uint8_t { NONE, ACTION, BOOL, INT, FLOAT, VECTOR2, VECTOR3, VECTOR4, QUATERNION, COLOR, STRING, LIST, UNKNOWN = 100 };
+
+	//! [clientID, time, type]
+	static const size_t HEADER_SIZE = 3;
+	//! Set in the type byte if the header is followed by the 16 bit sequence number of the sender.
+	//! Only parameter updates are sequenced, clients without sequence support skip these messages.
+	static const uint8_t SEQUENCE_FLAG = 0x80;
+	//! [clientID, time, type | SEQUENCE_FLAG, sequence(2)]
+	static const size_t SEQUENCED_HEADER_SIZE = HEADER_SIZE + 2;
+	//! [sceneID, objectID(2), parameterID(2), type, length] followed by the data, length includes these 7 bytes
+	static const size_t PARAMETER_RECORD_SIZE = 7;
+	static const size_t MAX_PARAMETER_DATA_SIZE = 255 - PARAMETER_RECORD_SIZE;
+	//! header, sceneID, objectID(2), lock state
+	static const size_t LOCK_MESSAGE_SIZE = HEADER_SIZE + 4;
+	//! header, sceneID, objectID(2)
+	static const size_t RESET_MESSAGE_SIZE = HEADER_SIZE + 3;
+	//! SYNC, PING and RESENDUPDATE carry only the header
+	static const size_t CONTROL_MESSAGE_SIZE = HEADER_SIZE;
+	//! RESENDUPDATE for a range of sequenced updates: header, target clientID, first sequence(2), count
+	static const size_t RESEND_REQUEST_SIZE = HEADER_SIZE + 4;
+
+	struct Header
+	{
+		uint8_t clientID = 0;
+		uint8_t time = 0;
+		MessageType type = MessageType::PARAMETERUPDATE;
+		bool sequenced = false;
+		uint16_t sequence = 0;
+	};
+
+	//! Decoded parameter record, data points into the decoded message
+	struct ParameterRecord
+	{
+		uint8_t sceneID = 0;
+		uint16_t objectID = 0;
+		uint16_t parameterID = 0;
+		ParameterType type = ParameterType::NONE;
+		const uint8_t* data = nullptr;
+		size_t dataSize = 0;
+	};
+
+	struct LockMessage
+	{
+		Header header;
+		uint8_t sceneID = 0;
+		uint16_t objectID = 0;
+		bool locked = false;
+	};
+
+	struct ResetMessage
+	{
+		Header header;
+		uint8_t sceneID = 0;
+		uint16_t objectID = 0;
+	};
+
+	//! Asks the sender targetID to publish its updates firstSequence to firstSequence + count - 1 again
+	struct ResendRequest
+	{
+		Header header;
+		uint8_t targetID = 0;
+		uint16_t firstSequence = 0;
+		uint8_t count = 0;
+	};
+
+	inline void storeU16(uint8_t* out, uint16_t value)
+	{
+		out[0] = static_cast<uint8_t>(value & 0xff);
+		out[1] = static_cast<uint8_t>(value >> 8);
+	}
+
+	inline uint16_t loadU16(const uint8_t* in)
+	{
+		return static_cast<uint16_t>(in[0] | (in[1] << 8));
+	}
+
+	inline size_t headerSize(const Header& header)
+	{
+		return header.sequenced ? SEQUENCED_HEADER_SIZE : HEADER_SIZE;
+	}
+
+	//! Sequence numbers wrap, positive if a is newer than b
+	inline int16_t sequenceDelta(uint16_t a, uint16_t b)
+	{
+		return static_cast<int16_t>(static_cast<uint16_t>(a - b));
+	}
+
+	//! Writes the 3 byte header, messages with fixed offsets never carry a sequence
+	inline void storeHeader(uint8_t* out, const Header& header)
+	{
+		out[0] = header.clientID;
+		out[1] = header.time;
+		out[2] = static_cast<uint8_t>(header.type);
+	}
+
+	// Encoding, all functions return the number of bytes written or 0 if out is too small
+
+	inline size_t encodeHeader(uint8_t* out, size_t capacity, const Header& header)
+	{
+		const size_t size = headerSize(header);
+		if (capacity < size)
+			return 0;
+		storeHeader(out, header);
+		if (header.sequenced)
+		{
+			out[2] |= SEQUENCE_FLAG;
+			storeU16(out + HEADER_SIZE, header.sequence);
+		}
+		return size;
+	}
+
+	//! SYNC, PING and RESENDUPDATE messages
+	inline size_t encodeControl(uint8_t* out, size_t capacity, uint8_t clientID, uint8_t time, MessageType type)
+	{
+		Header header;
+		header.clientID = clientID;
+		header.time = time;
+		header.type = type;
+		return encodeHeader(out, capacity, header);
+	}
+
+	inline size_t encodeLock(uint8_t* out, size_t capacity, const LockMessage& message)
+	{
+		if (capacity < LOCK_MESSAGE_SIZE)
+			return 0;
+		storeHeader(out, message.header);
+		out[3] = message.sceneID;
+		storeU16(out + 4, message.objectID);
+		out[6] = message.locked ? 1 : 0;
+		return LOCK_MESSAGE_SIZE;
+	}
+
+	inline size_t encodeReset(uint8_t* out, size_t capacity, const ResetMessage& message)
+	{
+		if (capacity < RESET_MESSAGE_SIZE)
+			return 0;
+		storeHeader(out, message.header);
+		out[3] = message.sceneID;
+		storeU16(out + 4, message.objectID);
+		return RESET_MESSAGE_SIZE;
+	}
+
+	inline size_t encodeResendRequest(uint8_t* out, size_t capacity, const ResendRequest& request)
+	{
+		if (capacity < RESEND_REQUEST_SIZE)
+			return 0;
+		storeHeader(out, request.header);
+		out[3] = request.targetID;
+		storeU16(out + 4, request.firstSequence);
+		out[6] = request.count;
+		return RESEND_REQUEST_SIZE;
+	}
+
+	inline size_t parameterMessageSize(size_t parameterCount, size_t totalDataSize, bool sequenced = false)
+	{
+		return (sequenced ? SEQUENCED_HEADER_SIZE : HEADER_SIZE) + parameterCount * PARAMETER_RECORD_SIZE + totalDataSize;
+	}
+
+	//! Builds a PARAMETERUPDATE or UNDOREDOADD message in a caller owned buffer.
+	//! addParameter writes the record and returns where its data goes, so values
+	//! can be serialized in place.
+	class ParameterMessageWriter
+	{
+	public:
+		ParameterMessageWriter(uint8_t* out, size_t capacity, const Header& header) :
+			m_out(out),
+			m_capacity(capacity),
+			m_size(0),
+			m_failed(false)
+		{
+			m_size = encodeHeader(out, capacity, header);
+			m_failed = m_size == 0;
+		}
+
+		//! nullptr if the record does not fit, the writer is failed from then on
+		uint8_t* addParameter(uint8_t sceneID, uint16_t objectID, uint16_t parameterID, ParameterType type, size_t dataSize)
+		{
+			if (m_failed || dataSize > MAX_PARAMETER_DATA_SIZE || m_capacity - m_size < PARAMETER_RECORD_SIZE + dataSize)
+			{
+				m_failed = true;
+				return nullptr;
+			}
+			uint8_t* record = m_out + m_size;
+			record[0] = sceneID;
+			storeU16(record + 1, objectID);
+			storeU16(record + 3, parameterID);
+			record[5] = static_cast<uint8_t>(type);
+			record[6] = static_cast<uint8_t>(PARAMETER_RECORD_SIZE + dataSize);
+			m_size += PARAMETER_RECORD_SIZE + dataSize;
+			return record + PARAMETER_RECORD_SIZE;
+		}
+
+		bool addParameter(uint8_t sceneID, uint16_t objectID, uint16_t parameterID, ParameterType type, const void* data, size_t dataSize)
+		{
+			uint8_t* target = addParameter(sceneID, objectID, parameterID, type, dataSize);
+			if (!target)
+				return false;
+			if (dataSize > 0)
+				std::memcpy(target, data, dataSize);
+			return true;
+		}
+
+		size_t size() const { return m_failed ? 0 : m_size; }
+		bool failed() const { return m_failed; }
+
+	private:
+		uint8_t* m_out;
+		size_t m_capacity;
+		size_t m_size;
+		bool m_failed;
+	};
+
+	// Decoding, all functions return false if the message is too short or of another type
+
+	inline bool decodeHeader(const uint8_t* data, size_t size, Header& header)
+	{
+		if (!data || size < HEADER_SIZE)
+			return false;
+		header.clientID = data[0];
+		header.time = data[1];
+		header.type = static_cast<MessageType>(data[2] & ~SEQUENCE_FLAG);
+		header.sequenced = (data[2] & SEQUENCE_FLAG) != 0;
+		header.sequence = 0;
+		if (header.sequenced)
+		{
+			if (size < SEQUENCED_HEADER_SIZE)
+				return false;
+			header.sequence = loadU16(data + HEADER_SIZE);
+		}
+		return true;
+	}
+
+	inline bool decodeLock(const uint8_t* data, size_t size, LockMessage& message)
+	{
+		if (size < LOCK_MESSAGE_SIZE || !decodeHeader(data, size, message.header) || message.header.type != MessageType::LOCK || message.header.sequenced)
+			return false;
+		message.sceneID = data[3];
+		message.objectID = loadU16(data + 4);
+		message.locked = data[6] != 0;
+		return true;
+	}
+
+	inline bool decodeReset(const uint8_t* data, size_t size, ResetMessage& message)
+	{
+		if (size < RESET_MESSAGE_SIZE || !decodeHeader(data, size, message.header) || message.header.type != MessageType::RESETOBJECT || message.header.sequenced)
+			return false;
+		message.sceneID = data[3];
+		message.objectID = loadU16(data + 4);
+		return true;
+	}
+
+	//! Only the sequenced form, a plain RESENDUPDATE header returns false
+	inline bool decodeResendRequest(const uint8_t* data, size_t size, ResendRequest& request)
+	{
+		if (size < RESEND_REQUEST_SIZE || !decodeHeader(data, size, request.header) || request.header.type != MessageType::RESENDUPDATE || request.header.sequenced)
+			return false;
+		request.targetID = data[3];
+		request.firstSequence = loadU16(data + 4);
+		request.count = data[6];
+		return true;
+	}
+
+	//! Walks the records of a PARAMETERUPDATE or UNDOREDOADD message without copying.
+	//! next returns false at the end or on a malformed record, failed tells them apart.
+	class ParameterMessageReader
+	{
+	public:
+		ParameterMessageReader(const uint8_t* data, size_t size) :
+			m_data(data),
+			m_size(size),
+			m_offset(HEADER_SIZE),
+			m_failed(!data || size < HEADER_SIZE)
+		{
+			if (!m_failed && (data[2] & SEQUENCE_FLAG))
+			{
+				m_offset = SEQUENCED_HEADER_SIZE;
+				m_failed = size < SEQUENCED_HEADER_SIZE;
+			}
+		}
+
+		bool next(ParameterRecord& record)
+		{
+			if (m_failed || m_offset >= m_size)
+				return false;
+			const size_t left = m_size - m_offset;
+			const uint8_t* in = m_data + m_offset;
+			if (left < PARAMETER_RECORD_SIZE || in[6] < PARAMETER_RECORD_SIZE || in[6] > left)
+			{
+				m_failed = true;
+				return false;
+			}
+			record.sceneID = in[0];
+			record.objectID = loadU16(in + 1);
+			record.parameterID = loadU16(in + 3);
+			record.type = static_cast<ParameterType>(in[5]);
+			record.data = in + PARAMETER_RECORD_SIZE;
+			record.dataSize = in[6] - PARAMETER_RECORD_SIZE;
+			m_offset += in[6];
+			return true;
+		}
+
+		//! Byte offset of the next record
+		size_t offset() const { return m_offset; }
+		bool failed() const { return m_failed; }
+
+	private:
+		const uint8_t* m_data;
+		size_t m_size;
+		size_t m_offset;
+		bool m_failed;
+	};
+
+	//! Sequence numbers received from one sender, finds gaps and duplicates.
+	//! Remembers the last WINDOW sequence numbers below the newest one.
+	class SequenceTracker
+	{
+	public:
+		static const int WINDOW = 64;
+
+		enum class Result
+		{
+			FIRST,      //!< first message of the sender or the sender restarted
+			IN_ORDER,   //!< the next expected sequence
+			GAP,        //!< newer than expected, missing is set to the skipped range
+			RECOVERED,  //!< older than the newest, fills a gap
+			DUPLICATE   //!< received before
+		};
+
+		Result add(uint16_t sequence, uint16_t& missingFirst, int& missingCount)
+		{
+			missingCount = 0;
+			if (!m_started)
+			{
+				m_started = true;
+				m_newest = sequence;
+				m_received = 1;
+				return Result::FIRST;
+			}
+
+			const int delta = sequenceDelta(sequence, m_newest);
+			if (delta == 0)
+				return Result::DUPLICATE;
+
+			// far behind the window, the sender counts from the start again
+			if (delta <= -WINDOW)
+			{
+				m_newest = sequence;
+				m_received = 1;
+				return Result::FIRST;
+			}
+
+			if (delta < 0)
+			{
+				const uint64_t bit = uint64_t(1) << (-delta);
+				if (m_received & bit)
+					return Result::DUPLICATE;
+				m_received |= bit;
+				return Result::RECOVERED;
+			}
+
+			m_received = (delta >= WINDOW ? 0 : m_received << delta) | 1;
+			m_newest = sequence;
+			if (delta == 1)
+				return Result::IN_ORDER;
+
+			// only the part still inside the window can be recovered
+			missingCount = delta - 1 < WINDOW - 1 ? delta - 1 : WINDOW - 1;
+			missingFirst = static_cast<uint16_t>(sequence - missingCount);
+			return Result::GAP;
+		}
+
+		void reset()
+		{
+			m_started = false;
+			m_newest = 0;
+			m_received = 0;
+		}
+
+	private:
+		bool m_started = false;
+		uint16_t m_newest = 0;
+		//! bit n is set if m_newest - n has been received
+		uint64_t m_received = 0;
+	};
+}
+}
+
+#endif // VPET_PROTOCOL_H
@@ -0,0 +1,72 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef VPET_SCENEPROTOCOL_H
+#define VPET_SCENEPROTOCOL_H
+
+#include <string>
+
+//! Requests and node type ids of the scene distribution socket.
+//! Shared by the Unreal plugins and the USD scene distributor, so servers and
+//! clients agree on the request strings and on the type values in the node stream.
+namespace VPET
+{
+namespace Protocol
+{
+namespace Scene
+{
+	//! Type id in front of every node of the "nodes" reply
+	enum NodeType { GROUP, GEO, LIGHT, CAMERA, SKINNEDMESH, CHARACTER, INSTANCER };
+	//! Only sent in the "instancednodes" reply, older clients stop at CHARACTER
+	static const int LAST_LEGACY_NODE_TYPE = CHARACTER;
+
+	enum LightType { SPOT, DIRECTIONAL, POINT, AREA, RECTANGLE, DISC, NONE };
+
+	//! Requests of the scene distribution socket, REQUEST_UNKNOWN stands for any other string
+	enum RequestType { REQUEST_HEADER, REQUEST_NODES, REQUEST_OBJECTS, REQUEST_CHARACTERS, REQUEST_TEXTURES, REQUEST_MATERIALS, REQUEST_INSTANCES, REQUEST_PROGRESS, REQUEST_STATS, REQUEST_INSTANCED_NODES, REQUEST_UNKNOWN, REQUEST_COUNT };
+	static const char* const requestNames[REQUEST_COUNT] = { "header", "nodes", "objects", "characters", "textures", "materials", "instances", "progress", "stats", "instancednodes", "unknown" };
+
+	inline RequestType requestTypeFromString(const std::string& request)
+	{
+		for (int i = 0; i < REQUEST_UNKNOWN; i++)
+			if (request == requestNames[i])
+				return static_cast<RequestType>(i);
+		return REQUEST_UNKNOWN;
+	}
+}
+}
+}
+
+#endif // VPET_SCENEPROTOCOL_H
@@ -0,0 +1,351 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef VPET_SESSIONLOG_H
+#define VPET_SESSIONLOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//! Append-only binary log of VPET messages for recording and replaying sessions.
+//! File: 16 byte header ["VPETLOG", version, start time in unix microseconds (8)],
+//! then records [time since start in ns (8), size (4), direction (1), message].
+//! Written through a growing memory mapping, the unused tail is zero and a
+//! record of size 0 ends the log, so a log cut off by a crash stays readable.
+namespace VPET
+{
+namespace Protocol
+{
+	enum class LogDirection : uint8_t { INBOUND, OUTBOUND };
+
+	static const uint8_t SESSION_LOG_VERSION = 1;
+	static const size_t SESSION_LOG_HEADER_SIZE = 16;
+	static const size_t SESSION_LOG_RECORD_SIZE = 13;
+
+	struct LogRecord
+	{
+		uint64_t timeNanos = 0;
+		LogDirection direction = LogDirection::INBOUND;
+		const uint8_t* data = nullptr;
+		uint32_t size = 0;
+	};
+
+	//! Platform file mapping, grows by remapping
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile() { close(0); }
+
+		//! Creates or truncates the file and maps capacity bytes for writing
+		bool create(const std::string& path, size_t capacity)
+		{
+#ifdef _WIN32
+			m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (m_file == INVALID_HANDLE_VALUE)
+				return false;
+#else
+			m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+			if (m_fd < 0)
+				return false;
+#endif
+			m_writable = true;
+			return remap(capacity);
+		}
+
+		//! Maps an existing file read only
+		bool openRead(const std::string& path)
+		{
+#ifdef _WIN32
+			m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (m_file == INVALID_HANDLE_VALUE)
+				return false;
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(m_file, &size))
+				return false;
+			m_writable = false;
+			return size.QuadPart > 0 && remap(size_t(size.QuadPart));
+#else
+			m_fd = ::open(path.c_str(), O_RDONLY);
+			if (m_fd < 0)
+				return false;
+			struct stat info;
+			if (fstat(m_fd, &info) != 0)
+				return false;
+			m_writable = false;
+			return info.st_size > 0 && remap(size_t(info.st_size));
+#endif
+		}
+
+		//! Unmaps and maps again with the new size, the file grows with it when writable
+		bool remap(size_t capacity)
+		{
+			unmap();
+#ifdef _WIN32
+			const DWORD protect = m_writable ? PAGE_READWRITE : PAGE_READONLY;
+			m_mapping = CreateFileMappingA(m_file, nullptr, protect, DWORD(uint64_t(capacity) >> 32), DWORD(capacity & 0xffffffff), nullptr);
+			if (!m_mapping)
+				return false;
+			void* view = MapViewOfFile(m_mapping, m_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, capacity);
+			if (!view)
+				return false;
+#else
+			if (m_writable && ftruncate(m_fd, off_t(capacity)) != 0)
+				return false;
+			void* view = mmap(nullptr, capacity, m_writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_fd, 0);
+			if (view == MAP_FAILED)
+				return false;
+#endif
+			m_data = static_cast<uint8_t*>(view);
+			m_capacity = capacity;
+			return true;
+		}
+
+		//! Unmaps, a writable file is cut to usedSize
+		void close(size_t usedSize)
+		{
+			unmap();
+#ifdef _WIN32
+			if (m_file != INVALID_HANDLE_VALUE)
+			{
+				if (m_writable)
+				{
+					LARGE_INTEGER end;
+					end.QuadPart = LONGLONG(usedSize);
+					SetFilePointerEx(m_file, end, nullptr, FILE_BEGIN);
+					SetEndOfFile(m_file);
+				}
+				CloseHandle(m_file);
+				m_file = INVALID_HANDLE_VALUE;
+			}
+#else
+			if (m_fd >= 0)
+			{
+				// a failed truncate only leaves the zero tail, readers stop there
+				const int truncated = m_writable ? ftruncate(m_fd, off_t(usedSize)) : 0;
+				(void)truncated;
+				::close(m_fd);
+				m_fd = -1;
+			}
+#endif
+		}
+
+		uint8_t* data() const { return m_data; }
+		size_t capacity() const { return m_capacity; }
+
+	private:
+		void unmap()
+		{
+			if (!m_data)
+				return;
+#ifdef _WIN32
+			UnmapViewOfFile(m_data);
+			CloseHandle(m_mapping);
+			m_mapping = nullptr;
+#else
+			munmap(m_data, m_capacity);
+#endif
+			m_data = nullptr;
+			m_capacity = 0;
+		}
+
+#ifdef _WIN32
+		HANDLE m_file = INVALID_HANDLE_VALUE;
+		HANDLE m_mapping = nullptr;
+#else
+		int m_fd = -1;
+#endif
+		bool m_writable = false;
+		uint8_t* m_data = nullptr;
+		size_t m_capacity = 0;
+	};
+
+	//! Thread safe, the receiver and the sender thread append to the same log
+	class SessionLogWriter
+	{
+	public:
+		//! The mapping starts with chunkSize bytes and doubles when full
+		bool open(const std::string& path, size_t chunkSize = size_t(16) << 20)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_file.create(path, chunkSize < 4096 ? 4096 : chunkSize))
+			{
+				m_file.close(0);
+				return false;
+			}
+			m_start = std::chrono::steady_clock::now();
+			const uint64_t unixMicros = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+			uint8_t* out = m_file.data();
+			std::memcpy(out, "VPETLOG", 7);
+			out[7] = SESSION_LOG_VERSION;
+			std::memcpy(out + 8, &unixMicros, sizeof(unixMicros));
+			m_size = SESSION_LOG_HEADER_SIZE;
+			m_records = 0;
+			m_failed = 0;
+			m_open = true;
+			return true;
+		}
+
+		//! False if the log is closed or could not grow, the record is then lost
+		bool append(LogDirection direction, const void* data, size_t size)
+		{
+			const uint64_t nanos = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_open || size == 0 || size > 0xffffffffu)
+			{
+				m_failed++;
+				return false;
+			}
+			const size_t needed = m_size + SESSION_LOG_RECORD_SIZE + size;
+			if (needed > m_file.capacity())
+			{
+				size_t capacity = m_file.capacity() * 2;
+				while (capacity < needed)
+					capacity *= 2;
+				if (!m_file.remap(capacity))
+				{
+					// nothing can be written anymore, keep what is on disk
+					m_file.close(m_size);
+					m_open = false;
+					m_failed++;
+					return false;
+				}
+			}
+			uint8_t* out = m_file.data() + m_size;
+			const uint32_t size32 = uint32_t(size);
+			std::memcpy(out, &nanos, sizeof(nanos));
+			std::memcpy(out + 8, &size32, sizeof(size32));
+			out[12] = static_cast<uint8_t>(direction);
+			std::memcpy(out + SESSION_LOG_RECORD_SIZE, data, size);
+			m_size = needed;
+			m_records++;
+			return true;
+		}
+
+		void close()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_open)
+				m_file.close(m_size);
+			m_open = false;
+		}
+
+		~SessionLogWriter() { close(); }
+
+		bool isOpen() const { return m_open.load(); }
+		uint64_t recordCount() const { return m_records; }
+		uint64_t failedCount() const { return m_failed; }
+		size_t size() const { return m_size; }
+
+	private:
+		std::mutex m_mutex;
+		MappedFile m_file;
+		std::chrono::steady_clock::time_point m_start;
+		size_t m_size = 0;
+		uint64_t m_records = 0;
+		uint64_t m_failed = 0;
+		std::atomic<bool> m_open{ false };
+	};
+
+	//! Reads a log through a read only mapping, records point into the mapping
+	class SessionLogReader
+	{
+	public:
+		bool open(const std::string& path)
+		{
+			if (!m_file.openRead(path) || m_file.capacity() < SESSION_LOG_HEADER_SIZE)
+				return false;
+			const uint8_t* in = m_file.data();
+			if (std::memcmp(in, "VPETLOG", 7) != 0 || in[7] != SESSION_LOG_VERSION)
+				return false;
+			std::memcpy(&m_startUnixMicros, in + 8, sizeof(m_startUnixMicros));
+			m_offset = SESSION_LOG_HEADER_SIZE;
+			return true;
+		}
+
+		//! False at the end of the log or at a truncated record
+		bool next(LogRecord& record)
+		{
+			const size_t end = m_file.capacity();
+			if (!m_file.data() || end - m_offset < SESSION_LOG_RECORD_SIZE)
+				return false;
+			const uint8_t* in = m_file.data() + m_offset;
+			uint32_t size = 0;
+			std::memcpy(&size, in + 8, sizeof(size));
+			if (size == 0 || end - m_offset - SESSION_LOG_RECORD_SIZE < size)
+				return false;
+			std::memcpy(&record.timeNanos, in, sizeof(record.timeNanos));
+			record.direction = static_cast<LogDirection>(in[12]);
+			record.data = in + SESSION_LOG_RECORD_SIZE;
+			record.size = size;
+			m_offset += SESSION_LOG_RECORD_SIZE + size;
+			return true;
+		}
+
+		void rewind() { m_offset = SESSION_LOG_HEADER_SIZE; }
+
+		uint64_t startUnixMicros() const { return m_startUnixMicros; }
+
+	private:
+		MappedFile m_file;
+		size_t m_offset = SESSION_LOG_HEADER_SIZE;
+		uint64_t m_startUnixMicros = 0;
+	};
+}
+}
+
+#endif // VPET_SESSIONLOG_H
@@ -0,0 +1,230 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! ClockSync of the Unreal plugin against a simulated sync server: convergence by slewing,
+//! offsets on both sides of half the time step ring, a server restart that steps the clock
+//! and the selection of the least delayed sample of the window.
+
+#include <cmath>
+#include <cstdint>
+#include <deque>
+
+#include "ClockSync.h"
+#include "TestCheck.h"
+
+namespace
+{
+	const int TIMESTEPS = 128;
+	const int FRAMERATE = 60;
+
+	// Server clock in steps that runs at the framerate, pings every few ticks with varying
+	// and asymmetric network delays
+	class Simulation
+	{
+	public:
+		explicit Simulation(double pServerStart) : serverStart(pServerStart)
+		{
+			clock.Reset(TIMESTEPS, FRAMERATE, 0.0);
+		}
+
+		// Restarts the server clock at the given step, at the current time
+		void RestartServer(double steps)
+		{
+			serverStart = steps - now * FRAMERATE;
+		}
+
+		// Runs the ticks, returns the step difference local - server after the last one
+		int Run(int ticks)
+		{
+			int difference = 0;
+			for (int i = 0; i < ticks; i++, tick++)
+			{
+				now = (double)tick / FRAMERATE;
+				const uint8_t local = clock.Advance(now);
+				difference = Difference(local, ServerStep(now));
+
+				if (tick % 6 == 0)
+				{
+					// 8 to 40 ms round trip, the request takes 30 to 70 percent of it
+					const double rtt = 0.008 + 0.032 * Noise(tick);
+					const double sent = now + 0.001;
+					const double out = rtt * (0.3 + 0.4 * Noise(tick + 7));
+					pending.push_back({ sent, sent + rtt, ServerStep(sent + out) });
+				}
+
+				// replies that arrive before the next tick
+				const double next = (double)(tick + 1) / FRAMERATE;
+				while (!pending.empty() && pending.front().received < next)
+				{
+					clock.AddPing(pending.front().sent, pending.front().received, pending.front().serverTime);
+					pending.pop_front();
+				}
+			}
+			return difference;
+		}
+
+		ClockSync clock;
+
+	private:
+		struct Reply
+		{
+			double sent;
+			double received;
+			uint8_t serverTime;
+		};
+
+		uint8_t ServerStep(double seconds) const
+		{
+			const double steps = serverStart + seconds * FRAMERATE;
+			return (uint8_t)((int)std::floor(steps - std::floor(steps / TIMESTEPS) * TIMESTEPS) % TIMESTEPS);
+		}
+
+		// Deterministic value in [0, 1)
+		static double Noise(int64_t seed)
+		{
+			const uint32_t x = (uint32_t)(seed * 2654435761u);
+			return (double)((x >> 8) & 0xffff) / 65536.0;
+		}
+
+		// On the ring, in [-TIMESTEPS / 2, TIMESTEPS / 2)
+		static int Difference(int local, int server)
+		{
+			return ((local - server) % TIMESTEPS + TIMESTEPS + TIMESTEPS / 2) % TIMESTEPS - TIMESTEPS / 2;
+		}
+
+		double serverStart;
+		double now = 0.0;
+		int64_t tick = 0;
+		// replies in arrival order, a round trip is shorter than the ping interval
+		std::deque<Reply> pending;
+	};
+
+	// A small offset is slewed, no step of the clock
+	void testConvergence()
+	{
+		Simulation simulation(5.0);
+		const int early = simulation.Run(12);
+		VPET_CHECK(std::abs(early) >= 3);
+		const int difference = simulation.Run(600);
+		VPET_CHECK(std::abs(difference) <= 1);
+		VPET_CHECK(simulation.clock.GetStats().jumps == 0);
+		VPET_CHECK(std::fabs(simulation.clock.GetStats().offsetSteps) < 1.0);
+		VPET_CHECK(simulation.clock.GetStats().pings > 90);
+	}
+
+	// The offset is taken the short way around the ring, ahead below half the ring, behind above it
+	void testWrap(double serverStart, bool ahead)
+	{
+		Simulation simulation(serverStart);
+		simulation.Run(1);
+		const double offset = simulation.clock.GetStats().offsetSteps;
+		VPET_CHECK(ahead ? offset > 0 : offset < 0);
+		VPET_CHECK(std::fabs(offset) <= TIMESTEPS / 2);
+
+		const int difference = simulation.Run(600);
+		VPET_CHECK(std::abs(difference) <= 1);
+		VPET_CHECK(simulation.clock.GetStats().jumps == 1);
+	}
+
+	// Samples on both sides of half the ring are one step apart, not a full ring
+	void testBlendAcrossHalf()
+	{
+		ClockSync clock;
+		clock.Reset(TIMESTEPS, FRAMERATE, 0.0);
+		const double delay = 0.001 * 0.5 * FRAMERATE;
+		clock.AddPing(-0.001, 0.0, TIMESTEPS / 2 - 1);
+		VPET_CHECK(std::fabs(clock.GetStats().offsetSteps - (TIMESTEPS / 2 - 0.5 + delay)) < 1e-9);
+
+		// a lower round trip one step later wraps to the negative side
+		clock.AddPing(-0.0005, 0.0, TIMESTEPS / 2);
+		const double offset = clock.GetStats().offsetSteps;
+		const double expected = TIMESTEPS / 2 - 0.5 + delay + (1.0 - delay * 0.5) * 0.25;
+		VPET_CHECK(std::fabs(offset - expected) < 1e-9 || std::fabs(offset + TIMESTEPS - expected) < 1e-9);
+		VPET_CHECK(clock.GetStats().jumps == 0);
+	}
+
+	// A restarted server is far off, the clock is stepped once and follows right away
+	void testServerRestart()
+	{
+		Simulation simulation(0.0);
+		VPET_CHECK(std::abs(simulation.Run(600)) <= 1);
+		const int64_t jumps = simulation.clock.GetStats().jumps;
+
+		simulation.RestartServer(0.0);
+		VPET_CHECK(std::abs(simulation.Run(60)) <= 1);
+		VPET_CHECK(simulation.clock.GetStats().jumps == jumps + 1);
+		VPET_CHECK(std::abs(simulation.Run(600)) <= 1);
+		VPET_CHECK(simulation.clock.GetStats().jumps == jumps + 1);
+	}
+
+	// The sample with the lowest round trip of the window wins over later delayed ones
+	void testMinRttWindow()
+	{
+		ClockSync clock;
+		clock.Reset(TIMESTEPS, FRAMERATE, 0.0);
+
+		// the server is at step 20.0 when the replies arrive at 0 s, the clock is not advanced
+		const double exact = 20.0 + 0.5 + 0.001 * 0.5 * FRAMERATE;
+		clock.AddPing(-0.001, 0.0, 20);
+		VPET_CHECK(std::fabs(clock.GetStats().offsetSteps - exact) < 1e-9);
+
+		// 100 ms round trips whose reply took nearly all of it, stamped 5.7 steps early
+		const double delayed = 14 + 0.5 + 0.1 * 0.5 * FRAMERATE;
+		for (int i = 0; i < 7; i++)
+			clock.AddPing(-0.1, 0.0, 14);
+		VPET_CHECK(std::fabs(clock.GetStats().offsetSteps - exact) < 1e-9);
+		VPET_CHECK(std::fabs(clock.GetStats().minRttMillis - 1.0) < 1e-6);
+
+		// the exact sample has left the window
+		clock.AddPing(-0.1, 0.0, 14);
+		VPET_CHECK(std::fabs(clock.GetStats().minRttMillis - 100.0) < 1e-6);
+		const double moved = clock.GetStats().offsetSteps;
+		VPET_CHECK(std::fabs(moved - (exact + (delayed - exact) * 0.25)) < 1e-9);
+		for (int i = 0; i < 20; i++)
+			clock.AddPing(-0.1, 0.0, 14);
+		VPET_CHECK(std::fabs(clock.GetStats().offsetSteps - delayed) < 0.1);
+	}
+}
+
+int main()
+{
+	testConvergence();
+	testWrap(TIMESTEPS / 2 - 4.0, true);
+	testWrap(TIMESTEPS / 2 + 4.0, false);
+	testBlendAcrossHalf();
+	testServerRestart();
+	testMinRttWindow();
+	return VPET::Test::result("ClockSyncTest");
+}
@@ -0,0 +1,201 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! TMessageRing of the Unreal plugin: single threaded edge cases and a producer/consumer
+//! stress test that checks ordering, payload integrity and that no message is lost.
+
+#include <cstdint>
+#include <thread>
+
+#include "MessageRing.h"
+#include "TestCheck.h"
+
+namespace
+{
+	struct Slot
+	{
+		uint64_t sequence;
+		uint64_t payload[7];
+	};
+
+	void fill(Slot* slot, uint64_t sequence)
+	{
+		slot->sequence = sequence;
+		for (int i = 0; i < 7; i++)
+			slot->payload[i] = sequence * 31 + i;
+	}
+
+	bool intact(const Slot* slot)
+	{
+		for (int i = 0; i < 7; i++)
+			if (slot->payload[i] != slot->sequence * 31 + i)
+				return false;
+		return true;
+	}
+
+	void testEmptyAndFull()
+	{
+		TMessageRing<Slot, 4> ring;
+		VPET_CHECK(ring.Peek() == nullptr);
+		VPET_CHECK(ring.Num() == 0);
+
+		for (uint64_t i = 0; i < 4; i++)
+		{
+			Slot* slot = ring.BeginWrite();
+			VPET_CHECK(slot != nullptr);
+			if (!slot)
+				return;
+			fill(slot, i);
+			ring.CommitWrite();
+		}
+		VPET_CHECK(ring.BeginWrite() == nullptr);
+		VPET_CHECK(ring.Num() == 4);
+
+		// a slot filled but not committed is not visible to the consumer
+		Slot* first = ring.Peek();
+		VPET_CHECK(first != nullptr && first->sequence == 0);
+		ring.Pop();
+		Slot* reused = ring.BeginWrite();
+		VPET_CHECK(reused != nullptr);
+		if (reused)
+			fill(reused, 99);
+		for (uint64_t i = 1; i < 4; i++)
+		{
+			Slot* slot = ring.Peek();
+			VPET_CHECK(slot != nullptr && slot->sequence == i);
+			ring.Pop();
+		}
+		VPET_CHECK(ring.Peek() == nullptr);
+
+		ring.CountOverflow();
+		VPET_CHECK(ring.GetOverflowCount() == 1);
+
+		ring.Reset();
+		VPET_CHECK(ring.Num() == 0);
+		VPET_CHECK(ring.Peek() == nullptr);
+	}
+
+	// the producer waits for free slots, every message has to arrive in order
+	void testNoLoss(uint64_t count)
+	{
+		static TMessageRing<Slot, 64> ring;
+		ring.Reset();
+
+		std::thread producer([count]() {
+			for (uint64_t i = 0; i < count; i++)
+			{
+				Slot* slot;
+				while (!(slot = ring.BeginWrite()))
+					std::this_thread::yield();
+				fill(slot, i);
+				ring.CommitWrite();
+			}
+		});
+
+		uint64_t expected = 0;
+		uint64_t errors = 0;
+		while (expected < count)
+		{
+			Slot* slot = ring.Peek();
+			if (!slot)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			if (slot->sequence != expected || !intact(slot))
+				errors++;
+			expected = slot->sequence + 1;
+			ring.Pop();
+		}
+		producer.join();
+
+		VPET_CHECK(errors == 0);
+		VPET_CHECK(expected == count);
+		VPET_CHECK(ring.Num() == 0);
+	}
+
+	// the producer drops messages while the ring is full, the others keep their order
+	void testOverflow(uint64_t count)
+	{
+		static TMessageRing<Slot, 16> ring;
+		ring.Reset();
+
+		std::thread producer([count]() {
+			for (uint64_t i = 0; i < count; i++)
+			{
+				Slot* slot = ring.BeginWrite();
+				if (!slot)
+				{
+					ring.CountOverflow();
+					continue;
+				}
+				fill(slot, i);
+				ring.CommitWrite();
+			}
+		});
+
+		uint64_t received = 0;
+		uint64_t errors = 0;
+		int64_t last = -1;
+		bool done = false;
+		while (!done)
+		{
+			// the producer is finished once every message is either received or dropped
+			done = received + ring.GetOverflowCount() == count;
+			Slot* slot = ring.Peek();
+			if (!slot)
+				continue;
+			if ((int64_t)slot->sequence <= last || !intact(slot))
+				errors++;
+			last = (int64_t)slot->sequence;
+			received++;
+			ring.Pop();
+			done = false;
+		}
+		producer.join();
+
+		VPET_CHECK(errors == 0);
+		VPET_CHECK(received + ring.GetOverflowCount() == count);
+		VPET_CHECK(ring.Peek() == nullptr);
+	}
+}
+
+int main()
+{
+	testEmptyAndFull();
+	testNoLoss(2000000);
+	testOverflow(2000000);
+	return VPET::Test::result("MessageRingTest");
+}
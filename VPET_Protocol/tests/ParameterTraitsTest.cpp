@@ -0,0 +1,166 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! VpetTypeTraits of the Unreal plugin: encode/decode round trip of every parameter type,
+//! the axis and handedness conversions, colour clamping, UTF-8 strings and position scaling.
+//! The engine types come from the stand-in in engine/CoreMinimal.h.
+
+#include <cstring>
+#include <vector>
+
+#include "ParameterTraits.h"
+#include "TestCheck.h"
+
+namespace
+{
+	template <class T>
+	std::vector<char> encode(const T& value)
+	{
+		std::vector<char> data(VpetTypeTraits<T>::Size(value));
+		VpetTypeTraits<T>::Encode(value, data.data());
+		return data;
+	}
+
+	template <class T>
+	bool roundTrip(const T& value, VPET::Protocol::ParameterType type)
+	{
+		std::vector<char> data = encode(value);
+		if (VpetTypeTraits<T>::Type != type)
+			return false;
+		if (VpetTypeTraits<T>::WireSize >= 0 && (int)data.size() != VpetTypeTraits<T>::WireSize)
+			return false;
+		T decoded{};
+		return VpetTypeTraits<T>::Decode(ByteSpan(data.data(), data.size()), decoded) && decoded == value;
+	}
+
+	std::vector<float> floats(const std::vector<char>& data)
+	{
+		std::vector<float> out(data.size() / sizeof(float));
+		std::memcpy(out.data(), data.data(), out.size() * sizeof(float));
+		return out;
+	}
+
+	void testRoundTrips()
+	{
+		using VPET::Protocol::ParameterType;
+		VPET_CHECK(roundTrip(true, ParameterType::BOOL));
+		VPET_CHECK(roundTrip(false, ParameterType::BOOL));
+		VPET_CHECK(roundTrip((int32)-123456, ParameterType::INT));
+		VPET_CHECK(roundTrip(1.5f, ParameterType::FLOAT));
+		VPET_CHECK(roundTrip(FVector2D(0.25, -8), ParameterType::VECTOR2));
+		VPET_CHECK(roundTrip(FVector(1, 2, 3), ParameterType::VECTOR3));
+		VPET_CHECK(roundTrip(FVector4(1, 2, 3, 4), ParameterType::VECTOR4));
+		VPET_CHECK(roundTrip(FQuat(0.5, -0.5, 0.25, 0.75), ParameterType::QUATERNION));
+		VPET_CHECK(roundTrip(FColor(10, 20, 30, 40), ParameterType::COLOR));
+		VPET_CHECK(roundTrip(std::string("vpet"), ParameterType::STRING));
+		VPET_CHECK(roundTrip(std::string(), ParameterType::STRING));
+		VPET_CHECK(roundTrip(FString(U"Grüße 漢字 \U0001F3AC"), ParameterType::STRING));
+
+		VPET_CHECK(VpetTypeTraits<TFunction<void()>>::Type == ParameterType::ACTION);
+		VPET_CHECK(VpetTypeTraits<TFunction<void()>>::Size(TFunction<void()>()) == 0);
+	}
+
+	void testWireLayout()
+	{
+		// Unreal is Z up, the wire is Y up
+		std::vector<float> vector = floats(encode(FVector(1, 2, 3)));
+		VPET_CHECK(vector.size() == 3 && vector[0] == 1 && vector[1] == 3 && vector[2] == 2);
+
+		// the handedness flip mirrors X on top of the axis swap
+		std::vector<float> quat = floats(encode(FQuat(0.1f, 0.2f, 0.3f, 0.4f)));
+		VPET_CHECK(quat.size() == 4 && quat[0] == -0.1f && quat[1] == 0.3f && quat[2] == 0.2f && quat[3] == 0.4f);
+
+		std::vector<char> flag = encode(true);
+		VPET_CHECK(flag.size() == 1 && flag[0] == 1);
+
+		std::vector<char> text = encode(std::string("abc"));
+		VPET_CHECK(text.size() == 3 && std::memcmp(text.data(), "abc", 3) == 0);
+
+		std::vector<char> utf8 = encode(FString(U"ä€"));
+		VPET_CHECK(utf8.size() == 5 && std::memcmp(utf8.data(), "\xc3\xa4\xe2\x82\xac", 5) == 0);
+	}
+
+	void testColorClamp()
+	{
+		const float channels[4] = { 300.f, -5.f, 127.9f, 255.f };
+		FColor color;
+		VPET_CHECK(VpetTypeTraits<FColor>::Decode(ByteSpan(channels, sizeof(channels)), color));
+		VPET_CHECK(color.R == 255 && color.G == 0 && color.B == 127 && color.A == 255);
+	}
+
+	void testPosition()
+	{
+		char data[12];
+		VpetWire::EncodePosition(FVector(100, 200, 300), data);
+		std::vector<float> wire = floats(std::vector<char>(data, data + sizeof(data)));
+		VPET_CHECK(wire[0] == -1.f && wire[1] == 3.f && wire[2] == 2.f);
+
+		FVector position;
+		VPET_CHECK(VpetWire::DecodePosition(ByteSpan(data, sizeof(data)), position));
+		VPET_CHECK(position == FVector(100, 200, 300));
+	}
+
+	void testTruncated()
+	{
+		const char data[16] = {};
+		bool flag;
+		int32 number;
+		float real;
+		FVector2D vector2;
+		FVector vector;
+		FVector4 vector4;
+		FQuat quat;
+		FColor color;
+		VPET_CHECK(!VpetTypeTraits<bool>::Decode(ByteSpan(data, 0), flag));
+		VPET_CHECK(!VpetTypeTraits<int32>::Decode(ByteSpan(data, 3), number));
+		VPET_CHECK(!VpetTypeTraits<float>::Decode(ByteSpan(data, 3), real));
+		VPET_CHECK(!VpetTypeTraits<FVector2D>::Decode(ByteSpan(data, 7), vector2));
+		VPET_CHECK(!VpetTypeTraits<FVector>::Decode(ByteSpan(data, 11), vector));
+		VPET_CHECK(!VpetTypeTraits<FVector4>::Decode(ByteSpan(data, 15), vector4));
+		VPET_CHECK(!VpetTypeTraits<FQuat>::Decode(ByteSpan(data, 15), quat));
+		VPET_CHECK(!VpetTypeTraits<FColor>::Decode(ByteSpan(data, 15), color));
+		VPET_CHECK(!VpetWire::DecodePosition(ByteSpan(data, 11), vector));
+	}
+}
+
+int main()
+{
+	testRoundTrips();
+	testWireLayout();
+	testColorClamp();
+	testPosition();
+	testTruncated();
+	return VPET::Test::result("ParameterTraitsTest");
+}
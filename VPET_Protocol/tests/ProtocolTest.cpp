@@ -0,0 +1,326 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! VPETProtocol.h and VPETSceneProtocol.h: encode/decode round trip of every message type,
+//! parameter records up to the size limit, too small buffers, truncated and malformed input
+//! and the sequence tracker.
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "VPETProtocol.h"
+#include "VPETSceneProtocol.h"
+#include "TestCheck.h"
+
+using namespace VPET::Protocol;
+
+namespace
+{
+	Header makeHeader(MessageType type, bool sequenced = false, uint16_t sequence = 0)
+	{
+		Header header;
+		header.clientID = 42;
+		header.time = 117;
+		header.type = type;
+		header.sequenced = sequenced;
+		header.sequence = sequence;
+		return header;
+	}
+
+	bool sameHeader(const Header& a, const Header& b)
+	{
+		return a.clientID == b.clientID && a.time == b.time && a.type == b.type && a.sequenced == b.sequenced && a.sequence == b.sequence;
+	}
+
+	void testHeader()
+	{
+		uint8_t buffer[8];
+
+		const Header plain = makeHeader(MessageType::PARAMETERUPDATE);
+		VPET_CHECK(encodeHeader(buffer, sizeof(buffer), plain) == HEADER_SIZE);
+		VPET_CHECK(buffer[0] == 42 && buffer[1] == 117 && buffer[2] == (uint8_t)MessageType::PARAMETERUPDATE);
+		Header decoded;
+		VPET_CHECK(decodeHeader(buffer, HEADER_SIZE, decoded) && sameHeader(decoded, plain));
+
+		const Header sequenced = makeHeader(MessageType::UNDOREDOADD, true, 0xBEEF);
+		VPET_CHECK(encodeHeader(buffer, sizeof(buffer), sequenced) == SEQUENCED_HEADER_SIZE);
+		VPET_CHECK((buffer[2] & SEQUENCE_FLAG) != 0 && buffer[3] == 0xEF && buffer[4] == 0xBE);
+		VPET_CHECK(decodeHeader(buffer, SEQUENCED_HEADER_SIZE, decoded) && sameHeader(decoded, sequenced));
+
+		// too small to write, too short to read
+		VPET_CHECK(encodeHeader(buffer, HEADER_SIZE - 1, plain) == 0);
+		VPET_CHECK(encodeHeader(buffer, SEQUENCED_HEADER_SIZE - 1, sequenced) == 0);
+		VPET_CHECK(!decodeHeader(buffer, SEQUENCED_HEADER_SIZE - 1, decoded));
+		VPET_CHECK(!decodeHeader(buffer, HEADER_SIZE - 1, decoded));
+		VPET_CHECK(!decodeHeader(nullptr, HEADER_SIZE, decoded));
+	}
+
+	void testControl()
+	{
+		const MessageType types[] = { MessageType::SYNC, MessageType::PING, MessageType::RESENDUPDATE };
+		for (MessageType type : types)
+		{
+			uint8_t buffer[CONTROL_MESSAGE_SIZE];
+			VPET_CHECK(encodeControl(buffer, sizeof(buffer), 7, 200, type) == CONTROL_MESSAGE_SIZE);
+			Header decoded;
+			VPET_CHECK(decodeHeader(buffer, sizeof(buffer), decoded));
+			VPET_CHECK(decoded.clientID == 7 && decoded.time == 200 && decoded.type == type && !decoded.sequenced);
+			VPET_CHECK(encodeControl(buffer, CONTROL_MESSAGE_SIZE - 1, 7, 200, type) == 0);
+		}
+	}
+
+	void testLock()
+	{
+		LockMessage message;
+		message.header = makeHeader(MessageType::LOCK);
+		message.sceneID = 3;
+		message.objectID = 0x1234;
+		message.locked = true;
+
+		uint8_t buffer[LOCK_MESSAGE_SIZE];
+		VPET_CHECK(encodeLock(buffer, sizeof(buffer), message) == LOCK_MESSAGE_SIZE);
+		LockMessage decoded;
+		VPET_CHECK(decodeLock(buffer, sizeof(buffer), decoded));
+		VPET_CHECK(sameHeader(decoded.header, message.header) && decoded.sceneID == 3 && decoded.objectID == 0x1234 && decoded.locked);
+
+		message.locked = false;
+		encodeLock(buffer, sizeof(buffer), message);
+		VPET_CHECK(decodeLock(buffer, sizeof(buffer), decoded) && !decoded.locked);
+
+		VPET_CHECK(encodeLock(buffer, LOCK_MESSAGE_SIZE - 1, message) == 0);
+		VPET_CHECK(!decodeLock(buffer, LOCK_MESSAGE_SIZE - 1, decoded));
+		// another type in the header
+		buffer[2] = (uint8_t)MessageType::RESETOBJECT;
+		VPET_CHECK(!decodeLock(buffer, sizeof(buffer), decoded));
+	}
+
+	void testReset()
+	{
+		ResetMessage message;
+		message.header = makeHeader(MessageType::RESETOBJECT);
+		message.sceneID = 9;
+		message.objectID = 65535;
+
+		uint8_t buffer[RESET_MESSAGE_SIZE];
+		VPET_CHECK(encodeReset(buffer, sizeof(buffer), message) == RESET_MESSAGE_SIZE);
+		ResetMessage decoded;
+		VPET_CHECK(decodeReset(buffer, sizeof(buffer), decoded));
+		VPET_CHECK(sameHeader(decoded.header, message.header) && decoded.sceneID == 9 && decoded.objectID == 65535);
+
+		VPET_CHECK(encodeReset(buffer, RESET_MESSAGE_SIZE - 1, message) == 0);
+		VPET_CHECK(!decodeReset(buffer, RESET_MESSAGE_SIZE - 1, decoded));
+		buffer[2] = (uint8_t)MessageType::LOCK;
+		VPET_CHECK(!decodeReset(buffer, sizeof(buffer), decoded));
+	}
+
+	void testResendRequest()
+	{
+		ResendRequest request;
+		request.header = makeHeader(MessageType::RESENDUPDATE);
+		request.targetID = 12;
+		request.firstSequence = 65530;
+		request.count = 20;
+
+		uint8_t buffer[RESEND_REQUEST_SIZE];
+		VPET_CHECK(encodeResendRequest(buffer, sizeof(buffer), request) == RESEND_REQUEST_SIZE);
+		ResendRequest decoded;
+		VPET_CHECK(decodeResendRequest(buffer, sizeof(buffer), decoded));
+		VPET_CHECK(sameHeader(decoded.header, request.header) && decoded.targetID == 12 && decoded.firstSequence == 65530 && decoded.count == 20);
+
+		VPET_CHECK(encodeResendRequest(buffer, RESEND_REQUEST_SIZE - 1, request) == 0);
+		// the plain control message is no range request
+		VPET_CHECK(!decodeResendRequest(buffer, CONTROL_MESSAGE_SIZE, decoded));
+		buffer[2] = (uint8_t)MessageType::PING;
+		VPET_CHECK(!decodeResendRequest(buffer, sizeof(buffer), decoded));
+	}
+
+	void testParameterMessage(bool sequenced)
+	{
+		const uint8_t small[3] = { 1, 2, 3 };
+		std::vector<uint8_t> largest(MAX_PARAMETER_DATA_SIZE);
+		for (size_t i = 0; i < largest.size(); i++)
+			largest[i] = (uint8_t)(i * 13);
+
+		const size_t size = parameterMessageSize(3, sizeof(small) + largest.size(), sequenced);
+		std::vector<uint8_t> buffer(size);
+		const Header header = makeHeader(MessageType::PARAMETERUPDATE, sequenced, sequenced ? 513 : 0);
+		ParameterMessageWriter writer(buffer.data(), buffer.size(), header);
+		VPET_CHECK(writer.addParameter(1, 300, 4, ParameterType::VECTOR3, small, sizeof(small)));
+		VPET_CHECK(writer.addParameter(2, 65535, 65535, ParameterType::ACTION, nullptr, 0));
+		uint8_t* inPlace = writer.addParameter(3, 7, 8, ParameterType::STRING, largest.size());
+		VPET_CHECK(inPlace != nullptr);
+		if (inPlace)
+			std::memcpy(inPlace, largest.data(), largest.size());
+		VPET_CHECK(!writer.failed() && writer.size() == size);
+
+		Header decodedHeader;
+		VPET_CHECK(decodeHeader(buffer.data(), buffer.size(), decodedHeader) && sameHeader(decodedHeader, header));
+
+		ParameterMessageReader reader(buffer.data(), buffer.size());
+		ParameterRecord record;
+		VPET_CHECK(reader.next(record));
+		VPET_CHECK(record.sceneID == 1 && record.objectID == 300 && record.parameterID == 4 && record.type == ParameterType::VECTOR3);
+		VPET_CHECK(record.dataSize == sizeof(small) && std::memcmp(record.data, small, sizeof(small)) == 0);
+		VPET_CHECK(reader.next(record));
+		VPET_CHECK(record.sceneID == 2 && record.objectID == 65535 && record.parameterID == 65535 && record.type == ParameterType::ACTION && record.dataSize == 0);
+		VPET_CHECK(reader.next(record));
+		VPET_CHECK(record.sceneID == 3 && record.type == ParameterType::STRING && record.dataSize == MAX_PARAMETER_DATA_SIZE);
+		VPET_CHECK(std::memcmp(record.data, largest.data(), largest.size()) == 0);
+		VPET_CHECK(!reader.next(record) && !reader.failed());
+		VPET_CHECK(reader.offset() == size);
+	}
+
+	void testParameterLimits()
+	{
+		uint8_t buffer[512];
+		const Header header = makeHeader(MessageType::PARAMETERUPDATE);
+
+		// a record is limited by its one byte length
+		ParameterMessageWriter oversized(buffer, sizeof(buffer), header);
+		VPET_CHECK(oversized.addParameter(0, 0, 0, ParameterType::STRING, MAX_PARAMETER_DATA_SIZE + 1) == nullptr);
+		VPET_CHECK(oversized.failed() && oversized.size() == 0);
+		// failed stays failed
+		VPET_CHECK(oversized.addParameter(0, 0, 0, ParameterType::BOOL, 1) == nullptr);
+
+		// the buffer is too small for the record
+		ParameterMessageWriter full(buffer, HEADER_SIZE + PARAMETER_RECORD_SIZE + 3, header);
+		VPET_CHECK(full.addParameter(0, 0, 0, ParameterType::INT, 4) == nullptr);
+		VPET_CHECK(full.failed());
+
+		// and for the header
+		ParameterMessageWriter noHeader(buffer, HEADER_SIZE - 1, header);
+		VPET_CHECK(noHeader.failed());
+	}
+
+	void testParameterMalformed()
+	{
+		uint8_t buffer[64];
+		const Header header = makeHeader(MessageType::PARAMETERUPDATE);
+		ParameterMessageWriter writer(buffer, sizeof(buffer), header);
+		const float value = 1.5f;
+		writer.addParameter(1, 2, 3, ParameterType::FLOAT, &value, sizeof(value));
+		writer.addParameter(1, 2, 4, ParameterType::FLOAT, &value, sizeof(value));
+		const size_t size = writer.size();
+		ParameterRecord record;
+
+		// the second record is cut off
+		ParameterMessageReader truncated(buffer, size - 1);
+		VPET_CHECK(truncated.next(record));
+		VPET_CHECK(!truncated.next(record) && truncated.failed());
+
+		// a record shorter than its own fields
+		std::vector<uint8_t> shortLength(buffer, buffer + size);
+		shortLength[HEADER_SIZE + 6] = PARAMETER_RECORD_SIZE - 1;
+		ParameterMessageReader tooShort(shortLength.data(), shortLength.size());
+		VPET_CHECK(!tooShort.next(record) && tooShort.failed());
+
+		// a length beyond the end of the message
+		std::vector<uint8_t> longLength(buffer, buffer + size);
+		longLength[HEADER_SIZE + 6] = 255;
+		ParameterMessageReader tooLong(longLength.data(), longLength.size());
+		VPET_CHECK(!tooLong.next(record) && tooLong.failed());
+
+		// the sequence flag without the sequence
+		std::vector<uint8_t> noSequence(buffer, buffer + HEADER_SIZE + 1);
+		noSequence[2] |= SEQUENCE_FLAG;
+		ParameterMessageReader missing(noSequence.data(), noSequence.size());
+		VPET_CHECK(!missing.next(record) && missing.failed());
+
+		ParameterMessageReader empty(nullptr, 0);
+		VPET_CHECK(!empty.next(record) && empty.failed());
+
+		// only a header is a valid message without records
+		ParameterMessageReader headerOnly(buffer, HEADER_SIZE);
+		VPET_CHECK(!headerOnly.next(record) && !headerOnly.failed());
+	}
+
+	void testSequenceTracker()
+	{
+		using Result = SequenceTracker::Result;
+		SequenceTracker tracker;
+		uint16_t first = 0;
+		int count = 0;
+
+		VPET_CHECK(tracker.add(65534, first, count) == Result::FIRST);
+		VPET_CHECK(tracker.add(65535, first, count) == Result::IN_ORDER);
+		// wraps around
+		VPET_CHECK(tracker.add(0, first, count) == Result::IN_ORDER);
+		VPET_CHECK(tracker.add(0, first, count) == Result::DUPLICATE);
+		VPET_CHECK(tracker.add(4, first, count) == Result::GAP && first == 1 && count == 3);
+		VPET_CHECK(tracker.add(2, first, count) == Result::RECOVERED && count == 0);
+		VPET_CHECK(tracker.add(2, first, count) == Result::DUPLICATE);
+		VPET_CHECK(tracker.add(65535, first, count) == Result::DUPLICATE);
+
+		// only the window can be recovered
+		VPET_CHECK(tracker.add(1004, first, count) == Result::GAP && count == SequenceTracker::WINDOW - 1 && first == 1004 - count);
+		// far behind, the sender restarted
+		VPET_CHECK(tracker.add(10, first, count) == Result::FIRST);
+
+		tracker.reset();
+		VPET_CHECK(tracker.add(100, first, count) == Result::FIRST);
+	}
+
+	void testSceneRequests()
+	{
+		using namespace VPET::Protocol::Scene;
+		for (int i = 0; i < REQUEST_UNKNOWN; i++)
+			VPET_CHECK(requestTypeFromString(requestNames[i]) == i);
+		VPET_CHECK(requestTypeFromString("instancednodes") == REQUEST_INSTANCED_NODES);
+		VPET_CHECK(requestTypeFromString("unknown") == REQUEST_UNKNOWN);
+		VPET_CHECK(requestTypeFromString("") == REQUEST_UNKNOWN);
+		VPET_CHECK(requestTypeFromString("Nodes") == REQUEST_UNKNOWN);
+
+		// values the existing clients parse
+		VPET_CHECK(GEO == 1 && SKINNEDMESH == 4 && CHARACTER == 5 && LAST_LEGACY_NODE_TYPE == CHARACTER && INSTANCER == 6);
+		VPET_CHECK(SPOT == 0 && AREA == 3);
+	}
+}
+
+int main()
+{
+	testHeader();
+	testControl();
+	testLock();
+	testReset();
+	testResendRequest();
+	testParameterMessage(false);
+	testParameterMessage(true);
+	testParameterLimits();
+	testParameterMalformed();
+	testSequenceTracker();
+	testSceneRequests();
+	return VPET::Test::result("ProtocolTest");
+}
@@ -0,0 +1,172 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! UpdateFramePool and UpdateSendQueue of the Unreal plugin: one million frames go from the
+//! game thread through the queue to a sender thread and back to the pool the way zmq returns
+//! them. Frames and their capacity must not grow beyond what is in flight, none may be lost.
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "UpdateSendQueue.h"
+#include "TestCheck.h"
+
+namespace
+{
+	const int FRAMES = 1000000;
+	// Messages the game thread lets pile up before it holds back, as with LatestStateUpdates
+	const int MAX_BACKLOG = 8;
+	const size_t MAX_MESSAGE_SIZE = 4096;
+
+	// sizes between the index plus a marker byte and the largest message
+	size_t messageSize(int i)
+	{
+		const size_t smallest = sizeof(int) + 1;
+		return smallest + ((size_t)i * 7919) % (MAX_MESSAGE_SIZE - smallest + 1);
+	}
+
+	void testPoolReuse()
+	{
+		UpdateFramePool pool(2, 64);
+		VPET_CHECK(pool.GetFrameCount() == 2);
+
+		UpdateFrame* a = pool.Acquire(16);
+		UpdateFrame* b = pool.Acquire(128);
+		UpdateFrame* c = pool.Acquire(16);
+		VPET_CHECK(pool.GetFrameCount() == 3);
+		VPET_CHECK(a->capacity >= 16 && b->capacity >= 128 && c->capacity >= 16);
+		VPET_CHECK(a->pool == &pool && b->pool == &pool && c->pool == &pool);
+
+		UpdateFramePool::ReleaseFrame(b->data, b);
+		UpdateFrame* d = pool.Acquire(100);
+		VPET_CHECK(d == b);
+		VPET_CHECK(d->capacity == 128);
+
+		pool.Release(a);
+		pool.Release(c);
+		pool.Release(d);
+		VPET_CHECK(pool.GetFreeCount() == 3);
+	}
+
+	// queued frames go back to the pool when the queue is reset
+	void testResetReleases()
+	{
+		UpdateFramePool pool;
+		UpdateSendQueue queue;
+		for (int i = 0; i < 5; i++)
+			queue.Push(pool.Acquire(32), 32);
+		VPET_CHECK(queue.GetBacklog() == 5);
+		queue.Reset();
+		VPET_CHECK(queue.GetBacklog() == 0);
+		VPET_CHECK(pool.GetFreeCount() == pool.GetFrameCount());
+	}
+
+	void testMillionFrames()
+	{
+		UpdateFramePool pool;
+		UpdateSendQueue queue;
+		std::atomic<int64_t> corrupted(0);
+
+		// sender thread, every tenth message is dropped as at the high-water mark
+		std::thread sender([&]() {
+			std::vector<UpdateSendQueue::Entry> taken;
+			while (queue.WaitAndTake(taken, std::chrono::milliseconds(10)))
+			{
+				for (UpdateSendQueue::Entry& entry : taken)
+				{
+					int index;
+					std::memcpy(&index, entry.frame->data, sizeof(int));
+					if ((size_t)entry.length != messageSize(index) || entry.frame->data[entry.length - 1] != (char)index)
+						corrupted++;
+
+					if (index % 10 == 0)
+						queue.RecordDropped(entry);
+					else
+						queue.RecordSent(entry);
+					UpdateFramePool::ReleaseFrame(entry.frame->data, entry.frame);
+				}
+				taken.clear();
+			}
+			for (UpdateSendQueue::Entry& entry : taken)
+				queue.Discard(entry);
+		});
+
+		std::set<UpdateFrame*> framesSeen;
+		size_t largestCapacity = 0;
+		for (int i = 0; i < FRAMES; i++)
+		{
+			while (queue.GetBacklog() >= MAX_BACKLOG)
+				std::this_thread::yield();
+
+			const size_t size = messageSize(i);
+			UpdateFrame* frame = pool.Acquire(size);
+			std::memcpy(frame->data, &i, sizeof(int));
+			frame->data[size - 1] = (char)i;
+			framesSeen.insert(frame);
+			largestCapacity = frame->capacity > largestCapacity ? frame->capacity : largestCapacity;
+			queue.Push(frame, (int)size);
+		}
+
+		while (queue.GetBacklog() > 0)
+			std::this_thread::yield();
+		queue.Close();
+		sender.join();
+
+		VPET_CHECK(corrupted == 0);
+		VPET_CHECK(queue.GetSentCount() + queue.GetDroppedCount() == FRAMES);
+		VPET_CHECK(queue.GetDroppedCount() == FRAMES / 10);
+		VPET_CHECK(queue.GetBacklog() == 0);
+
+		// bounded by the backlog limit plus the frame being written and the two prewarmed ones
+		VPET_CHECK(pool.GetFrameCount() <= MAX_BACKLOG + 3);
+		VPET_CHECK(framesSeen.size() == pool.GetFrameCount());
+		VPET_CHECK(largestCapacity <= MAX_MESSAGE_SIZE);
+
+		// every frame is back, nothing leaked
+		VPET_CHECK(pool.GetFreeCount() == pool.GetFrameCount());
+	}
+}
+
+int main()
+{
+	testPoolReuse();
+	testResetReleases();
+	testMillionFrames();
+	return VPET::Test::result("UpdateFrameTest");
+}
@@ -0,0 +1,155 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! UpdateJitterBuffer of the Unreal plugin: Late and Early classification around the wrap of
+//! the time step ring, time steps outside the ring, play out order and a clock set back.
+
+#include <string>
+#include <vector>
+
+#include "UpdateJitterBuffer.h"
+#include "TestCheck.h"
+
+namespace
+{
+	typedef UpdateJitterBuffer::Placement Placement;
+
+	const int TIMESTEPS = 60;
+	const int MAX_AHEAD = TIMESTEPS;
+
+	Placement add(UpdateJitterBuffer& buffer, uint8_t time, const std::string& text, int maxAhead = MAX_AHEAD)
+	{
+		return buffer.Add(time, ByteSpan(text.data(), text.size()), maxAhead);
+	}
+
+	std::vector<std::string> playOut(UpdateJitterBuffer& buffer, uint8_t time)
+	{
+		std::vector<std::string> played;
+		buffer.PlayOut(time, [&played](ByteSpan message) {
+			played.push_back(std::string(reinterpret_cast<const char*>(message.Data()), message.Size()));
+		});
+		return played;
+	}
+
+	void testDisabled()
+	{
+		UpdateJitterBuffer buffer;
+		VPET_CHECK(!buffer.IsEnabled());
+		VPET_CHECK(playOut(buffer, 5).empty());
+	}
+
+	void testPlacementAtWrap()
+	{
+		UpdateJitterBuffer buffer;
+		buffer.Reset(TIMESTEPS, 58);
+		VPET_CHECK(buffer.IsEnabled());
+
+		VPET_CHECK(add(buffer, 59, "a") == Placement::Buffered);
+		VPET_CHECK(add(buffer, 0, "b") == Placement::Buffered);
+		VPET_CHECK(add(buffer, 59, "c") == Placement::Buffered);
+		// the played step itself and steps behind it across the wrap
+		VPET_CHECK(add(buffer, 58, "late") == Placement::Late);
+		VPET_CHECK(add(buffer, 57, "late") == Placement::Late);
+		// half the ring ahead is still buffered, one more counts as behind
+		VPET_CHECK(add(buffer, (58 + TIMESTEPS / 2) % TIMESTEPS, "d") == Placement::Buffered);
+		VPET_CHECK(add(buffer, (58 + TIMESTEPS / 2 + 1) % TIMESTEPS, "late") == Placement::Late);
+		// ahead of the sender clock limit
+		VPET_CHECK(add(buffer, 1, "early", 2) == Placement::Early);
+		VPET_CHECK(add(buffer, 0, "e", 2) == Placement::Buffered);
+		// outside the ring
+		VPET_CHECK(add(buffer, TIMESTEPS, "early") == Placement::Early);
+		VPET_CHECK(add(buffer, 255, "early") == Placement::Early);
+
+		VPET_CHECK(buffer.GetLateCount() == 3);
+		VPET_CHECK(buffer.GetEarlyCount() == 3);
+
+		// time step order across the wrap, arrival order within a step
+		std::vector<std::string> played = playOut(buffer, 0);
+		VPET_CHECK(played == std::vector<std::string>({ "a", "c", "b", "e" }));
+		VPET_CHECK(playOut(buffer, 0).empty());
+
+		// the rest of the ring up to the step half ahead
+		played = playOut(buffer, (58 + TIMESTEPS / 2) % TIMESTEPS);
+		VPET_CHECK(played == std::vector<std::string>({ "d" }));
+
+		// a played step is late from now on
+		VPET_CHECK(add(buffer, 59, "late") == Placement::Late);
+	}
+
+	void testClockSetBack()
+	{
+		UpdateJitterBuffer buffer;
+		buffer.Reset(TIMESTEPS, 10);
+		VPET_CHECK(add(buffer, 12, "kept") == Placement::Buffered);
+
+		// more than half the ring ahead is behind, only the playout point moves
+		VPET_CHECK(playOut(buffer, 50).empty());
+		VPET_CHECK(add(buffer, 52, "new") == Placement::Buffered);
+		VPET_CHECK(add(buffer, 50, "late") == Placement::Late);
+		VPET_CHECK(playOut(buffer, 52) == std::vector<std::string>({ "new" }));
+
+		// the step buffered before the set back is played once the clock passes it again
+		VPET_CHECK(playOut(buffer, 12) == std::vector<std::string>({ "kept" }));
+	}
+
+	void testReset()
+	{
+		UpdateJitterBuffer buffer;
+		buffer.Reset(TIMESTEPS, 0);
+		add(buffer, 1, "dropped");
+		add(buffer, 0, "late");
+		buffer.Reset(TIMESTEPS, 0);
+		VPET_CHECK(buffer.GetLateCount() == 0 && buffer.GetEarlyCount() == 0);
+		VPET_CHECK(playOut(buffer, 1).empty());
+
+		// buckets keep working with empty messages and after many rounds
+		for (int round = 0; round < 3 * TIMESTEPS; round++)
+		{
+			const uint8_t next = (uint8_t)((1 + round + 1) % TIMESTEPS);
+			VPET_CHECK(add(buffer, next, std::string()) == Placement::Buffered);
+			std::vector<std::string> played = playOut(buffer, next);
+			VPET_CHECK(played.size() == 1 && played[0].empty());
+		}
+	}
+}
+
+int main()
+{
+	testDisabled();
+	testPlacementAtWrap();
+	testClockSetBack();
+	testReset();
+	return VPET::Test::result("UpdateJitterBufferTest");
+}
@@ -0,0 +1,187 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! Stand-in for the few Unreal types the engine independent plugin headers use,
+//! so they can be compiled and tested without the engine. Not a complete implementation.
+
+#ifndef VPET_TEST_CORE_MINIMAL_H
+#define VPET_TEST_CORE_MINIMAL_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+typedef int32_t int32;
+typedef uint8_t uint8;
+typedef char ANSICHAR;
+typedef char32_t TCHAR;
+
+template <class T>
+using TFunction = std::function<T>;
+
+namespace FMath
+{
+	template <class T>
+	T Clamp(T value, T low, T high) { return value < low ? low : (value > high ? high : value); }
+}
+
+struct FVector
+{
+	double X = 0, Y = 0, Z = 0;
+	FVector() = default;
+	FVector(double x, double y, double z) : X(x), Y(y), Z(z) {}
+	FVector operator*(double scale) const { return FVector(X * scale, Y * scale, Z * scale); }
+	bool operator==(const FVector& other) const { return X == other.X && Y == other.Y && Z == other.Z; }
+};
+
+struct FVector2D
+{
+	double X = 0, Y = 0;
+	FVector2D() = default;
+	FVector2D(double x, double y) : X(x), Y(y) {}
+	bool operator==(const FVector2D& other) const { return X == other.X && Y == other.Y; }
+};
+
+struct FVector4
+{
+	double X = 0, Y = 0, Z = 0, W = 0;
+	FVector4() = default;
+	FVector4(double x, double y, double z, double w) : X(x), Y(y), Z(z), W(w) {}
+	bool operator==(const FVector4& other) const { return X == other.X && Y == other.Y && Z == other.Z && W == other.W; }
+};
+
+struct FQuat
+{
+	double X = 0, Y = 0, Z = 0, W = 1;
+	FQuat() = default;
+	FQuat(double x, double y, double z, double w) : X(x), Y(y), Z(z), W(w) {}
+	bool operator==(const FQuat& other) const { return X == other.X && Y == other.Y && Z == other.Z && W == other.W; }
+};
+
+struct FColor
+{
+	uint8 R = 0, G = 0, B = 0, A = 255;
+	FColor() = default;
+	FColor(uint8 r, uint8 g, uint8 b, uint8 a = 255) : R(r), G(g), B(b), A(a) {}
+	bool operator==(const FColor& other) const { return R == other.R && G == other.G && B == other.B && A == other.A; }
+};
+
+// UTF-8 to UTF-32, invalid sequences are skipped
+class FUTF8ToTCHAR
+{
+public:
+	FUTF8ToTCHAR(const ANSICHAR* source, size_t length)
+	{
+		const unsigned char* s = reinterpret_cast<const unsigned char*>(source);
+		size_t i = 0;
+		while (i < length)
+		{
+			const unsigned char c = s[i];
+			const int extra = c < 0x80 ? 0 : (c >> 5) == 0x6 ? 1 : (c >> 4) == 0xE ? 2 : (c >> 3) == 0x1E ? 3 : -1;
+			if (extra < 0 || i + extra >= length)
+			{
+				i++;
+				continue;
+			}
+			char32_t code = extra == 0 ? c : (c & (0x3F >> extra));
+			for (int k = 1; k <= extra; k++)
+				code = (code << 6) | (s[i + k] & 0x3F);
+			converted.push_back(code);
+			i += extra + 1;
+		}
+	}
+
+	const TCHAR* Get() const { return converted.c_str(); }
+	int32 Length() const { return static_cast<int32>(converted.size()); }
+
+private:
+	std::u32string converted;
+};
+
+// UTF-32 to UTF-8
+class FTCHARToUTF8
+{
+public:
+	explicit FTCHARToUTF8(const TCHAR* source)
+	{
+		for (; *source; source++)
+		{
+			const char32_t c = *source;
+			if (c < 0x80)
+				converted.push_back(static_cast<char>(c));
+			else if (c < 0x800)
+			{
+				converted.push_back(static_cast<char>(0xC0 | (c >> 6)));
+				converted.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+			}
+			else if (c < 0x10000)
+			{
+				converted.push_back(static_cast<char>(0xE0 | (c >> 12)));
+				converted.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+				converted.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+			}
+			else
+			{
+				converted.push_back(static_cast<char>(0xF0 | (c >> 18)));
+				converted.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+				converted.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+				converted.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+			}
+		}
+	}
+
+	const ANSICHAR* Get() const { return converted.c_str(); }
+	int32 Length() const { return static_cast<int32>(converted.size()); }
+
+private:
+	std::string converted;
+};
+
+class FString
+{
+public:
+	FString() = default;
+	FString(const TCHAR* text) : value(text) {}
+	explicit FString(const FUTF8ToTCHAR& text) : value(text.Get(), text.Length()) {}
+
+	const TCHAR* operator*() const { return value.c_str(); }
+	bool operator==(const FString& other) const { return value == other.value; }
+	int32 Len() const { return static_cast<int32>(value.size()); }
+
+private:
+	std::u32string value;
+};
+
+#endif // VPET_TEST_CORE_MINIMAL_H
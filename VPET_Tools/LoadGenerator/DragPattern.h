@@ -0,0 +1,172 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef VPET_LOADGENERATOR_DRAGPATTERN_H
+#define VPET_LOADGENERATOR_DRAGPATTERN_H
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace VPET
+{
+namespace Tools
+{
+	//! Touch input of one simulated tablet user: pauses between drags, each drag
+	//! moves or turns one object along an eased path with a little finger tremor.
+	class DragPattern
+	{
+	public:
+		enum class Kind { MOVE, ROTATE };
+
+		struct Sample
+		{
+			bool dragging = false;
+			//! first sample of a new drag, the tablet locks the object here
+			bool started = false;
+			//! the drag just ended, the tablet unlocks the object here
+			bool finished = false;
+			Kind kind = Kind::MOVE;
+			int objectID = 1;
+			float position[3] = { 0, 0, 0 };
+			float rotation[4] = { 0, 0, 0, 1 };
+		};
+
+		DragPattern(unsigned seed, int firstObjectID, int lastObjectID) :
+			m_random(seed),
+			m_firstObjectID(firstObjectID),
+			m_lastObjectID(lastObjectID < firstObjectID ? firstObjectID : lastObjectID),
+			m_dragging(false),
+			m_objectID(firstObjectID),
+			m_kind(Kind::MOVE),
+			m_duration(0),
+			m_angle(0),
+			m_startAngle(0)
+		{
+			for (int i = 0; i < 3; i++)
+				m_from[i] = m_to[i] = 0;
+			m_phaseEnd = std::chrono::steady_clock::now() + randomMillis(200, 1500);
+		}
+
+		Sample sample(std::chrono::steady_clock::time_point now)
+		{
+			Sample result;
+			if (!m_dragging)
+			{
+				if (now < m_phaseEnd)
+					return result;
+				beginDrag(now);
+				result.started = true;
+			}
+
+			const double t = std::chrono::duration<double>(now - m_phaseStart).count() / m_duration;
+			const double eased = ease(t < 1.0 ? t : 1.0);
+			result.dragging = true;
+			result.kind = m_kind;
+			result.objectID = m_objectID;
+
+			if (m_kind == Kind::MOVE)
+			{
+				for (int i = 0; i < 3; i++)
+					result.position[i] = float(m_from[i] + (m_to[i] - m_from[i]) * eased + tremor());
+			}
+			else
+			{
+				const double angle = m_startAngle + m_angle * eased + tremor() * 0.01;
+				result.rotation[1] = float(std::sin(angle * 0.5));
+				result.rotation[3] = float(std::cos(angle * 0.5));
+			}
+
+			if (t >= 1.0)
+			{
+				m_dragging = false;
+				result.finished = true;
+				for (int i = 0; i < 3; i++)
+					m_from[i] = m_to[i];
+				m_startAngle += m_angle;
+				m_phaseEnd = now + randomMillis(200, 1500);
+			}
+			return result;
+		}
+
+	private:
+		void beginDrag(std::chrono::steady_clock::time_point now)
+		{
+			m_dragging = true;
+			m_phaseStart = now;
+			m_duration = std::uniform_real_distribution<double>(0.5, 3.0)(m_random);
+			m_objectID = std::uniform_int_distribution<int>(m_firstObjectID, m_lastObjectID)(m_random);
+			m_kind = std::uniform_int_distribution<int>(0, 3)(m_random) == 0 ? Kind::ROTATE : Kind::MOVE;
+			std::uniform_real_distribution<double> offset(-200.0, 200.0);
+			for (int i = 0; i < 3; i++)
+				m_to[i] = m_from[i] + (i == 1 ? offset(m_random) * 0.25 : offset(m_random));
+			m_angle = std::uniform_real_distribution<double>(-3.1, 3.1)(m_random);
+		}
+
+		//! smoothstep, fingers accelerate and slow down
+		static double ease(double t)
+		{
+			return t * t * (3.0 - 2.0 * t);
+		}
+
+		double tremor()
+		{
+			return std::normal_distribution<double>(0.0, 0.3)(m_random);
+		}
+
+		std::chrono::milliseconds randomMillis(int min, int max)
+		{
+			return std::chrono::milliseconds(std::uniform_int_distribution<int>(min, max)(m_random));
+		}
+
+		std::mt19937 m_random;
+		int m_firstObjectID;
+		int m_lastObjectID;
+
+		bool m_dragging;
+		int m_objectID;
+		Kind m_kind;
+		std::chrono::steady_clock::time_point m_phaseStart;
+		std::chrono::steady_clock::time_point m_phaseEnd;
+		double m_duration;
+		double m_from[3];
+		double m_to[3];
+		double m_angle;
+		double m_startAngle;
+	};
+}
+}
+
+#endif // VPET_LOADGENERATOR_DRAGPATTERN_H
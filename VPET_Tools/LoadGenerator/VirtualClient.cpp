@@ -0,0 +1,288 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#include "VirtualClient.h"
+
+#include <thread>
+
+#include "DragPattern.h"
+#include "VPETProtocol.h"
+
+namespace VPET
+{
+namespace Tools
+{
+	using namespace VPET::Protocol;
+	using Clock = std::chrono::steady_clock;
+
+	namespace
+	{
+		std::string endpoint(const std::string& host, int port)
+		{
+			return "tcp://" + host + ":" + std::to_string(port);
+		}
+
+		int64_t microsBetween(Clock::time_point start, Clock::time_point end)
+		{
+			return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+		}
+
+		//! FNV-1a, identifies an echoed message
+		uint64_t messageHash(const uint8_t* data, size_t size)
+		{
+			uint64_t hash = 14695981039346656037ull;
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= data[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		void setLinger(zmq::socket_t& socket)
+		{
+			const int linger = 0;
+			socket.setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+		}
+	}
+
+	VirtualClient::VirtualClient(zmq::context_t& context, const LoadConfig& config, uint8_t clientID) :
+		m_context(context),
+		m_config(config),
+		m_clock(config.framerate)
+	{
+		m_result.clientID = clientID;
+	}
+
+	void VirtualClient::run(const std::atomic<bool>& stop)
+	{
+		// subscribe first, the subscription needs a moment to reach the server
+		zmq::socket_t receiver(m_context, ZMQ_SUB);
+		setLinger(receiver);
+		if (m_config.sendUpdates)
+		{
+			receiver.setsockopt(ZMQ_SUBSCRIBE, "", 0);
+			receiver.connect(endpoint(m_config.syncHost, m_config.broadcastPort));
+		}
+
+		if (m_config.downloadScene)
+			downloadScene(stop);
+
+		if (m_config.sendUpdates && !stop)
+			streamUpdates(stop, receiver);
+	}
+
+	void VirtualClient::downloadScene(const std::atomic<bool>& stop)
+	{
+		zmq::socket_t socket(m_context, ZMQ_REQ);
+		setLinger(socket);
+		const int timeout = m_config.requestTimeoutMs;
+		socket.setsockopt(ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+		socket.connect(endpoint(m_config.sceneHost, m_config.scenePort));
+
+		const Clock::time_point downloadStart = Clock::now();
+		for (const std::string& request : m_config.requests)
+		{
+			if (stop)
+				return;
+			RequestResult result;
+			result.request = request;
+			const Clock::time_point start = Clock::now();
+			socket.send(request.data(), request.size());
+			zmq::message_t reply;
+			if (!socket.recv(&reply))
+			{
+				// a REQ socket without reply can not send again, give up on this client
+				result.timedOut = true;
+				result.micros = microsBetween(start, Clock::now());
+				m_result.requests.push_back(result);
+				return;
+			}
+			result.micros = microsBetween(start, Clock::now());
+			result.bytes = int64_t(reply.size());
+			m_result.requests.push_back(result);
+		}
+		m_result.downloadMicros = microsBetween(downloadStart, Clock::now());
+		m_result.downloadComplete = true;
+	}
+
+	void VirtualClient::streamUpdates(const std::atomic<bool>& stop, zmq::socket_t& receiver)
+	{
+		zmq::socket_t sender(m_context, ZMQ_PUB);
+		setLinger(sender);
+		sender.connect(endpoint(m_config.syncHost, m_config.updatePort));
+		// PUB drops everything until connected
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+		DragPattern pattern(m_result.clientID * 7919u, m_config.firstObjectID, m_config.lastObjectID);
+		const auto period = std::chrono::microseconds(1000000 / (m_config.rate > 0 ? m_config.rate : 30));
+		const auto echoTimeout = std::chrono::milliseconds(m_config.echoTimeoutMs);
+		const Clock::time_point end = Clock::now() + std::chrono::seconds(m_config.durationS);
+		Clock::time_point nextSend = Clock::now();
+		int lockedObject = -1;
+		uint8_t buffer[64];
+
+		zmq::pollitem_t items[] = { { static_cast<void*>(receiver), 0, ZMQ_POLLIN, 0 } };
+
+		while (!stop && Clock::now() < end)
+		{
+			const Clock::time_point now = Clock::now();
+			if (now >= nextSend)
+			{
+				m_clock.update(now);
+				const DragPattern::Sample sample = pattern.sample(now);
+				if (sample.started && m_config.sendLocks)
+				{
+					sendLock(sender, sample.objectID, true);
+					lockedObject = sample.objectID;
+				}
+				if (sample.dragging)
+				{
+					Header header;
+					header.clientID = m_result.clientID;
+					header.time = m_clock.time();
+					ParameterMessageWriter writer(buffer, sizeof(buffer), header);
+					if (sample.kind == DragPattern::Kind::MOVE)
+						writer.addParameter(m_config.sceneID, uint16_t(sample.objectID), 0, ParameterType::VECTOR3, sample.position, sizeof(sample.position));
+					else
+						writer.addParameter(m_config.sceneID, uint16_t(sample.objectID), 1, ParameterType::QUATERNION, sample.rotation, sizeof(sample.rotation));
+
+					const Clock::time_point sendTime = Clock::now();
+					if (sender.send(buffer, writer.size(), ZMQ_DONTWAIT) == writer.size())
+					{
+						m_inFlight[messageHash(buffer, writer.size())] = sendTime;
+						m_result.sent++;
+						m_result.sentBytes += int64_t(writer.size());
+					}
+					else
+						m_result.sendFailures++;
+				}
+				if (sample.finished && lockedObject >= 0)
+				{
+					sendLock(sender, lockedObject, false);
+					lockedObject = -1;
+				}
+				nextSend += period;
+				// do not burst after a stall
+				if (nextSend < now)
+					nextSend = now + period;
+			}
+
+			const long timeout = long(std::chrono::duration_cast<std::chrono::milliseconds>(nextSend - Clock::now()).count());
+			zmq::poll(items, 1, timeout > 0 ? timeout : 0);
+			if (items[0].revents & ZMQ_POLLIN)
+				receive(receiver);
+			expire(Clock::now(), echoTimeout);
+		}
+
+		if (lockedObject >= 0)
+			sendLock(sender, lockedObject, false);
+
+		// collect the late echoes
+		const Clock::time_point drainEnd = Clock::now() + echoTimeout;
+		while (!m_inFlight.empty() && Clock::now() < drainEnd)
+		{
+			zmq::poll(items, 1, 10);
+			if (items[0].revents & ZMQ_POLLIN)
+				receive(receiver);
+		}
+		m_result.dropped += int64_t(m_inFlight.size());
+		m_inFlight.clear();
+	}
+
+	void VirtualClient::sendLock(zmq::socket_t& sender, int objectID, bool locked)
+	{
+		LockMessage lock;
+		lock.header.clientID = m_result.clientID;
+		lock.header.time = m_clock.time();
+		lock.header.type = MessageType::LOCK;
+		lock.sceneID = m_config.sceneID;
+		lock.objectID = uint16_t(objectID);
+		lock.locked = locked;
+		uint8_t buffer[LOCK_MESSAGE_SIZE];
+		const size_t size = encodeLock(buffer, sizeof(buffer), lock);
+		if (sender.send(buffer, size, ZMQ_DONTWAIT) == size)
+			m_result.locksSent++;
+		else
+			m_result.sendFailures++;
+	}
+
+	void VirtualClient::receive(zmq::socket_t& receiver)
+	{
+		zmq::message_t message;
+		while (receiver.recv(&message, ZMQ_DONTWAIT))
+		{
+			const Clock::time_point now = Clock::now();
+			const uint8_t* data = static_cast<const uint8_t*>(message.data());
+			Header header;
+			if (!decodeHeader(data, message.size(), header))
+				continue;
+
+			if (header.type == MessageType::SYNC)
+			{
+				m_clock.set(header.time);
+				m_result.syncs++;
+			}
+			else if (header.type != MessageType::PARAMETERUPDATE)
+				continue;
+			else if (header.clientID != m_result.clientID)
+				m_result.foreignUpdates++;
+			else
+			{
+				auto sent = m_inFlight.find(messageHash(data, message.size()));
+				if (sent == m_inFlight.end())
+					continue;
+				m_result.roundTripMicros.add(microsBetween(sent->second, now));
+				m_result.echoed++;
+				m_inFlight.erase(sent);
+			}
+		}
+	}
+
+	void VirtualClient::expire(Clock::time_point now, std::chrono::milliseconds timeout)
+	{
+		for (auto it = m_inFlight.begin(); it != m_inFlight.end();)
+		{
+			if (now - it->second > timeout)
+			{
+				m_result.dropped++;
+				it = m_inFlight.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+}
+}
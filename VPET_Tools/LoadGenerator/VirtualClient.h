@@ -0,0 +1,146 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef VPET_LOADGENERATOR_VIRTUALCLIENT_H
+#define VPET_LOADGENERATOR_VIRTUALCLIENT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <zmq.hpp>
+
+#include "LatencyHistogram.h"
+#include "SyncClock.h"
+
+namespace VPET
+{
+namespace Tools
+{
+	struct LoadConfig
+	{
+		//! Scene distribution, 5555 for the Unreal plugin, 5565 for the USD distributor
+		std::string sceneHost = "127.0.0.1";
+		int scenePort = 5555;
+		std::vector<std::string> requests = { "header", "nodes", "objects", "textures", "materials" };
+		int requestTimeoutMs = 10000;
+
+		//! Sync server, the DataHub or VPETSyncRelay
+		std::string syncHost = "127.0.0.1";
+		int updatePort = 5557;
+		int broadcastPort = 5556;
+
+		int clients = 1;
+		int firstClientID = 100;
+		//! Delay between two client starts
+		int rampMs = 100;
+
+		bool downloadScene = true;
+		bool sendUpdates = true;
+		bool sendLocks = true;
+		//! Parameter messages per second while dragging
+		int rate = 30;
+		int durationS = 10;
+		//! Scene the edited objects belong to, the ID of the distributing host
+		uint8_t sceneID = 0;
+		int firstObjectID = 1;
+		int lastObjectID = 10;
+		int framerate = 60;
+		//! An update not echoed by the sync server within this time counts as dropped
+		int echoTimeoutMs = 2000;
+	};
+
+	struct RequestResult
+	{
+		std::string request;
+		int64_t bytes = 0;
+		int64_t micros = 0;
+		bool timedOut = false;
+	};
+
+	struct ClientResult
+	{
+		uint8_t clientID = 0;
+		bool downloadComplete = false;
+		int64_t downloadMicros = 0;
+		std::vector<RequestResult> requests;
+
+		int64_t sent = 0;
+		int64_t sentBytes = 0;
+		int64_t sendFailures = 0;
+		int64_t locksSent = 0;
+		int64_t echoed = 0;
+		int64_t dropped = 0;
+		int64_t foreignUpdates = 0;
+		int64_t syncs = 0;
+		//! Send to receiving the own update back from the sync server
+		LatencyHistogram roundTripMicros;
+	};
+
+	//! One simulated tablet: downloads the scene like a client on startup and then
+	//! streams drag updates through the sync server. The own updates come back on
+	//! the broadcast socket and give the round trip time through the server.
+	class VirtualClient
+	{
+	public:
+		VirtualClient(zmq::context_t& context, const LoadConfig& config, uint8_t clientID);
+
+		//! Runs on its own thread, all sockets are created and used there
+		void run(const std::atomic<bool>& stop);
+
+		const ClientResult& result() const { return m_result; }
+
+	private:
+		void downloadScene(const std::atomic<bool>& stop);
+		void streamUpdates(const std::atomic<bool>& stop, zmq::socket_t& receiver);
+		void sendLock(zmq::socket_t& sender, int objectID, bool locked);
+		void receive(zmq::socket_t& receiver);
+		void expire(std::chrono::steady_clock::time_point now, std::chrono::milliseconds timeout);
+
+		zmq::context_t& m_context;
+		const LoadConfig& m_config;
+		SyncClock m_clock;
+		ClientResult m_result;
+
+		//! Send time of every update not yet echoed, keyed by a hash of the message
+		std::unordered_map<uint64_t, std::chrono::steady_clock::time_point> m_inFlight;
+	};
+}
+}
+
+#endif // VPET_LOADGENERATOR_VIRTUALCLIENT_H
@@ -0,0 +1,296 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! Simulated tablets for load testing the scene distribution and the update path.
+//! Usage: VPETLoadGenerator [options], see --help
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VirtualClient.h"
+
+using namespace VPET::Tools;
+
+namespace
+{
+	std::atomic<bool> g_stop(false);
+
+	void onSignal(int)
+	{
+		g_stop = true;
+	}
+
+	void printUsage()
+	{
+		std::printf(
+			"VPETLoadGenerator - simulated tablets for the scene distribution and the sync server\n"
+			"  --clients <n>           number of virtual clients, default 1\n"
+			"  --first-id <id>         client ID of the first client, default 100\n"
+			"  --ramp <ms>             delay between client starts, default 100\n"
+			"  --scene-host <host>     scene distribution host, default 127.0.0.1\n"
+			"  --scene-port <port>     5555 for Unreal, 5565 for USD, default 5555\n"
+			"  --requests <a,b,..>     scene requests, default header,nodes,objects,textures,materials\n"
+			"  --request-timeout <ms>  default 10000\n"
+			"  --sync-host <host>      sync server host, default 127.0.0.1\n"
+			"  --update-port <port>    default 5557\n"
+			"  --broadcast-port <port> default 5556\n"
+			"  --rate <hz>             updates per second while dragging, default 30\n"
+			"  --duration <s>          update phase length, default 10\n"
+			"  --scene-id <id>         scene ID of the edited objects, default 0\n"
+			"  --objects <first-last>  edited object IDs, default 1-10\n"
+			"  --echo-timeout <ms>     updates not echoed in time are dropped, default 2000\n"
+			"  --no-scene              skip the scene download\n"
+			"  --no-updates            only download the scene\n"
+			"  --no-locks              do not lock the dragged objects\n");
+	}
+
+	std::vector<std::string> splitList(const std::string& list)
+	{
+		std::vector<std::string> items;
+		std::stringstream stream(list);
+		std::string item;
+		while (std::getline(stream, item, ','))
+			if (!item.empty())
+				items.push_back(item);
+		return items;
+	}
+
+	struct RequestSummary
+	{
+		int count = 0;
+		int timeouts = 0;
+		int64_t bytes = 0;
+		LatencyHistogram micros;
+	};
+
+	void printReport(const LoadConfig& config, const std::vector<std::unique_ptr<VirtualClient>>& clients, double seconds)
+	{
+		std::printf("\n[LoadGenerator] %zu clients, %.1fs\n", clients.size(), seconds);
+
+		if (config.downloadScene)
+		{
+			std::map<std::string, RequestSummary> requests;
+			LatencyHistogram total;
+			int complete = 0;
+			for (const auto& client : clients)
+			{
+				const ClientResult& result = client->result();
+				for (const RequestResult& request : result.requests)
+				{
+					RequestSummary& summary = requests[request.request];
+					summary.count++;
+					summary.bytes += request.bytes;
+					if (request.timedOut)
+						summary.timeouts++;
+					else
+						summary.micros.add(request.micros);
+				}
+				if (result.downloadComplete)
+				{
+					complete++;
+					total.add(result.downloadMicros);
+				}
+			}
+			std::printf("scene download, %d of %zu complete\n", complete, clients.size());
+			std::printf("  request         count  timeouts     KB each   mean ms    p90 ms    max ms\n");
+			for (const std::string& name : config.requests)
+			{
+				const RequestSummary& summary = requests[name];
+				const int answered = summary.count - summary.timeouts;
+				std::printf("  %-14s %6d %9d %11.1f %9.1f %9.1f %9.1f\n", name.c_str(), summary.count, summary.timeouts,
+					answered > 0 ? summary.bytes / 1024.0 / answered : 0.0, summary.micros.mean() / 1000.0,
+					summary.micros.percentile(90) / 1000.0, summary.micros.max() / 1000.0);
+			}
+			std::printf("  %-14s %6lld %9s %11s %9.1f %9.1f %9.1f\n", "handshake", (long long)total.count(), "", "",
+				total.mean() / 1000.0, total.percentile(90) / 1000.0, total.max() / 1000.0);
+		}
+
+		if (config.sendUpdates)
+		{
+			LatencyHistogram roundTrip;
+			int64_t sent = 0, echoed = 0, dropped = 0, failures = 0, bytes = 0;
+			std::printf("updates\n");
+			std::printf("  client     sent   echoed  dropped  send fail   foreign   rtt p50/p99/max ms\n");
+			for (const auto& client : clients)
+			{
+				const ClientResult& result = client->result();
+				const LatencyHistogram& rtt = result.roundTripMicros;
+				std::printf("  %6d %8lld %8lld %8lld %10lld %9lld   %.2f/%.2f/%.2f\n", result.clientID,
+					(long long)result.sent, (long long)result.echoed, (long long)result.dropped, (long long)result.sendFailures,
+					(long long)result.foreignUpdates, rtt.percentile(50) / 1000.0, rtt.percentile(99) / 1000.0, rtt.max() / 1000.0);
+				roundTrip.merge(rtt);
+				sent += result.sent;
+				echoed += result.echoed;
+				dropped += result.dropped;
+				failures += result.sendFailures;
+				bytes += result.sentBytes;
+			}
+			std::printf("  all: %lld sent (%.1f KB), %lld echoed, %lld dropped (%.2f%%), %lld send failures\n",
+				(long long)sent, bytes / 1024.0, (long long)echoed, (long long)dropped, sent > 0 ? 100.0 * dropped / sent : 0.0, (long long)failures);
+			std::printf("  round trip ms: p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f  mean %.2f\n",
+				roundTrip.percentile(50) / 1000.0, roundTrip.percentile(90) / 1000.0, roundTrip.percentile(99) / 1000.0,
+				roundTrip.percentile(99.9) / 1000.0, roundTrip.max() / 1000.0, roundTrip.mean() / 1000.0);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	LoadConfig config;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--help" || arg == "-h")
+		{
+			printUsage();
+			return 0;
+		}
+		if (arg == "--no-scene")
+		{
+			config.downloadScene = false;
+			continue;
+		}
+		if (arg == "--no-updates")
+		{
+			config.sendUpdates = false;
+			continue;
+		}
+		if (arg == "--no-locks")
+		{
+			config.sendLocks = false;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+			printUsage();
+			return 1;
+		}
+		const std::string value = argv[++i];
+		if (arg == "--clients")
+			config.clients = std::atoi(value.c_str());
+		else if (arg == "--first-id")
+			config.firstClientID = std::atoi(value.c_str());
+		else if (arg == "--ramp")
+			config.rampMs = std::atoi(value.c_str());
+		else if (arg == "--scene-host")
+			config.sceneHost = value;
+		else if (arg == "--scene-port")
+			config.scenePort = std::atoi(value.c_str());
+		else if (arg == "--requests")
+			config.requests = splitList(value);
+		else if (arg == "--request-timeout")
+			config.requestTimeoutMs = std::atoi(value.c_str());
+		else if (arg == "--sync-host")
+			config.syncHost = value;
+		else if (arg == "--update-port")
+			config.updatePort = std::atoi(value.c_str());
+		else if (arg == "--broadcast-port")
+			config.broadcastPort = std::atoi(value.c_str());
+		else if (arg == "--rate")
+			config.rate = std::atoi(value.c_str());
+		else if (arg == "--duration")
+			config.durationS = std::atoi(value.c_str());
+		else if (arg == "--scene-id")
+			config.sceneID = uint8_t(std::atoi(value.c_str()));
+		else if (arg == "--objects")
+		{
+			const size_t dash = value.find('-');
+			config.firstObjectID = std::atoi(value.substr(0, dash).c_str());
+			config.lastObjectID = dash == std::string::npos ? config.firstObjectID : std::atoi(value.substr(dash + 1).c_str());
+		}
+		else if (arg == "--echo-timeout")
+			config.echoTimeoutMs = std::atoi(value.c_str());
+		else
+		{
+			std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (config.clients < 1 || config.firstClientID + config.clients > 255)
+	{
+		std::fprintf(stderr, "Client IDs have to stay below 255\n");
+		return 1;
+	}
+
+	std::signal(SIGINT, onSignal);
+	std::signal(SIGTERM, onSignal);
+
+	zmq::context_t context(2);
+	std::vector<std::unique_ptr<VirtualClient>> clients;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < config.clients; i++)
+		clients.emplace_back(new VirtualClient(context, config, uint8_t(config.firstClientID + i)));
+
+	std::printf("[LoadGenerator] %d clients, scene %s:%d, sync %s:%d/%d\n", config.clients,
+		config.sceneHost.c_str(), config.scenePort, config.syncHost.c_str(), config.updatePort, config.broadcastPort);
+	std::fflush(stdout);
+
+	const auto start = std::chrono::steady_clock::now();
+	try
+	{
+		for (int i = 0; i < config.clients && !g_stop; i++)
+		{
+			VirtualClient* client = clients[i].get();
+			threads.emplace_back([client]() { client->run(g_stop); });
+			std::this_thread::sleep_for(std::chrono::milliseconds(config.rampMs));
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+	catch (const zmq::error_t& e)
+	{
+		std::fprintf(stderr, "[LoadGenerator] zeroMQ error: %s\n", e.what());
+		g_stop = true;
+		for (std::thread& thread : threads)
+			thread.join();
+		return 1;
+	}
+
+	printReport(config, clients, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	return 0;
+}
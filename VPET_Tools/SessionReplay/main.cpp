@@ -0,0 +1,306 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! Replays a recorded session log into a socket, or prints what it contains.
+//! Usage: VPETSessionReplay <log> [options], see --help
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <zmq.hpp>
+
+#include "LatencyHistogram.h"
+#include "VPETProtocol.h"
+#include "VPETSessionLog.h"
+
+using namespace VPET::Protocol;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+	std::atomic<bool> g_stop(false);
+
+	void onSignal(int)
+	{
+		g_stop = true;
+	}
+
+	const char* const messageTypeNames[] = { "PARAMETERUPDATE", "LOCK", "SYNC", "PING", "RESENDUPDATE", "UNDOREDOADD", "RESETOBJECT", "DATAHUB" };
+
+	struct ReplayConfig
+	{
+		std::string logPath;
+		//! PUB endpoint, bind to stand in for the sync server, connect to feed a sync server
+		std::string endpoint = "tcp://*:5556";
+		bool bind = true;
+		//! Multiple of the recorded speed, 0 replays as fast as possible
+		double speed = 1.0;
+		bool inbound = true;
+		bool outbound = false;
+		int loops = 1;
+		//! Time for the subscribers to connect before the first message
+		int warmupMs = 1000;
+		bool info = false;
+	};
+
+	void printUsage()
+	{
+		std::printf(
+			"VPETSessionReplay <log> - replays a recorded VPET session\n"
+			"  --info                 only print the content of the log\n"
+			"  --bind <endpoint>      publish on a bound socket, default tcp://*:5556\n"
+			"                         (the Unreal plugin subscribes there like to a sync server)\n"
+			"  --connect <endpoint>   publish to a sync server, e.g. tcp://127.0.0.1:5557\n"
+			"  --speed <x>            multiple of the recorded speed, 0 for as fast as possible, default 1\n"
+			"  --direction <d>        inbound, outbound or all, default inbound\n"
+			"  --loop <n>             replay n times, default 1\n"
+			"  --warmup <ms>          wait for subscribers before starting, default 1000\n");
+	}
+
+	int printInfo(SessionLogReader& reader)
+	{
+		struct ClientInfo { int64_t messages = 0; int64_t bytes = 0; int64_t parameters = 0; };
+		std::map<int, ClientInfo> clients;
+		int64_t byType[8] = { 0 };
+		int64_t byDirection[2] = { 0 };
+		int64_t records = 0, bytes = 0, malformed = 0;
+		uint64_t first = 0, last = 0, previous = 0;
+		VPET::Tools::LatencyHistogram gaps;
+
+		LogRecord record;
+		while (reader.next(record))
+		{
+			if (records == 0)
+				first = record.timeNanos;
+			else
+				gaps.add(int64_t((record.timeNanos - previous) / 1000));
+			previous = last = record.timeNanos;
+			records++;
+			bytes += record.size;
+			byDirection[record.direction == LogDirection::OUTBOUND ? 1 : 0]++;
+
+			Header header;
+			if (!decodeHeader(record.data, record.size, header))
+			{
+				malformed++;
+				continue;
+			}
+			if (uint8_t(header.type) < 8)
+				byType[uint8_t(header.type)]++;
+			ClientInfo& client = clients[header.clientID];
+			client.messages++;
+			client.bytes += record.size;
+			if (header.type == MessageType::PARAMETERUPDATE)
+			{
+				ParameterMessageReader parameters(record.data, record.size);
+				ParameterRecord parameter;
+				while (parameters.next(parameter))
+					client.parameters++;
+			}
+		}
+
+		const time_t started = time_t(reader.startUnixMicros() / 1000000);
+		char startText[64];
+		std::strftime(startText, sizeof(startText), "%Y-%m-%d %H:%M:%S", std::localtime(&started));
+		const double seconds = (last - first) / 1e9;
+		std::printf("recorded %s, %.1fs, %lld messages (%lld inbound, %lld outbound), %.1f KB, %lld malformed\n",
+			startText, seconds, (long long)records, (long long)byDirection[0], (long long)byDirection[1], bytes / 1024.0, (long long)malformed);
+		std::printf("message gaps us: p50 %lld  p99 %lld  max %lld\n", (long long)gaps.percentile(50), (long long)gaps.percentile(99), (long long)gaps.max());
+		for (int i = 0; i < 8; i++)
+			if (byType[i])
+				std::printf("  %-16s %lld\n", messageTypeNames[i], (long long)byType[i]);
+		for (const auto& entry : clients)
+			std::printf("  client %3d: %lld messages, %.1f KB, %lld parameters, %.1f msg/s\n", entry.first, (long long)entry.second.messages,
+				entry.second.bytes / 1024.0, (long long)entry.second.parameters, seconds > 0 ? entry.second.messages / seconds : 0.0);
+		return 0;
+	}
+
+	int replay(SessionLogReader& reader, const ReplayConfig& config)
+	{
+		zmq::context_t context(1);
+		zmq::socket_t socket(context, ZMQ_PUB);
+		// an accelerated replay must not run into the high water mark, PUB would drop silently
+		const int highWaterMark = 0;
+		const int linger = 5000;
+		socket.setsockopt(ZMQ_SNDHWM, &highWaterMark, sizeof(highWaterMark));
+		socket.setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+		if (config.bind)
+			socket.bind(config.endpoint);
+		else
+			socket.connect(config.endpoint);
+		std::this_thread::sleep_for(std::chrono::milliseconds(config.warmupMs));
+
+		int64_t sent = 0, bytes = 0, late = 0;
+		VPET::Tools::LatencyHistogram lateness;
+		const Clock::time_point replayStart = Clock::now();
+
+		for (int loop = 0; loop < config.loops && !g_stop; loop++)
+		{
+			reader.rewind();
+			const Clock::time_point loopStart = Clock::now();
+			uint64_t firstNanos = 0;
+			bool first = true;
+			LogRecord record;
+			while (!g_stop && reader.next(record))
+			{
+				const bool wanted = record.direction == LogDirection::OUTBOUND ? config.outbound : config.inbound;
+				if (!wanted)
+					continue;
+				if (first)
+				{
+					firstNanos = record.timeNanos;
+					first = false;
+				}
+
+				if (config.speed > 0)
+				{
+					const auto due = loopStart + std::chrono::nanoseconds(int64_t((record.timeNanos - firstNanos) / config.speed));
+					const Clock::time_point now = Clock::now();
+					if (now < due)
+						std::this_thread::sleep_until(due);
+					else
+					{
+						lateness.add(std::chrono::duration_cast<std::chrono::microseconds>(now - due).count());
+						if (now - due > std::chrono::milliseconds(1))
+							late++;
+					}
+				}
+
+				socket.send(record.data, record.size);
+				sent++;
+				bytes += record.size;
+			}
+		}
+
+		const double seconds = std::chrono::duration<double>(Clock::now() - replayStart).count();
+		std::printf("replayed %lld messages, %.1f KB in %.2fs (%.0f msg/s), %lld more than 1ms late, lateness p99 %lldus\n",
+			(long long)sent, bytes / 1024.0, seconds, seconds > 0 ? sent / seconds : 0.0, (long long)late, (long long)lateness.percentile(99));
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	ReplayConfig config;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--help" || arg == "-h")
+		{
+			printUsage();
+			return 0;
+		}
+		if (arg == "--info")
+		{
+			config.info = true;
+			continue;
+		}
+		if (arg.compare(0, 2, "--") != 0)
+		{
+			config.logPath = arg;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+			printUsage();
+			return 1;
+		}
+		const std::string value = argv[++i];
+		if (arg == "--bind")
+		{
+			config.endpoint = value;
+			config.bind = true;
+		}
+		else if (arg == "--connect")
+		{
+			config.endpoint = value;
+			config.bind = false;
+		}
+		else if (arg == "--speed")
+			config.speed = std::atof(value.c_str());
+		else if (arg == "--direction")
+		{
+			config.inbound = value == "inbound" || value == "all";
+			config.outbound = value == "outbound" || value == "all";
+		}
+		else if (arg == "--loop")
+			config.loops = std::atoi(value.c_str());
+		else if (arg == "--warmup")
+			config.warmupMs = std::atoi(value.c_str());
+		else
+		{
+			std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (config.logPath.empty())
+	{
+		printUsage();
+		return 1;
+	}
+
+	SessionLogReader reader;
+	if (!reader.open(config.logPath))
+	{
+		std::fprintf(stderr, "Could not read session log %s\n", config.logPath.c_str());
+		return 1;
+	}
+
+	if (config.info)
+		return printInfo(reader);
+
+	std::signal(SIGINT, onSignal);
+	std::signal(SIGTERM, onSignal);
+	try
+	{
+		return replay(reader, config);
+	}
+	catch (const zmq::error_t& e)
+	{
+		std::fprintf(stderr, "[SessionReplay] zeroMQ error: %s\n", e.what());
+		return 1;
+	}
+}
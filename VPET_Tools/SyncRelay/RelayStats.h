@@ -0,0 +1,115 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef VPET_SYNCRELAY_RELAYSTATS_H
+#define VPET_SYNCRELAY_RELAYSTATS_H
+
+#include <cstdint>
+
+#include "LatencyHistogram.h"
+
+namespace VPET
+{
+namespace Tools
+{
+	//! Counters of one publishing client, keyed by the client ID of the message header
+	struct ClientCounters
+	{
+		int64_t messages = 0;
+		int64_t bytes = 0;
+		int64_t parameters = 0;
+		int64_t locks = 0;
+		int64_t unlocks = 0;
+		int64_t lockConflicts = 0;
+		int64_t syncs = 0;
+		int64_t resendRequests = 0;
+		int64_t undoRedo = 0;
+		int64_t resets = 0;
+		int64_t malformed = 0;
+		int64_t pings = 0;
+
+		void add(const ClientCounters& other)
+		{
+			messages += other.messages;
+			bytes += other.bytes;
+			parameters += other.parameters;
+			locks += other.locks;
+			unlocks += other.unlocks;
+			lockConflicts += other.lockConflicts;
+			syncs += other.syncs;
+			resendRequests += other.resendRequests;
+			undoRedo += other.undoRedo;
+			resets += other.resets;
+			malformed += other.malformed;
+			pings += other.pings;
+		}
+	};
+
+	//! Lifetime totals and the current report interval of one client.
+	//! The relay latency covers receive to publish, the clock lag the distance
+	//! between the message time step and the relay clock in milliseconds.
+	struct ClientStats
+	{
+		ClientCounters total;
+		ClientCounters interval;
+		LatencyHistogram relayMicros;
+		LatencyHistogram intervalRelayMicros;
+		int64_t lagSumSteps = 0;
+		int64_t lagCount = 0;
+		int lagMaxSteps = 0;
+
+		void addLag(int steps)
+		{
+			lagSumSteps += steps;
+			lagCount++;
+			if (lagCount == 1 || steps > lagMaxSteps)
+				lagMaxSteps = steps;
+		}
+
+		void closeInterval()
+		{
+			total.add(interval);
+			relayMicros.merge(intervalRelayMicros);
+			interval = ClientCounters();
+			intervalRelayMicros.reset();
+			lagSumSteps = 0;
+			lagCount = 0;
+			lagMaxSteps = 0;
+		}
+	};
+}
+}
+
+#endif // VPET_SYNCRELAY_RELAYSTATS_H
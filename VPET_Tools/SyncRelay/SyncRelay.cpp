@@ -0,0 +1,368 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#include "SyncRelay.h"
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "VPETProtocol.h"
+
+namespace VPET
+{
+namespace Tools
+{
+	using namespace VPET::Protocol;
+	using Clock = std::chrono::steady_clock;
+
+	namespace
+	{
+		std::string endpoint(const std::string& address, int port)
+		{
+			return "tcp://" + address + ":" + std::to_string(port);
+		}
+
+		int64_t microsBetween(Clock::time_point start, Clock::time_point end)
+		{
+			return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+		}
+
+		uint32_t lockKey(uint8_t sceneID, uint16_t objectID)
+		{
+			return (uint32_t(sceneID) << 16) | objectID;
+		}
+
+		void setLinger(zmq::socket_t& socket)
+		{
+			const int linger = 0;
+			socket.setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+		}
+	}
+
+	SyncRelay::SyncRelay(const RelayConfig& config) :
+		m_config(config),
+		m_clock(config.framerate),
+		m_context(1),
+		m_updateSocket(m_context, ZMQ_SUB),
+		m_broadcastSocket(m_context, ZMQ_PUB),
+		m_pingSocket(m_context, ZMQ_REP),
+		m_updateMonitor(m_context, ZMQ_PAIR),
+		m_broadcastMonitor(m_context, ZMQ_PAIR),
+		m_publishers(0),
+		m_subscribers(0),
+		m_publishFailures(0),
+		m_malformedMessages(0),
+		m_csv(nullptr)
+	{
+		setLinger(m_updateSocket);
+		setLinger(m_broadcastSocket);
+		setLinger(m_pingSocket);
+
+		m_updateSocket.setsockopt(ZMQ_SUBSCRIBE, "", 0);
+		m_updateSocket.bind(endpoint(m_config.bindAddress, m_config.updatePort));
+		m_broadcastSocket.bind(endpoint(m_config.bindAddress, m_config.broadcastPort));
+		m_pingSocket.bind(endpoint(m_config.bindAddress, m_config.pingPort));
+
+		// connected clients, publishers connect to the update socket, subscribers to the broadcast socket
+		zmq_socket_monitor(static_cast<void*>(m_updateSocket), "inproc://relay-update-monitor", ZMQ_EVENT_ACCEPTED | ZMQ_EVENT_DISCONNECTED);
+		zmq_socket_monitor(static_cast<void*>(m_broadcastSocket), "inproc://relay-broadcast-monitor", ZMQ_EVENT_ACCEPTED | ZMQ_EVENT_DISCONNECTED);
+		m_updateMonitor.connect("inproc://relay-update-monitor");
+		m_broadcastMonitor.connect("inproc://relay-broadcast-monitor");
+
+		if (!m_config.csvPath.empty())
+		{
+			m_csv = std::fopen(m_config.csvPath.c_str(), "w");
+			if (m_csv)
+				std::fprintf(m_csv, "seconds,client,messages,bytes,parameters,messagesPerSecond,kbPerSecond,lagAvgMs,lagMaxMs,relayP50Us,relayP99Us,relayMaxUs,locks,lockConflicts,pings,malformed\n");
+			else
+				std::fprintf(stderr, "[SyncRelay] Could not open %s: %s\n", m_config.csvPath.c_str(), std::strerror(errno));
+		}
+
+		if (!m_config.recordPath.empty() && !m_recorder.open(m_config.recordPath))
+			std::fprintf(stderr, "[SyncRelay] Could not create session log %s\n", m_config.recordPath.c_str());
+	}
+
+	SyncRelay::~SyncRelay()
+	{
+		if (m_csv)
+			std::fclose(m_csv);
+	}
+
+	void SyncRelay::run(const std::atomic<bool>& stop)
+	{
+		std::printf("[SyncRelay] updates on %d, broadcast on %d, ping on %d, server ID %d, %d fps, %d timesteps\n",
+			m_config.updatePort, m_config.broadcastPort, m_config.pingPort, m_config.serverID, m_clock.framerate(), m_clock.timesteps());
+
+		zmq::pollitem_t items[] = {
+			{ static_cast<void*>(m_updateSocket), 0, ZMQ_POLLIN, 0 },
+			{ static_cast<void*>(m_pingSocket), 0, ZMQ_POLLIN, 0 },
+			{ static_cast<void*>(m_updateMonitor), 0, ZMQ_POLLIN, 0 },
+			{ static_cast<void*>(m_broadcastMonitor), 0, ZMQ_POLLIN, 0 }
+		};
+
+		m_startTime = m_intervalStart = Clock::now();
+		Clock::time_point nextSync = m_startTime;
+		zmq::message_t message;
+
+		while (!stop)
+		{
+			Clock::time_point now = Clock::now();
+			const long timeout = long(m_clock.untilNextStep(now).count() / 1000) + 1;
+			try
+			{
+				zmq::poll(items, 4, timeout);
+			}
+			catch (const zmq::error_t& e)
+			{
+				if (e.num() == EINTR)
+					continue;
+				throw;
+			}
+
+			// drain the update socket first, it carries the load
+			if (items[0].revents & ZMQ_POLLIN)
+			{
+				while (m_updateSocket.recv(&message, ZMQ_DONTWAIT))
+					handleUpdate(message, Clock::now());
+			}
+			if (items[1].revents & ZMQ_POLLIN)
+				handlePing();
+			if (items[2].revents & ZMQ_POLLIN)
+				handleMonitor(m_updateMonitor, m_publishers);
+			if (items[3].revents & ZMQ_POLLIN)
+				handleMonitor(m_broadcastMonitor, m_subscribers);
+
+			now = Clock::now();
+			m_clock.update(now);
+			if (m_config.syncIntervalMs > 0 && now >= nextSync)
+			{
+				broadcastSync();
+				nextSync = now + std::chrono::milliseconds(m_config.syncIntervalMs);
+			}
+			if (m_config.reportIntervalMs > 0 && now - m_intervalStart >= std::chrono::milliseconds(m_config.reportIntervalMs))
+				report(now, false);
+		}
+
+		report(Clock::now(), true);
+	}
+
+	void SyncRelay::handleUpdate(zmq::message_t& message, Clock::time_point received)
+	{
+		const uint8_t* data = static_cast<const uint8_t*>(message.data());
+		const size_t size = message.size();
+
+		if (m_recorder.isOpen())
+			m_recorder.append(LogDirection::INBOUND, data, size);
+
+		Header header;
+		if (!decodeHeader(data, size, header))
+		{
+			m_malformedMessages++;
+			return;
+		}
+
+		ClientStats& stats = clientStats(header.clientID);
+		ClientCounters& counters = stats.interval;
+		counters.messages++;
+		counters.bytes += int64_t(size);
+		stats.addLag(m_clock.signedDelta(header.time));
+
+		switch (header.type)
+		{
+		case MessageType::PARAMETERUPDATE:
+		{
+			ParameterMessageReader reader(data, size);
+			ParameterRecord record;
+			while (reader.next(record))
+				counters.parameters++;
+			if (reader.failed())
+				counters.malformed++;
+			break;
+		}
+		case MessageType::LOCK:
+		{
+			LockMessage lock;
+			if (!decodeLock(data, size, lock))
+			{
+				counters.malformed++;
+				break;
+			}
+			const uint32_t key = lockKey(lock.sceneID, lock.objectID);
+			auto owner = m_lockOwners.find(key);
+			if (lock.locked)
+			{
+				counters.locks++;
+				if (owner != m_lockOwners.end() && owner->second != header.clientID)
+					counters.lockConflicts++;
+				m_lockOwners[key] = header.clientID;
+			}
+			else
+			{
+				counters.unlocks++;
+				if (owner != m_lockOwners.end() && owner->second == header.clientID)
+					m_lockOwners.erase(owner);
+			}
+			break;
+		}
+		case MessageType::SYNC:
+			counters.syncs++;
+			break;
+		case MessageType::RESENDUPDATE:
+			counters.resendRequests++;
+			break;
+		case MessageType::UNDOREDOADD:
+			counters.undoRedo++;
+			break;
+		case MessageType::RESETOBJECT:
+			counters.resets++;
+			break;
+		default:
+			break;
+		}
+
+		// the relay does not filter, clients skip their own messages by client ID
+		if (!m_broadcastSocket.send(message, ZMQ_DONTWAIT))
+			m_publishFailures++;
+		stats.intervalRelayMicros.add(microsBetween(received, Clock::now()));
+	}
+
+	void SyncRelay::handlePing()
+	{
+		zmq::message_t request;
+		if (!m_pingSocket.recv(&request, ZMQ_DONTWAIT))
+			return;
+
+		Header header;
+		if (decodeHeader(static_cast<const uint8_t*>(request.data()), request.size(), header))
+			clientStats(header.clientID).interval.pings++;
+		else
+			m_malformedMessages++;
+
+		// a REP socket has to answer every request, even a malformed one
+		uint8_t pong[CONTROL_MESSAGE_SIZE];
+		encodeControl(pong, sizeof(pong), m_config.serverID, m_clock.time(), MessageType::PING);
+		m_pingSocket.send(pong, sizeof(pong));
+	}
+
+	void SyncRelay::handleMonitor(zmq::socket_t& monitor, int& connections)
+	{
+		zmq::message_t eventMessage;
+		if (!monitor.recv(&eventMessage, ZMQ_DONTWAIT))
+			return;
+		uint16_t event = 0;
+		std::memcpy(&event, eventMessage.data(), sizeof(uint16_t));
+
+		// second frame holds the endpoint address
+		if (eventMessage.more())
+		{
+			zmq::message_t addressMessage;
+			monitor.recv(&addressMessage);
+		}
+
+		if (event == ZMQ_EVENT_ACCEPTED)
+			connections++;
+		else if (event == ZMQ_EVENT_DISCONNECTED && connections > 0)
+			connections--;
+	}
+
+	void SyncRelay::broadcastSync()
+	{
+		uint8_t sync[CONTROL_MESSAGE_SIZE];
+		encodeControl(sync, sizeof(sync), m_config.serverID, m_clock.time(), MessageType::SYNC);
+		if (m_broadcastSocket.send(sync, sizeof(sync), ZMQ_DONTWAIT) != sizeof(sync))
+			m_publishFailures++;
+	}
+
+	void SyncRelay::report(Clock::time_point now, bool final)
+	{
+		const double seconds = microsBetween(m_intervalStart, now) / 1e6;
+		const double uptime = microsBetween(m_startTime, now) / 1e6;
+		const double stepMillis = m_clock.stepMillis();
+
+		std::printf("[SyncRelay] %.1fs publishers %d subscribers %d locked %zu publish failures %lld malformed %lld time %d\n",
+			uptime, m_publishers, m_subscribers, m_lockOwners.size(), (long long)m_publishFailures, (long long)m_malformedMessages, m_clock.time());
+		if (!m_clients.empty())
+			std::printf("  client    msg/s     KB/s  param/s  lag avg/max ms   relay p50/p99/max us  locks  pings  bad\n");
+
+		ClientCounters all;
+		for (auto& entry : m_clients)
+		{
+			ClientStats& stats = entry.second;
+			const ClientCounters& c = stats.interval;
+			const double msgRate = seconds > 0 ? c.messages / seconds : 0;
+			const double kbRate = seconds > 0 ? c.bytes / 1024.0 / seconds : 0;
+			const double paramRate = seconds > 0 ? c.parameters / seconds : 0;
+			const double lagAvg = stats.lagCount ? stats.lagSumSteps * stepMillis / stats.lagCount : 0;
+			const double lagMax = stats.lagMaxSteps * stepMillis;
+			const LatencyHistogram& relay = stats.intervalRelayMicros;
+
+			std::printf("  %6d %8.1f %8.1f %8.1f %7.1f/%-7.1f %6lld/%lld/%lld %6lld %6lld %4lld\n",
+				entry.first, msgRate, kbRate, paramRate, lagAvg, lagMax,
+				(long long)relay.percentile(50), (long long)relay.percentile(99), (long long)relay.max(),
+				(long long)(c.locks + c.unlocks), (long long)c.pings, (long long)c.malformed);
+
+			if (m_csv)
+				std::fprintf(m_csv, "%.3f,%d,%lld,%lld,%lld,%.2f,%.2f,%.2f,%.2f,%lld,%lld,%lld,%lld,%lld,%lld,%lld\n",
+					uptime, entry.first, (long long)c.messages, (long long)c.bytes, (long long)c.parameters, msgRate, kbRate, lagAvg, lagMax,
+					(long long)relay.percentile(50), (long long)relay.percentile(99), (long long)relay.max(),
+					(long long)(c.locks + c.unlocks), (long long)c.lockConflicts, (long long)c.pings, (long long)c.malformed);
+
+			stats.closeInterval();
+		}
+		if (m_csv)
+			std::fflush(m_csv);
+
+		if (final)
+		{
+			std::printf("[SyncRelay] totals\n");
+			for (auto& entry : m_clients)
+			{
+				const ClientStats& stats = entry.second;
+				const ClientCounters& c = stats.total;
+				all.add(c);
+				std::printf("  client %d: %lld messages, %lld bytes, %lld parameters, %lld lock conflicts, %lld pings, %lld malformed, relay us mean %.1f p99 %lld\n",
+					entry.first, (long long)c.messages, (long long)c.bytes, (long long)c.parameters, (long long)c.lockConflicts,
+					(long long)c.pings, (long long)c.malformed, stats.relayMicros.mean(), (long long)stats.relayMicros.percentile(99));
+			}
+			std::printf("  all: %lld messages, %lld bytes relayed\n", (long long)all.messages, (long long)all.bytes);
+			if (m_recorder.isOpen())
+				std::printf("  session log: %llu messages, %zu bytes\n", (unsigned long long)m_recorder.recordCount(), m_recorder.size());
+		}
+		std::fflush(stdout);
+		m_intervalStart = now;
+	}
+}
+}
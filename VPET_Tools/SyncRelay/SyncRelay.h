@@ -0,0 +1,125 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef VPET_SYNCRELAY_SYNCRELAY_H
+#define VPET_SYNCRELAY_SYNCRELAY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include <zmq.hpp>
+
+#include "RelayStats.h"
+#include "SyncClock.h"
+#include "VPETSessionLog.h"
+
+namespace VPET
+{
+namespace Tools
+{
+	struct RelayConfig
+	{
+		std::string bindAddress = "*";
+		//! Clients publish their updates here (update sender socket)
+		int updatePort = 5557;
+		//! Clients subscribe here (update receiver socket)
+		int broadcastPort = 5556;
+		//! Ping request/reply
+		int pingPort = 5558;
+		uint8_t serverID = 255;
+		int framerate = 60;
+		//! SYNC broadcast period, 0 disables it
+		int syncIntervalMs = 1000;
+		int reportIntervalMs = 5000;
+		//! Optional per client CSV of every report interval
+		std::string csvPath;
+		//! Optional session log of all relayed messages
+		std::string recordPath;
+	};
+
+	//! Stand-in for the DataHub sync server: forwards every update received on the
+	//! update port to all subscribers, broadcasts its clock as SYNC messages and
+	//! answers pings. Collects per client throughput and latency figures.
+	class SyncRelay
+	{
+	public:
+		explicit SyncRelay(const RelayConfig& config);
+		~SyncRelay();
+
+		//! Serves until stop is set, prints the summary on return
+		void run(const std::atomic<bool>& stop);
+
+	private:
+		void handleUpdate(zmq::message_t& message, std::chrono::steady_clock::time_point received);
+		void handlePing();
+		void handleMonitor(zmq::socket_t& monitor, int& connections);
+		void broadcastSync();
+		void report(std::chrono::steady_clock::time_point now, bool final);
+
+		ClientStats& clientStats(uint8_t clientID) { return m_clients[clientID]; }
+
+		RelayConfig m_config;
+		SyncClock m_clock;
+
+		zmq::context_t m_context;
+		zmq::socket_t m_updateSocket;
+		zmq::socket_t m_broadcastSocket;
+		zmq::socket_t m_pingSocket;
+		zmq::socket_t m_updateMonitor;
+		zmq::socket_t m_broadcastMonitor;
+
+		int m_publishers;
+		int m_subscribers;
+
+		//! Current lock owner per scene and object ID
+		std::map<uint32_t, uint8_t> m_lockOwners;
+		std::map<uint8_t, ClientStats> m_clients;
+		int64_t m_publishFailures;
+		//! Messages too short for a header, no client can be assigned
+		int64_t m_malformedMessages;
+
+		std::chrono::steady_clock::time_point m_startTime;
+		std::chrono::steady_clock::time_point m_intervalStart;
+		std::FILE* m_csv;
+		VPET::Protocol::SessionLogWriter m_recorder;
+	};
+}
+}
+
+#endif // VPET_SYNCRELAY_SYNCRELAY_H
@@ -0,0 +1,135 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+//! Stand-in sync server for measuring the update path on Linux.
+//! Usage: VPETSyncRelay [options], see --help
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "SyncRelay.h"
+
+namespace
+{
+	std::atomic<bool> g_stop(false);
+
+	void onSignal(int)
+	{
+		g_stop = true;
+	}
+
+	void printUsage()
+	{
+		std::printf(
+			"VPETSyncRelay - relays VPET update messages between clients\n"
+			"  --bind <address>        interface to bind, default *\n"
+			"  --update-port <port>    port the clients publish to, default 5557\n"
+			"  --broadcast-port <port> port the clients subscribe to, default 5556\n"
+			"  --ping-port <port>      ping request port, default 5558\n"
+			"  --id <0-255>            client ID of the relay, default 255\n"
+			"  --framerate <fps>       clock rate, default 60\n"
+			"  --sync <ms>             SYNC broadcast period, 0 disables, default 1000\n"
+			"  --report <ms>           statistics period, default 5000\n"
+			"  --csv <file>            write every report interval as CSV\n"
+			"  --record <file>         record all relayed messages to a session log\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	VPET::Tools::RelayConfig config;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--help" || arg == "-h")
+		{
+			printUsage();
+			return 0;
+		}
+		if (i + 1 >= argc)
+		{
+			std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+			printUsage();
+			return 1;
+		}
+		const char* value = argv[++i];
+		if (arg == "--bind")
+			config.bindAddress = value;
+		else if (arg == "--update-port")
+			config.updatePort = std::atoi(value);
+		else if (arg == "--broadcast-port")
+			config.broadcastPort = std::atoi(value);
+		else if (arg == "--ping-port")
+			config.pingPort = std::atoi(value);
+		else if (arg == "--id")
+			config.serverID = uint8_t(std::atoi(value));
+		else if (arg == "--framerate")
+			config.framerate = std::atoi(value);
+		else if (arg == "--sync")
+			config.syncIntervalMs = std::atoi(value);
+		else if (arg == "--report")
+			config.reportIntervalMs = std::atoi(value);
+		else if (arg == "--csv")
+			config.csvPath = value;
+		else if (arg == "--record")
+			config.recordPath = value;
+		else
+		{
+			std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+			printUsage();
+			return 1;
+		}
+	}
+
+	std::signal(SIGINT, onSignal);
+	std::signal(SIGTERM, onSignal);
+
+	try
+	{
+		VPET::Tools::SyncRelay relay(config);
+		relay.run(g_stop);
+	}
+	catch (const zmq::error_t& e)
+	{
+		std::fprintf(stderr, "[SyncRelay] zeroMQ error: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef VPET_TOOLS_LATENCYHISTOGRAM_H
+#define VPET_TOOLS_LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <limits>
+
+namespace VPET
+{
+namespace Tools
+{
+	//! Fixed size histogram of microsecond latencies.
+	//! Values below 16us get their own bucket, above that every power of two
+	//! is split into 8 buckets, so percentiles are within 12.5% of the true value.
+	class LatencyHistogram
+	{
+	public:
+		static const int SUB_BUCKETS = 8;
+		static const int LINEAR_LIMIT = 16;
+		static const int BUCKET_COUNT = LINEAR_LIMIT + (63 - 4) * SUB_BUCKETS;
+
+		LatencyHistogram() { reset(); }
+
+		void reset()
+		{
+			for (int i = 0; i < BUCKET_COUNT; i++)
+				m_buckets[i] = 0;
+			m_count = 0;
+			m_sum = 0;
+			m_min = std::numeric_limits<int64_t>::max();
+			m_max = 0;
+		}
+
+		void add(int64_t micros)
+		{
+			if (micros < 0)
+				micros = 0;
+			m_buckets[bucketOf(micros)]++;
+			m_count++;
+			m_sum += micros;
+			if (micros < m_min)
+				m_min = micros;
+			if (micros > m_max)
+				m_max = micros;
+		}
+
+		void merge(const LatencyHistogram& other)
+		{
+			for (int i = 0; i < BUCKET_COUNT; i++)
+				m_buckets[i] += other.m_buckets[i];
+			m_count += other.m_count;
+			m_sum += other.m_sum;
+			if (other.m_min < m_min)
+				m_min = other.m_min;
+			if (other.m_max > m_max)
+				m_max = other.m_max;
+		}
+
+		int64_t count() const { return m_count; }
+		int64_t min() const { return m_count ? m_min : 0; }
+		int64_t max() const { return m_max; }
+		double mean() const { return m_count ? double(m_sum) / double(m_count) : 0.0; }
+
+		//! Upper bound of the bucket holding the given percentile (0..100)
+		int64_t percentile(double percent) const
+		{
+			if (m_count == 0)
+				return 0;
+			int64_t rank = int64_t(percent / 100.0 * double(m_count) + 0.5);
+			if (rank < 1)
+				rank = 1;
+			int64_t seen = 0;
+			for (int i = 0; i < BUCKET_COUNT; i++)
+			{
+				seen += m_buckets[i];
+				if (seen >= rank)
+				{
+					const int64_t bound = upperBoundOf(i);
+					return bound < m_max ? bound : m_max;
+				}
+			}
+			return m_max;
+		}
+
+	private:
+		static int bucketOf(int64_t micros)
+		{
+			if (micros < LINEAR_LIMIT)
+				return int(micros);
+			int octave = 63;
+			while (!(uint64_t(micros) >> octave))
+				octave--;
+			const int sub = int((uint64_t(micros) >> (octave - 3)) & (SUB_BUCKETS - 1));
+			return LINEAR_LIMIT + (octave - 4) * SUB_BUCKETS + sub;
+		}
+
+		static int64_t upperBoundOf(int bucket)
+		{
+			if (bucket < LINEAR_LIMIT)
+				return bucket;
+			const int octave = (bucket - LINEAR_LIMIT) / SUB_BUCKETS + 4;
+			const int sub = (bucket - LINEAR_LIMIT) % SUB_BUCKETS;
+			return ((int64_t(SUB_BUCKETS + sub + 1)) << (octave - 3)) - 1;
+		}
+
+		int64_t m_buckets[BUCKET_COUNT];
+		int64_t m_count;
+		int64_t m_sum;
+		int64_t m_min;
+		int64_t m_max;
+	};
+}
+}
+
+#endif // VPET_TOOLS_LATENCYHISTOGRAM_H
@@ -0,0 +1,118 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of VPET - Virtual Production Editing Tool
+http://vpet.research.animationsinstitut.de/
+http://github.com/FilmakademieRnd/VPET
+
+Copyright (c) 2023 Filmakademie Baden-Wuerttemberg, Animationsinstitut R&D Lab
+
+This project has been initiated in the scope of the EU funded project
+Dreamspace under grant agreement no 610005 in the years 2014, 2015 and 2016.
+http://dreamspaceproject.eu/
+Post Dreamspace the project has been further developed on behalf of the
+research and development activities of Animationsinstitut.
+
+The VPET components Scene Distribution and Synchronization Server are intended
+for research and development purposes only. Commercial use of any kind is not
+permitted.
+
+There is no support by Filmakademie. Since the Scene Distribution and
+Synchronization Server are available for free, Filmakademie shall only be
+liable for intent and gross negligence; warranty is limited to malice. Scene
+Distribution and Synchronization Server may under no circumstances be used for
+racist, sexual or any illegal purposes. In all non-commercial productions,
+scientific publications, prototypical non-commercial software tools, etc.
+using the Scene Distribution and/or Synchronization Server Filmakademie has
+to be named as follows: “VPET-Virtual Production Editing Tool by Filmakademie
+Baden-Württemberg, Animationsinstitut (http://research.animationsinstitut.de)“.
+
+In case a company or individual would like to use the Scene Distribution and/or
+Synchronization Server in a commercial surrounding or for commercial purposes,
+software based on these components or any part thereof, the company/individual
+will have to contact Filmakademie (research<at>filmakademie.de).
+-----------------------------------------------------------------------------
+*/
+
+#ifndef VPET_TOOLS_SYNCCLOCK_H
+#define VPET_TOOLS_SYNCCLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace VPET
+{
+namespace Tools
+{
+	//! The wrapping VPET time step counter, advanced at the client framerate.
+	//! Same timestep range as the clients: (128 / framerate) * framerate.
+	class SyncClock
+	{
+	public:
+		static const int TIMESTEPS_BASE = 128;
+
+		explicit SyncClock(int framerate = 60) :
+			m_framerate(framerate > 0 ? framerate : 60),
+			m_timesteps(uint8_t((TIMESTEPS_BASE / m_framerate) * m_framerate)),
+			m_time(0),
+			m_start(std::chrono::steady_clock::now()),
+			m_ticks(0)
+		{}
+
+		//! Advances by all steps elapsed since the last call, returns the number of steps
+		int update(std::chrono::steady_clock::time_point now)
+		{
+			const int64_t target = std::chrono::duration_cast<std::chrono::microseconds>(now - m_start).count() * m_framerate / 1000000;
+			int steps = 0;
+			while (m_ticks < target)
+			{
+				m_time = (m_time > (m_timesteps - 2) ? 0 : m_time + 1);
+				m_ticks++;
+				steps++;
+			}
+			return steps;
+		}
+
+		//! Time until the next step
+		std::chrono::microseconds untilNextStep(std::chrono::steady_clock::time_point now) const
+		{
+			const auto next = m_start + std::chrono::microseconds((m_ticks + 1) * 1000000 / m_framerate);
+			return next > now ? std::chrono::duration_cast<std::chrono::microseconds>(next - now) : std::chrono::microseconds(0);
+		}
+
+		void set(uint8_t time) { m_time = time % m_timesteps; }
+
+		uint8_t time() const { return m_time; }
+		uint8_t timesteps() const { return m_timesteps; }
+		int framerate() const { return m_framerate; }
+		double stepMillis() const { return 1000.0 / m_framerate; }
+
+		//! Steps from other to the current time, negative if other is ahead
+		int signedDelta(uint8_t other) const
+		{
+			int delta = (int(m_time) - int(other)) % m_timesteps;
+			if (delta < 0)
+				delta += m_timesteps;
+			if (delta > m_timesteps / 2)
+				delta -= m_timesteps;
+			return delta;
+		}
+
+		//! Unsigned wrapping distance, as used by the clients
+		static int delta(uint8_t a, uint8_t b, uint8_t timesteps)
+		{
+			const int forward = ((int(a) - int(b)) % timesteps + timesteps) % timesteps;
+			const int backward = ((int(b) - int(a)) % timesteps + timesteps) % timesteps;
+			return forward < backward ? forward : backward;
+		}
+
+	private:
+		int m_framerate;
+		uint8_t m_timesteps;
+		uint8_t m_time;
+		std::chrono::steady_clock::time_point m_start;
+		int64_t m_ticks;
+	};
+}
+}
+
+#endif // VPET_TOOLS_SYNCCLOCK_H